@@ -182,6 +182,10 @@ template < class T, class CompareT = CmpOrd<T> > struct CmpSTable : public Compa
 	 */
 	static inline long compare(const STable<T> &t1, const STable<T> &t2)
 	{
+		/* Tables sharing their data are equal. */
+		if ( t1.data == t2.data )
+			return 0;
+
 		long t1Length = t1.length();
 		long t2Length = t2.length();
 
@@ -0,0 +1,32 @@
+/*
+ * Times the initialization of a generated lexer class, then runs it over a
+ * small input to check that its tables were decoded correctly.
+ *
+ *   java Bench Plain
+ *   java Bench Packed
+ */
+
+import java.io.File;
+
+public class Bench
+{
+	public static void main( String args[] ) throws Exception
+	{
+		String name = args[0];
+		char data[] = ( "public static final int select_from = 10;\n" +
+				"/* alter table */ if ( x <= 3.25 ) return \"where\";\n" ).toCharArray();
+
+		long start = System.nanoTime();
+		Class<?> lexer = Class.forName( name );
+		long init = System.nanoTime() - start;
+
+		lexer.getMethod( "scan", char[].class ).invoke( null, (Object) data );
+
+		System.out.println( name + ": " + 
+				new File( name + ".class" ).length() + " bytes, " +
+				( init / 1000 ) + " us to initialize, " +
+				lexer.getDeclaredField( "keywords" ).getInt( null ) + " keywords, " +
+				lexer.getDeclaredField( "idents" ).getInt( null ) + " identifiers, " +
+				lexer.getDeclaredField( "numbers" ).getInt( null ) + " numbers" );
+	}
+}
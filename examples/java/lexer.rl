@@ -0,0 +1,85 @@
+/*
+ * A lexer with a large keyword set. It is generated twice, once with the
+ * usual array initializers and once with --packed-tables, to compare the
+ * class file size and the time taken to initialize the class.
+ */
+
+public class LEXER
+{
+	%%{
+		machine lexer;
+
+		keyword = (
+			'abstract' | 'assert' | 'boolean' | 'break' | 'byte' | 'case' | 'catch' |
+			'char' | 'class' | 'const' | 'continue' | 'default' | 'do' | 'double' |
+			'else' | 'enum' | 'extends' | 'final' | 'finally' | 'float' | 'for' |
+			'goto' | 'if' | 'implements' | 'import' | 'instanceof' | 'int' |
+			'interface' | 'long' | 'native' | 'new' | 'package' | 'private' |
+			'protected' | 'public' | 'return' | 'short' | 'static' | 'strictfp' |
+			'super' | 'switch' | 'synchronized' | 'this' | 'throw' | 'throws' |
+			'transient' | 'try' | 'void' | 'volatile' | 'while' | 'true' | 'false' |
+			'null' | 'add' | 'all' | 'alter' | 'analyze' | 'and' | 'as' | 'asc' |
+			'before' | 'between' | 'bigint' | 'binary' | 'blob' | 'both' | 'by' |
+			'call' | 'cascade' | 'change' | 'check' | 'collate' | 'column' |
+			'condition' | 'constraint' | 'convert' | 'create' | 'cross' |
+			'current_date' | 'current_time' | 'current_timestamp' | 'current_user' |
+			'cursor' | 'database' | 'databases' | 'day_hour' | 'day_microsecond' |
+			'day_minute' | 'day_second' | 'dec' | 'decimal' | 'declare' | 'delayed' |
+			'delete' | 'desc' | 'describe' | 'deterministic' | 'distinct' |
+			'distinctrow' | 'div' | 'drop' | 'dual' | 'each' | 'elseif' |
+			'enclosed' | 'escaped' | 'exists' | 'exit' | 'explain' | 'fetch' |
+			'float4' | 'float8' | 'force' | 'foreign' | 'from' | 'fulltext' |
+			'grant' | 'group' | 'having' | 'high_priority' | 'hour_microsecond' |
+			'hour_minute' | 'hour_second' | 'ignore' | 'in' | 'index' | 'infile' |
+			'inner' | 'inout' | 'insensitive' | 'insert' | 'int1' | 'int2' | 'int3' |
+			'int4' | 'int8' | 'integer' | 'interval' | 'into' | 'is' | 'iterate' |
+			'join' | 'key' | 'keys' | 'kill' | 'leading' | 'leave' | 'left' |
+			'like' | 'limit' | 'linear' | 'lines' | 'load' | 'localtime' |
+			'localtimestamp' | 'lock' | 'longblob' | 'longtext' | 'loop' |
+			'low_priority' | 'match' | 'mediumblob' | 'mediumint' | 'mediumtext' |
+			'middleint' | 'minute_microsecond' | 'minute_second' | 'mod' |
+			'modifies' | 'natural' | 'not' | 'no_write_to_binlog' | 'numeric' |
+			'on' | 'optimize' | 'option' | 'optionally' | 'or' | 'order' | 'out' |
+			'outer' | 'outfile' | 'precision' | 'primary' | 'procedure' | 'purge' |
+			'range' | 'read' | 'reads' | 'real' | 'references' | 'regexp' |
+			'release' | 'rename' | 'repeat' | 'replace' | 'require' | 'restrict' |
+			'revoke' | 'right' | 'rlike' | 'schema' | 'schemas' |
+			'second_microsecond' | 'select' | 'sensitive' | 'separator' | 'set' |
+			'show' | 'smallint' | 'spatial' | 'specific' | 'sql' | 'sqlexception' |
+			'sqlstate' | 'sqlwarning' | 'sql_big_result' | 'sql_calc_found_rows' |
+			'sql_small_result' | 'ssl' | 'starting' | 'straight_join' | 'table' |
+			'terminated' | 'then' | 'tinyblob' | 'tinyint' | 'tinytext' | 'to' |
+			'trailing' | 'trigger' | 'undo' | 'union' | 'unique' | 'unlock' |
+			'unsigned' | 'update' | 'usage' | 'use' | 'using' | 'utc_date' |
+			'utc_time' | 'utc_timestamp' | 'values' | 'varbinary' | 'varchar' |
+			'varcharacter' | 'varying' | 'when' | 'where' | 'with' | 'write' |
+			'xor' | 'year_month' | 'zerofill'
+		);
+
+		main := |*
+			keyword => { keywords += 1; };
+			[a-zA-Z_][a-zA-Z_0-9]* => { idents += 1; };
+			[0-9]+ ( '.' [0-9]+ )? => { numbers += 1; };
+			'"' ( [^"\\] | '\\' any )* '"';
+			'/*' any* :>> '*/';
+			'//' [^\n]* '\n';
+			[(){}\[\];,.=<>!~?:+\-*/&|^%];
+			space;
+		*|;
+
+		write data;
+	}%%
+
+	static int keywords, idents, numbers;
+
+	public static void scan( char data[] )
+	{
+		int cs, act, ts, te, p = 0, pe = data.length, eof = pe;
+
+		%% write init;
+		%% write exec;
+
+		if ( cs == lexer_error )
+			System.out.println( "LEXER: scan error" );
+	}
+}
@@ -0,0 +1,701 @@
+/*
+ *  Copyright 2026 agent <agent@local>
+ */
+
+/*  This file is part of Ragel.
+ *
+ *  Ragel is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Ragel is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Ragel; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ragel.h"
+#include "cdblob.h"
+#include "redfsm.h"
+#include "gendata.h"
+#include <fstream>
+#include <stdlib.h>
+
+using std::ofstream;
+using std::ios;
+using std::endl;
+
+/*
+ * Layout of a blob. A header of 32 bit words is followed by the sections.
+ * Each section starts on an eight byte boundary. Words and keys are little
+ * endian. The header gives the offset and length in bytes of every section.
+ */
+
+enum BlobHeader
+{
+	BlobMagic = 0,
+	BlobVersion,
+	BlobByteOrder,
+	BlobKeySize,
+	BlobKeySigned,
+	BlobLength,
+	BlobNumStates,
+	BlobStart,
+	BlobFirstFinal,
+	BlobError,
+	BlobNumActions,
+	BlobNumEntries,
+	BlobNumTrans,
+	BlobSections
+};
+
+enum BlobSection
+{
+	/* Names are written one after the other, each ended by a null. */
+	BlobActionNames = 0,
+	BlobEntryNames,
+	BlobEntryIds,
+
+	/* The tables of -T0, always with the index table. */
+	BlobActions,
+	BlobKeyOffsets,
+	BlobKeys,
+	BlobSingleLens,
+	BlobRangeLens,
+	BlobIndexOffsets,
+	BlobIndicies,
+	BlobTransTargs,
+	BlobTransActions,
+	BlobToStateActions,
+	BlobFromStateActions,
+	BlobEofActions,
+	BlobEofTrans,
+	BlobNumSections
+};
+
+#define BLOB_MAGIC 0x42544c52
+#define BLOB_BYTE_ORDER 0x01020304
+#define BLOB_HEADER_WORDS ( BlobSections + 2 * BlobNumSections )
+#define BLOB_ALIGN 8
+
+static string OFF( int section )
+{
+	return "h[" + itoa( BlobSections + 2 * section ) + "]";
+}
+
+static string LEN( int section )
+{
+	return "h[" + itoa( BlobSections + 2 * section + 1 ) + "]";
+}
+
+static string HW( int word )
+{
+	return "h[" + itoa( word ) + "]";
+}
+
+static void appendWord( string &blob, long word )
+{
+	unsigned long w = (unsigned long)word;
+	for ( int i = 0; i < 4; i++ )
+		blob += (char)( ( w >> ( 8 * i ) ) & 0xff );
+}
+
+static void appendKey( string &blob, Key key, int size )
+{
+	unsigned long long k = (unsigned long long)key.getLongLong();
+	for ( int i = 0; i < size; i++ )
+		blob += (char)( ( k >> ( 8 * i ) ) & 0xff );
+}
+
+static void appendName( string &blob, const char *name )
+{
+	blob += name;
+	blob += '\0';
+}
+
+void BlobCodeGen::checkAction( GenAction *action, GenInlineList *inlineList )
+{
+	for ( GenInlineList::Iter item = *inlineList; item.lte(); item++ ) {
+		switch ( item->type ) {
+		case GenInlineItem::Goto: case GenInlineItem::Call:
+		case GenInlineItem::Next: case GenInlineItem::Entry:
+			source_error( item->loc ) << "action " << action->nameOrLoc() <<
+					" refers to a state, which a table blob cannot rebind" << endl;
+			break;
+		case GenInlineItem::LmSwitch: case GenInlineItem::LmSetActId:
+		case GenInlineItem::LmSetTokEnd: case GenInlineItem::LmGetTokEnd:
+		case GenInlineItem::LmInitTokStart: case GenInlineItem::LmInitAct:
+		case GenInlineItem::LmSetTokStart:
+			source_error( item->loc ) << "scanners are not supported "
+					"in table blob mode" << endl;
+			break;
+		case GenInlineItem::Curs:
+			anyCurs = true;
+			break;
+		default:
+			break;
+		}
+
+		if ( item->children != 0 )
+			checkAction( action, item->children );
+	}
+}
+
+void BlobCodeGen::finishRagelDef()
+{
+	/* Actions are bound to the host by name when a blob is loaded, so the
+	 * code in them must not depend on the machine it was compiled with. */
+	anyCurs = false;
+	for ( GenActionList::Iter act = actionList; act.lte(); act++ ) {
+		if ( act->name == 0 ) {
+			source_error( act->loc ) << "actions must be named "
+					"in table blob mode" << endl;
+		}
+		checkAction( act, act->inlineList );
+	}
+
+	if ( condSpaceList.length() > 0 ) {
+		GenAction *cond = condSpaceList.head->condSet[0];
+		source_error( cond->loc ) << "conditions are not supported "
+				"in table blob mode" << endl;
+	}
+
+	FsmCodeGen::finishRagelDef();
+}
+
+void BlobCodeGen::writeBlob()
+{
+	int keySize = keyOps->alphType->size;
+	string sect[BlobNumSections];
+
+	for ( GenActionList::Iter act = actionList; act.lte(); act++ )
+		appendName( sect[BlobActionNames], act->name );
+
+	for ( EntryNameVect::Iter en = entryPointNames; en.lte(); en++ ) {
+		appendName( sect[BlobEntryNames], *en );
+		appendWord( sect[BlobEntryIds], entryPointIds[en.pos()] );
+	}
+
+	/* Same layout as ACTIONS_ARRAY. */
+	appendWord( sect[BlobActions], actionList.length() );
+	for ( RedActionVect::Iter head = redFsm->actionHeads; head.lte(); head++ ) {
+		for ( GenActionTable::Iter item = (*head)->key; item.lte(); item++ )
+			appendWord( sect[BlobActions], item->value->actionId );
+		appendWord( sect[BlobActions], actionList.length() );
+	}
+
+	long keyOffset = 0, indOffset = 0;
+	for ( RedStateList::Iter st = redFsm->stateList; st.lte(); st++ ) {
+		appendWord( sect[BlobKeyOffsets], keyOffset );
+		appendWord( sect[BlobSingleLens], st->outSingle.length() );
+		appendWord( sect[BlobRangeLens], st->outRange.length() );
+		appendWord( sect[BlobIndexOffsets], indOffset );
+
+		for ( RedTransList::Iter stel = st->outSingle; stel.lte(); stel++ ) {
+			appendKey( sect[BlobKeys], stel->lowKey, keySize );
+			appendWord( sect[BlobIndicies], stel->value->id );
+		}
+
+		for ( RedTransList::Iter rtel = st->outRange; rtel.lte(); rtel++ ) {
+			appendKey( sect[BlobKeys], rtel->lowKey, keySize );
+			appendKey( sect[BlobKeys], rtel->highKey, keySize );
+			appendWord( sect[BlobIndicies], rtel->value->id );
+		}
+
+		if ( st->defTrans != 0 )
+			appendWord( sect[BlobIndicies], st->defTrans->id );
+
+		keyOffset += st->outSingle.length() + st->outRange.length()*2;
+		indOffset += st->outSingle.length() + st->outRange.length() +
+				( st->defTrans != 0 ? 1 : 0 );
+
+		appendWord( sect[BlobToStateActions], st->toStateAction != 0 ?
+				st->toStateAction->location+1 : 0 );
+		appendWord( sect[BlobFromStateActions], st->fromStateAction != 0 ?
+				st->fromStateAction->location+1 : 0 );
+		appendWord( sect[BlobEofActions], st->eofAction != 0 ?
+				st->eofAction->location+1 : 0 );
+
+		/* With the index table a transition's position is its id. */
+		appendWord( sect[BlobEofTrans], st->eofTrans != 0 ?
+				st->eofTrans->id+1 : 0 );
+	}
+
+	/* Transitions are written ordered by their id. */
+	RedTransAp **transPtrs = new RedTransAp*[redFsm->transSet.length()];
+	for ( TransApSet::Iter trans = redFsm->transSet; trans.lte(); trans++ )
+		transPtrs[trans->id] = trans;
+
+	for ( int t = 0; t < redFsm->transSet.length(); t++ ) {
+		RedTransAp *trans = transPtrs[t];
+		appendWord( sect[BlobTransTargs], trans->targ->id );
+		appendWord( sect[BlobTransActions], trans->action != 0 ?
+				trans->action->location+1 : 0 );
+	}
+	delete[] transPtrs;
+
+	/* Place the sections. */
+	long offsets[BlobNumSections];
+	long length = BLOB_HEADER_WORDS * 4;
+	for ( int s = 0; s < BlobNumSections; s++ ) {
+		length = ( length + BLOB_ALIGN - 1 ) / BLOB_ALIGN * BLOB_ALIGN;
+		offsets[s] = length;
+		length += sect[s].length();
+	}
+
+	string blob;
+	appendWord( blob, BLOB_MAGIC );
+	appendWord( blob, BLOB_VERSION );
+	appendWord( blob, BLOB_BYTE_ORDER );
+	appendWord( blob, keySize );
+	appendWord( blob, keyOps->isSigned ? 1 : 0 );
+	appendWord( blob, length );
+	appendWord( blob, redFsm->stateList.length() );
+	appendWord( blob, redFsm->startState != 0 ? redFsm->startState->id : -1 );
+	appendWord( blob, redFsm->firstFinState != 0 ?
+			redFsm->firstFinState->id : redFsm->nextStateId );
+	appendWord( blob, redFsm->errState != 0 ? redFsm->errState->id : -1 );
+	appendWord( blob, actionList.length() );
+	appendWord( blob, entryPointNames.length() );
+	appendWord( blob, redFsm->transSet.length() );
+	for ( int s = 0; s < BlobNumSections; s++ ) {
+		appendWord( blob, offsets[s] );
+		appendWord( blob, sect[s].length() );
+	}
+
+	for ( int s = 0; s < BlobNumSections; s++ ) {
+		blob.append( offsets[s] - blob.length(), '\0' );
+		blob += sect[s];
+	}
+
+	/* Written next to the input, named after the machine. */
+	string suffix = string("_") + fsmName + ".rlb";
+	const char *fn = fileNameFromStem( sourceFileName, suffix.c_str() );
+	ofstream blobFile( fn, ios::out|ios::trunc|ios::binary );
+	if ( !blobFile.is_open() ) {
+		error() << "error opening " << fn << " for writing" << endl;
+		exitCompile(1);
+	}
+	blobFile.write( blob.data(), blob.length() );
+	blobFile.close();
+}
+
+void BlobCodeGen::LOADER()
+{
+	int numActions = actionList.length();
+	int numEntries = entryPointNames.length();
+	string state = HW(BlobNumStates);
+	string trans = HW(BlobNumTrans);
+
+	out <<
+		"/* Points the tables at a blob written by ragel --table-blob and binds\n"
+		" * its actions and entry points to the ones here by name. The blob must\n"
+		" * stay in place while the machine is used. Returns zero on success. On\n"
+		" * failure returns -1 and keeps the tables that were loaded before. */\n"
+		"static int " << LOAD_BLOB() << "( const void *blob, unsigned long len )\n"
+		"{\n"
+		"	const unsigned int *h = (const unsigned int*) blob;\n"
+		"	const char *b = (const char*) blob;\n"
+		"	const char *name, *end;\n"
+		"	const int *items;\n"
+		"	const unsigned int *ko, *sl, *rl, *io, *w;\n"
+		"	unsigned int numKeys, numInds, numActs;\n"
+		"	int bind[" << numActions + 1 << "];\n";
+
+	if ( numEntries > 0 )
+		out << "	int entry[" << numEntries << "];\n";
+
+	out <<
+		"	unsigned int s, i, j;\n"
+		"\n"
+		"	if ( sizeof(int) != 4 || len < " << BLOB_HEADER_WORDS * 4 << " )\n"
+		"		return -1;\n"
+		"	if ( " << HW(BlobMagic) << " != 0x" << std::hex << BLOB_MAGIC << "u || " <<
+				HW(BlobVersion) << " != " << std::dec << BLOB_VERSION << " || " <<
+				HW(BlobByteOrder) << " != 0x" << std::hex << BLOB_BYTE_ORDER <<
+				std::dec << "u )\n"
+		"		return -1;\n"
+		"	if ( " << HW(BlobKeySize) << " != sizeof(" << ALPH_TYPE() << ") || " <<
+				HW(BlobKeySigned) << " != " << ( keyOps->isSigned ? 1 : 0 ) << " || " <<
+				HW(BlobLength) << " > len )\n"
+		"		return -1;\n"
+		"\n"
+		"	/* Sections are aligned and inside the blob. */\n"
+		"	for ( s = " << BlobSections << "; s < " << BLOB_HEADER_WORDS << "; s += 2 ) {\n"
+		"		if ( h[s] % " << BLOB_ALIGN << " != 0 || h[s] > " << HW(BlobLength) <<
+				" || h[s+1] > " << HW(BlobLength) << " - h[s] )\n"
+		"			return -1;\n"
+		"	}\n"
+		"\n"
+		"	/* Tables indexed by state have an item for every state. */\n"
+		"	if ( " << state << " > " << HW(BlobLength) << " / 4 || " <<
+				HW(BlobNumEntries) << " > " << HW(BlobLength) << " / 4 || " <<
+				trans << " > " << HW(BlobLength) << " / 4 )\n"
+		"		return -1;\n";
+
+	int stateSections[] = { BlobKeyOffsets, BlobSingleLens, BlobRangeLens,
+			BlobIndexOffsets, BlobToStateActions, BlobFromStateActions,
+			BlobEofActions, BlobEofTrans };
+	int numStateSections = sizeof(stateSections) / sizeof(int);
+	for ( int s = 0; s < numStateSections; s++ ) {
+		out << ( s == 0 ? "	if ( " : " ||\n			" ) <<
+				LEN(stateSections[s]) << " != " << state << " * 4";
+	}
+	out << " )\n"
+		"		return -1;\n"
+		"	if ( ( " << HW(BlobStart) << " >= " << state << " && " <<
+				HW(BlobStart) << " != 0xffffffffu ) ||\n"
+		"			" << HW(BlobFirstFinal) << " > " << state << " ||\n"
+		"			( " << HW(BlobError) << " >= " << state << " && " <<
+				HW(BlobError) << " != 0xffffffffu ) )\n"
+		"		return -1;\n"
+		"\n"
+		"	/* The keys and indicies of every state are inside their sections.\n"
+		"	 * Every state has a default transition after its ranges. */\n"
+		"	numKeys = " << LEN(BlobKeys) << " / sizeof(" << ALPH_TYPE() << ");\n"
+		"	numInds = " << LEN(BlobIndicies) << " / 4;\n"
+		"	ko = (const unsigned int*) (b + " << OFF(BlobKeyOffsets) << ");\n"
+		"	sl = (const unsigned int*) (b + " << OFF(BlobSingleLens) << ");\n"
+		"	rl = (const unsigned int*) (b + " << OFF(BlobRangeLens) << ");\n"
+		"	io = (const unsigned int*) (b + " << OFF(BlobIndexOffsets) << ");\n"
+		"	for ( s = 0; s < " << state << "; s++ ) {\n"
+		"		if ( ko[s] > numKeys || sl[s] > numKeys - ko[s] ||\n"
+		"				rl[s] > ( numKeys - ko[s] - sl[s] ) / 2 )\n"
+		"			return -1;\n"
+		"		if ( io[s] >= numInds || sl[s] + rl[s] >= numInds - io[s] )\n"
+		"			return -1;\n"
+		"	}\n"
+		"\n"
+		"	/* Indicies name transitions and transitions name states. */\n"
+		"	if ( " << LEN(BlobTransTargs) << " != " << trans << " * 4 || " <<
+				LEN(BlobTransActions) << " != " << trans << " * 4 )\n"
+		"		return -1;\n"
+		"	w = (const unsigned int*) (b + " << OFF(BlobIndicies) << ");\n"
+		"	for ( i = 0; i < numInds; i++ ) {\n"
+		"		if ( w[i] >= " << trans << " )\n"
+		"			return -1;\n"
+		"	}\n"
+		"	w = (const unsigned int*) (b + " << OFF(BlobTransTargs) << ");\n"
+		"	for ( i = 0; i < " << trans << "; i++ ) {\n"
+		"		if ( w[i] >= " << state << " )\n"
+		"			return -1;\n"
+		"	}\n"
+		"	w = (const unsigned int*) (b + " << OFF(BlobEofTrans) << ");\n"
+		"	for ( s = 0; s < " << state << "; s++ ) {\n"
+		"		if ( w[s] > " << trans << " )\n"
+		"			return -1;\n"
+		"	}\n"
+		"\n"
+		"	/* Bind the actions of the blob by name. */\n"
+		"	name = b + " << OFF(BlobActionNames) << ";\n"
+		"	end = name + " << LEN(BlobActionNames) << ";\n"
+		"	if ( " << HW(BlobNumActions) << " > " << numActions << " || ( " <<
+				HW(BlobNumActions) << " > 0 && ( " << LEN(BlobActionNames) <<
+				" == 0 || end[-1] != 0 ) ) )\n"
+		"		return -1;\n";
+
+	if ( numActions > 0 ) {
+		out <<
+			"	for ( i = 0; i < " << HW(BlobNumActions) << "; i++ ) {\n"
+			"		if ( name >= end )\n"
+			"			return -1;\n"
+			"		for ( j = 0; j < " << numActions << "; j++ ) {\n"
+			"			if ( strcmp( name, " << AN() << "[j] ) == 0 )\n"
+			"				break;\n"
+			"		}\n"
+			"		if ( j == " << numActions << " )\n"
+			"			return -1;\n"
+			"		bind[i] = j;\n"
+			"		name += strlen( name ) + 1;\n"
+			"	}\n";
+	}
+
+	out <<
+		"	bind[" << HW(BlobNumActions) << "] = " << ACTS_END() << ";\n"
+		"\n"
+		"	/* Every item in the action lists must be bound. */\n"
+		"	items = (const int*) (b + " << OFF(BlobActions) << ");\n"
+		"	for ( i = 0; i < " << LEN(BlobActions) << " / 4; i++ ) {\n"
+		"		if ( (unsigned int) items[i] > " << HW(BlobNumActions) << " )\n"
+		"			return -1;\n"
+		"	}\n"
+		"\n"
+		"	/* The last item ends a list, so a list found from any offset inside\n"
+		"	 * the section is ended. */\n"
+		"	numActs = " << LEN(BlobActions) << " / 4;\n"
+		"	if ( numActs == 0 || (unsigned int) items[numActs-1] != " <<
+				HW(BlobNumActions) << " )\n"
+		"		return -1;\n"
+		"	w = (const unsigned int*) (b + " << OFF(BlobTransActions) << ");\n"
+		"	for ( i = 0; i < " << trans << "; i++ ) {\n"
+		"		if ( w[i] >= numActs )\n"
+		"			return -1;\n"
+		"	}\n"
+		"	for ( s = 0; s < " << state << "; s++ ) {\n"
+		"		if ( ((const unsigned int*) (b + " << OFF(BlobToStateActions) <<
+				"))[s] >= numActs ||\n"
+		"				((const unsigned int*) (b + " << OFF(BlobFromStateActions) <<
+				"))[s] >= numActs ||\n"
+		"				((const unsigned int*) (b + " << OFF(BlobEofActions) <<
+				"))[s] >= numActs )\n"
+		"			return -1;\n"
+		"	}\n";
+
+	if ( numEntries > 0 ) {
+		out <<
+			"\n"
+			"	/* Find the entry points used here in the blob. */\n"
+			"	end = b + " << OFF(BlobEntryNames) << " + " << LEN(BlobEntryNames) << ";\n"
+			"	if ( " << LEN(BlobEntryIds) << " != " << HW(BlobNumEntries) <<
+					" * 4 || " << LEN(BlobEntryNames) << " == 0 || end[-1] != 0 )\n"
+			"		return -1;\n"
+			"	items = (const int*) (b + " << OFF(BlobEntryIds) << ");\n"
+			"	for ( j = 0; j < " << numEntries << "; j++ ) {\n"
+			"		name = b + " << OFF(BlobEntryNames) << ";\n"
+			"		for ( i = 0; i < " << HW(BlobNumEntries) << " && name < end; i++ ) {\n"
+			"			if ( strcmp( name, " << EN() << "[j] ) == 0 )\n"
+			"				break;\n"
+			"			name += strlen( name ) + 1;\n"
+			"		}\n"
+			"		if ( i == " << HW(BlobNumEntries) << " || name >= end || "
+					"(unsigned int) items[i] >= " << state << " )\n"
+			"			return -1;\n"
+			"		entry[j] = items[i];\n"
+			"	}\n";
+	}
+
+	out <<
+		"\n"
+		"	" << A() << " = (const int*) (b + " << OFF(BlobActions) << ");\n"
+		"	" << KO() << " = (const int*) (b + " << OFF(BlobKeyOffsets) << ");\n"
+		"	" << K() << " = (const " << ALPH_TYPE() << "*) (b + " << OFF(BlobKeys) << ");\n"
+		"	" << SL() << " = (const int*) (b + " << OFF(BlobSingleLens) << ");\n"
+		"	" << RL() << " = (const int*) (b + " << OFF(BlobRangeLens) << ");\n"
+		"	" << IO() << " = (const int*) (b + " << OFF(BlobIndexOffsets) << ");\n"
+		"	" << I() << " = (const int*) (b + " << OFF(BlobIndicies) << ");\n"
+		"	" << TT() << " = (const int*) (b + " << OFF(BlobTransTargs) << ");\n"
+		"	" << TA() << " = (const int*) (b + " << OFF(BlobTransActions) << ");\n"
+		"	" << TSA() << " = (const int*) (b + " << OFF(BlobToStateActions) << ");\n"
+		"	" << FSA() << " = (const int*) (b + " << OFF(BlobFromStateActions) << ");\n"
+		"	" << EA() << " = (const int*) (b + " << OFF(BlobEofActions) << ");\n"
+		"	" << ET() << " = (const int*) (b + " << OFF(BlobEofTrans) << ");\n"
+		"\n"
+		"	" << START() << " = (int) " << HW(BlobStart) << ";\n"
+		"	" << FIRST_FINAL() << " = (int) " << HW(BlobFirstFinal) << ";\n"
+		"	" << ERROR() << " = (int) " << HW(BlobError) << ";\n"
+		"	for ( i = 0; i <= " << HW(BlobNumActions) << "; i++ )\n"
+		"		" << AB() << "[i] = bind[i];\n";
+
+	if ( numEntries > 0 ) {
+		out <<
+			"	for ( j = 0; j < " << numEntries << "; j++ )\n"
+			"		*" << EV() << "[j] = entry[j];\n";
+	}
+
+	out <<
+		"	return 0;\n"
+		"}\n"
+		"\n";
+}
+
+void BlobCodeGen::writeData()
+{
+	writeBlob();
+
+	if ( actionList.length() > 0 ) {
+		out << "static const char *const " << AN() << "[] = {\n";
+		for ( GenActionList::Iter act = actionList; act.lte(); act++ ) {
+			out << "\t\"" << act->name << "\"" << ( act.last() ? "\n" : ",\n" );
+		}
+		out << "};\n\n";
+	}
+
+	if ( entryPointNames.length() > 0 ) {
+		out << "static const char *const " << EN() << "[] = {\n";
+		for ( EntryNameVect::Iter en = entryPointNames; en.lte(); en++ )
+			out << "\t\"" << *en << "\"" << ( en.last() ? "\n" : ",\n" );
+		out << "};\n\n";
+	}
+
+	/* The tables live in the blob. */
+	out <<
+		"static const int *" << A() << ";\n"
+		"static const int *" << KO() << ";\n"
+		"static const " << ALPH_TYPE() << " *" << K() << ";\n"
+		"static const int *" << SL() << ";\n"
+		"static const int *" << RL() << ";\n"
+		"static const int *" << IO() << ";\n"
+		"static const int *" << I() << ";\n"
+		"static const int *" << TT() << ";\n"
+		"static const int *" << TA() << ";\n"
+		"static const int *" << TSA() << ";\n"
+		"static const int *" << FSA() << ";\n"
+		"static const int *" << EA() << ";\n"
+		"static const int *" << ET() << ";\n"
+		"\n"
+		"/* Maps the action ids of the blob to the ones here. */\n"
+		"static int " << AB() << "[" << actionList.length() + 1 << "];\n"
+		"\n"
+		"static int " << START() << ";\n"
+		"static int " << FIRST_FINAL() << ";\n"
+		"static int " << ERROR() << ";\n"
+		"\n";
+
+	if ( entryPointNames.length() > 0 ) {
+		for ( EntryNameVect::Iter en = entryPointNames; en.lte(); en++ )
+			out << "static int " << DATA_PREFIX() << "en_" << *en << ";\n";
+		out << "\n";
+
+		out << "static int *const " << EV() << "[] = {\n";
+		for ( EntryNameVect::Iter en = entryPointNames; en.lte(); en++ ) {
+			out << "\t&" << DATA_PREFIX() << "en_" << *en <<
+					( en.last() ? "\n" : ",\n" );
+		}
+		out << "};\n\n";
+	}
+
+	LOADER();
+}
+
+/* Every action goes in every switch. A new blob may use an action where the
+ * one compiled with the host did not. */
+std::ostream &BlobCodeGen::BLOB_ACTION_SWITCH( bool inFinish )
+{
+	for ( GenActionList::Iter act = actionList; act.lte(); act++ ) {
+		out << "\tcase " << act->actionId << ":\n";
+		ACTION( out, act, 0, inFinish, false );
+		out << "\tbreak;\n";
+	}
+
+	genLineDirective( out );
+	return out;
+}
+
+void BlobCodeGen::writeExec()
+{
+	testEofUsed = false;
+	outLabelUsed = true;
+
+	out <<
+		"	{\n"
+		"	int _klen";
+
+	if ( anyCurs )
+		out << ", _ps";
+
+	out <<
+		";\n"
+		"	" << UINT() << " _trans;\n"
+		"	const int *_acts;\n"
+		"	const " << ALPH_TYPE() << " *_keys;\n"
+		"\n";
+
+	if ( !noEnd ) {
+		testEofUsed = true;
+		out <<
+			"	if ( " << P() << " == " << PE() << " )\n"
+			"		goto _test_eof;\n";
+	}
+
+	out <<
+		"	if ( " << vCS() << " == " << ERROR() << " )\n"
+		"		goto _out;\n"
+		"_resume:\n"
+		"	_acts = " << A() << " + " << FSA() << "[" << vCS() << "];\n"
+		"	while ( " << AB() << "[*_acts] != " << ACTS_END() << " ) {\n"
+		"		switch ( " << AB() << "[*_acts++] ) {\n";
+		BLOB_ACTION_SWITCH( false );
+		SWITCH_DEFAULT() <<
+		"		}\n"
+		"	}\n"
+		"\n";
+
+	LOCATE_TRANS();
+
+	out <<
+		"_match:\n"
+		"	_trans = " << I() << "[_trans];\n"
+		"_eof_trans:\n";
+
+	if ( anyCurs )
+		out << "	_ps = " << vCS() << ";\n";
+
+	out <<
+		"	" << vCS() << " = " << TT() << "[_trans];\n"
+		"\n"
+		"	if ( " << TA() << "[_trans] == 0 )\n"
+		"		goto _again;\n"
+		"\n"
+		"	_acts = " << A() << " + " << TA() << "[_trans];\n"
+		"	while ( " << AB() << "[*_acts] != " << ACTS_END() << " ) {\n"
+		"		switch ( " << AB() << "[*_acts++] ) {\n";
+		BLOB_ACTION_SWITCH( false );
+		SWITCH_DEFAULT() <<
+		"		}\n"
+		"	}\n"
+		"\n"
+		"_again:\n"
+		"	_acts = " << A() << " + " << TSA() << "[" << vCS() << "];\n"
+		"	while ( " << AB() << "[*_acts] != " << ACTS_END() << " ) {\n"
+		"		switch ( " << AB() << "[*_acts++] ) {\n";
+		BLOB_ACTION_SWITCH( false );
+		SWITCH_DEFAULT() <<
+		"		}\n"
+		"	}\n"
+		"\n"
+		"	if ( " << vCS() << " == " << ERROR() << " )\n"
+		"		goto _out;\n";
+
+	if ( !noEnd ) {
+		out <<
+			"	if ( ++" << P() << " != " << PE() << " )\n"
+			"		goto _resume;\n";
+	}
+	else {
+		out <<
+			"	" << P() << " += 1;\n"
+			"	goto _resume;\n";
+	}
+
+	if ( testEofUsed )
+		out << "	_test_eof: {}\n";
+
+	out <<
+		"	if ( " << P() << " == " << vEOF() << " ) {\n"
+		"	if ( " << ET() << "[" << vCS() << "] > 0 ) {\n"
+		"		_trans = " << ET() << "[" << vCS() << "] - 1;\n"
+		"		goto _eof_trans;\n"
+		"	}\n"
+		"	_acts = " << A() << " + " << EA() << "[" << vCS() << "];\n"
+		"	while ( " << AB() << "[*_acts] != " << ACTS_END() << " ) {\n"
+		"		switch ( " << AB() << "[*_acts++] ) {\n";
+		BLOB_ACTION_SWITCH( true );
+		SWITCH_DEFAULT() <<
+		"		}\n"
+		"	}\n"
+		"	}\n"
+		"\n"
+		"	_out: {}\n"
+		"	}\n";
+}
+
+/* State ids come from the blob. */
+void BlobCodeGen::writeStart()
+{
+	out << START();
+}
+
+void BlobCodeGen::writeFirstFinal()
+{
+	out << FIRST_FINAL();
+}
+
+void BlobCodeGen::writeError()
+{
+	out << ERROR();
+}
@@ -0,0 +1,86 @@
+/*
+ *  Copyright 2026 agent <agent@local>
+ */
+
+/*  This file is part of Ragel.
+ *
+ *  Ragel is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Ragel is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Ragel; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _CDBLOB_H
+#define _CDBLOB_H
+
+#include <iostream>
+#include "cdtable.h"
+
+/* Forwards. */
+struct CodeGenData;
+
+/* Version of the table blob layout. Bump when the header or the sections
+ * change. */
+#define BLOB_VERSION 1
+
+/*
+ * BlobCodeGen
+ *
+ * Writes the tables of a machine to a binary blob instead of the generated
+ * source. The source gets a loader that points the tables into a blob and an
+ * executor that works for any machine whose actions and entry points are
+ * found by name in the host. Rules can then be changed by replacing the blob.
+ */
+class BlobCodeGen : public TabCodeGen
+{
+public:
+	BlobCodeGen( const CodeGenArgs &args ) :
+		FsmCodeGen(args), TabCodeGen(args) {}
+	virtual ~BlobCodeGen() { }
+
+	virtual void finishRagelDef();
+	virtual void writeData();
+	virtual void writeExec();
+	virtual void writeStart();
+	virtual void writeFirstFinal();
+	virtual void writeError();
+
+	/* The blob always holds the index table. */
+	virtual void calcIndexSize() { useIndicies = true; }
+
+protected:
+	string AN() { return "_" + DATA_PREFIX() + "action_names"; }
+	string AB() { return "_" + DATA_PREFIX() + "action_bind"; }
+	string EN() { return "_" + DATA_PREFIX() + "entry_names"; }
+	string EV() { return "_" + DATA_PREFIX() + "entry_vars"; }
+	string LOAD_BLOB() { return DATA_PREFIX() + "load_blob"; }
+
+	void checkAction( GenAction *action, GenInlineList *inlineList );
+	void writeBlob();
+	void LOADER();
+	std::ostream &BLOB_ACTION_SWITCH( bool inFinish );
+
+	/* Some host action references the current state. */
+	bool anyCurs;
+};
+
+/*
+ * CBlobCodeGen
+ */
+struct CBlobCodeGen
+	: public BlobCodeGen, public CCodeGen
+{
+	CBlobCodeGen( const CodeGenArgs &args ) :
+		FsmCodeGen(args), BlobCodeGen(args), CCodeGen(args) {}
+};
+
+#endif
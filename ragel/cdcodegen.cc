@@ -25,9 +25,12 @@
 #include "ragel.h"
 #include "redfsm.h"
 #include "gendata.h"
+#include "inputdata.h"
 #include <sstream>
+#include <fstream>
 #include <string>
 #include <assert.h>
+#include <stdio.h>
 
 
 using std::ostream;
@@ -123,29 +126,37 @@ string FsmCodeGen::START_STATE_ID()
 /* Write out the array of actions. */
 std::ostream &FsmCodeGen::ACTIONS_ARRAY()
 {
-	out << "\t0, ";
+	/* Offset zero stands for no actions, so it holds an empty list. */
+	out << "\t" << ACTS_END() << ", ";
 	int totalActions = 1;
-	for ( GenActionTableMap::Iter act = redFsm->actionMap; act.lte(); act++ ) {
-		/* Write out the length, which will never be the last character. */
-		out << act->key.length() << ", ";
-		/* Put in a line break every 8 */
-		if ( totalActions++ % 8 == 7 )
-			out << "\n\t";
-
-		for ( GenActionTable::Iter item = act->key; item.lte(); item++ ) {
-			out << item->value->actionId;
-			if ( ! (act.last() && item.last()) )
-				out << ", ";
+	for ( RedActionVect::Iter head = redFsm->actionHeads; head.lte(); head++ ) {
+		for ( GenActionTable::Iter item = (*head)->key; item.lte(); item++ ) {
+			out << item->value->actionId << ", ";
 
 			/* Put in a line break every 8 */
 			if ( totalActions++ % 8 == 7 )
 				out << "\n\t";
 		}
+
+		/* Terminate the list. Tables that are a tail of it point inside. */
+		out << ACTS_END();
+		if ( !head.last() )
+			out << ", ";
+
+		/* Put in a line break every 8 */
+		if ( totalActions++ % 8 == 7 )
+			out << "\n\t";
 	}
 	out << "\n";
 	return out;
 }
 
+/* Marks the end of a list in the action array. No action has this id. */
+string FsmCodeGen::ACTS_END()
+{
+	return itoa( actionList.length() );
+}
+
 
 string FsmCodeGen::ACCESS()
 {
@@ -195,6 +206,19 @@ string FsmCodeGen::vEOF()
 	return ret.str();
 }
 
+string FsmCodeGen::DATA()
+{
+	ostringstream ret;
+	if ( dataExpr == 0 )
+		ret << "data";
+	else {
+		ret << "(";
+		INLINE_LIST( ret, dataExpr, 0, false, false );
+		ret << ")";
+	}
+	return ret.str();
+}
+
 string FsmCodeGen::vCS()
 {
 	ostringstream ret;
@@ -274,6 +298,19 @@ string FsmCodeGen::TOKEND()
 	return ret.str();
 }
 
+string FsmCodeGen::REP_COUNTERS()
+{
+	ostringstream ret;
+	if ( countersExpr == 0 )
+		ret << ACCESS() + "counters";
+	else {
+		ret << "(";
+		INLINE_LIST( ret, countersExpr, 0, false, false );
+		ret << ")";
+	}
+	return ret.str();
+}
+
 string FsmCodeGen::GET_WIDE_KEY()
 {
 	if ( redFsm->anyConditions() ) 
@@ -529,6 +566,15 @@ void FsmCodeGen::INLINE_LIST( ostream &ret, GenInlineList *inlineList,
 		case GenInlineItem::Break:
 			BREAK( ret, targState, csForced );
 			break;
+		case GenInlineItem::RepInit:
+			ret << REP_COUNTERS() << "[" << item->counterId << "] = 1;";
+			break;
+		case GenInlineItem::RepIncr:
+			ret << REP_COUNTERS() << "[" << item->counterId << "] += 1;";
+			break;
+		case GenInlineItem::RepTest:
+			ret << REP_COUNTERS() << "[" << item->counterId << "] < " << item->bound;
+			break;
 		}
 	}
 }
@@ -653,6 +699,11 @@ void FsmCodeGen::STATE_IDS()
 	if ( !noError )
 		STATIC_VAR( "int", ERROR() ) << " = " << ERROR_STATE() << ";\n";
 
+	if ( numRepCounters > 0 ) {
+		STATIC_VAR( "int", DATA_PREFIX() + "num_counters" ) << 
+				" = " << numRepCounters << ";\n";
+	}
+
 	out << "\n";
 
 	if ( entryPointNames.length() > 0 ) {
@@ -664,6 +715,175 @@ void FsmCodeGen::STATE_IDS()
 	}
 }
 
+/* The source locations of the actions on each transition, written in order
+ * of the transition ids. */
+void FsmCodeGen::TRANS_LOCS()
+{
+	RedTransAp **transPtrs = new RedTransAp*[redFsm->transSet.length()];
+	for ( TransApSet::Iter trans = redFsm->transSet; trans.lte(); trans++ )
+		transPtrs[trans->id] = trans;
+
+	out << "\t";
+	for ( int t = 0; t < redFsm->transSet.length(); t++ ) {
+		RedTransAp *trans = transPtrs[t];
+		string locs;
+		if ( trans->action != 0 ) {
+			for ( GenActionTable::Iter item = trans->action->key; item.lte(); item++ ) {
+				for ( const char *c = item->value->loc.fileName; *c != 0; c++ ) {
+					if ( *c == '"' || *c == '\\' )
+						locs += '\\';
+					locs += *c;
+				}
+				locs += ":" + itoa( item->value->loc.line );
+				if ( !item.last() )
+					locs += " ";
+			}
+		}
+		if ( locs.empty() )
+			locs = "-";
+
+		out << "\"" << locs << "\"";
+		if ( t < redFsm->transSet.length()-1 )
+			out << ",\n\t";
+	}
+	out << "\n";
+	delete[] transPtrs;
+}
+
+/* Take the bytes consumed in each state from the counter dump of a machine
+ * built with --instrument. Other lines of the dump are skipped. */
+void FsmCodeGen::readGotoProfile()
+{
+	ifstream in( gotoProfileFileName );
+	if ( !in.is_open() ) {
+		error() << "could not open " << gotoProfileFileName << " for reading" << endl;
+		return;
+	}
+
+	RedStateAp **states = new RedStateAp*[redFsm->nextStateId];
+	memset( states, 0, sizeof(RedStateAp*) * redFsm->nextStateId );
+	for ( RedStateList::Iter st = redFsm->stateList; st.lte(); st++ )
+		states[st->id] = st;
+
+	/* Dumps of several machines may share a file. Each line starts with the
+	 * name of its machine. */
+	string name = string(fsmName) + " ";
+	string line;
+	while ( getline( in, line ) ) {
+		int id;
+		unsigned long entries, bytes;
+		if ( line.compare( 0, name.length(), name ) == 0 &&
+				sscanf( line.c_str() + name.length(), "state %d entries %lu bytes %lu", 
+				&id, &entries, &bytes ) == 3 && id >= 0 && 
+				id < redFsm->nextStateId && states[id] != 0 )
+		{
+			states[id]->profileBytes = bytes;
+		}
+	}
+
+	delete[] states;
+}
+
+/* Counters for the characters consumed in each state, the entries into each
+ * state from another state and the uses of each transition. The dump
+ * function needs stdio.h. */
+void FsmCodeGen::COUNTERS_DATA()
+{
+	long numStates = redFsm->stateList.length();
+	long numTrans = redFsm->transSet.length();
+
+	out <<
+		"static struct {\n"
+		"	unsigned long state_entries[" << numStates << "];\n"
+		"	unsigned long state_bytes[" << numStates << "];\n"
+		"	unsigned long trans[" << numTrans << "];\n"
+		"} " << COUNTERS() << ";\n"
+		"\n";
+
+	OPEN_ARRAY( "char *", TL() );
+	TRANS_LOCS();
+	CLOSE_ARRAY() <<
+		"\n"
+		"static void " << DUMP_COUNTERS() << "( FILE *out )\n"
+		"{\n"
+		"	int i;\n"
+		"	for ( i = 0; i < " << numStates << "; i++ ) {\n"
+		"		if ( " << COUNTERS() << ".state_entries[i] != 0 || " <<
+				COUNTERS() << ".state_bytes[i] != 0 ) {\n"
+		"			fprintf( out, \"" << fsmName << " state %d entries %lu bytes %lu\\n\", i,\n"
+		"					" << COUNTERS() << ".state_entries[i], " <<
+				COUNTERS() << ".state_bytes[i] );\n"
+		"		}\n"
+		"	}\n"
+		"	for ( i = 0; i < " << numTrans << "; i++ ) {\n"
+		"		if ( " << COUNTERS() << ".trans[i] != 0 ) {\n"
+		"			fprintf( out, \"" << fsmName << " trans %d count %lu target %d actions %s\\n\", i,\n"
+		"					" << COUNTERS() << ".trans[i], (int)" << TT() << "[i], " <<
+				TL() << "[i] );\n"
+		"		}\n"
+		"	}\n"
+		"}\n"
+		"\n";
+}
+
+/* D has no anonymous struct variables and prints through the C library, so
+ * the dump function takes a FILE from std.c.stdio or core.stdc.stdio. */
+void FsmCodeGen::D_COUNTERS_DATA( string locType )
+{
+	long numStates = redFsm->stateList.length();
+	long numTrans = redFsm->transSet.length();
+
+	out <<
+		"struct " << COUNTERS() << "_t {\n"
+		"	ulong[" << numStates << "] state_entries;\n"
+		"	ulong[" << numStates << "] state_bytes;\n"
+		"	ulong[" << numTrans << "] trans;\n"
+		"}\n"
+		"static " << COUNTERS() << "_t " << COUNTERS() << ";\n"
+		"\n";
+
+	OPEN_ARRAY( locType, TL() );
+	TRANS_LOCS();
+	CLOSE_ARRAY() <<
+		"\n"
+		"void " << DUMP_COUNTERS() << "( FILE *out )\n"
+		"{\n"
+		"	for ( int i = 0; i < " << numStates << "; i++ ) {\n"
+		"		if ( " << COUNTERS() << ".state_entries[i] != 0 || " <<
+				COUNTERS() << ".state_bytes[i] != 0 ) {\n"
+		"			fprintf( out, \"" << fsmName << " state %d entries %llu bytes %llu\\n\", i,\n"
+		"					" << COUNTERS() << ".state_entries[i], " <<
+				COUNTERS() << ".state_bytes[i] );\n"
+		"		}\n"
+		"	}\n"
+		"	for ( int i = 0; i < " << numTrans << "; i++ ) {\n"
+		"		if ( " << COUNTERS() << ".trans[i] != 0 ) {\n"
+		"			fprintf( out, \"" << fsmName << " trans %d count %llu target %d actions %.*s\\n\", i,\n"
+		"					" << COUNTERS() << ".trans[i], cast(int) " << TT() << "[i],\n"
+		"					cast(int) " << TL() << "[i].length, " << TL() << "[i].ptr );\n"
+		"		}\n"
+		"	}\n"
+		"}\n"
+		"\n";
+}
+
+/* Written at the top of the loop, once for each character. */
+void FsmCodeGen::COUNT_STATE()
+{
+	out << "	" << COUNTERS() << ".state_bytes[" << vCS() << "]++;\n";
+}
+
+/* Written before the target is taken, with _trans holding the transition
+ * id. */
+void FsmCodeGen::COUNT_TRANS()
+{
+	out <<
+		"	" << COUNTERS() << ".trans[_trans]++;\n"
+		"	if ( " << TT() << "[_trans] != " << vCS() << " )\n"
+		"		" << COUNTERS() << ".state_entries[" << CAST( "int" ) <<
+				TT() << "[_trans]]++;\n";
+}
+
 void FsmCodeGen::writeStart()
 {
 	out << START_STATE_ID();
@@ -679,6 +899,39 @@ void FsmCodeGen::writeError()
 	out << ERROR_STATE();
 }
 
+/* Prepare a scanner for the next block of input. Any partial token is moved
+ * to the start of the buffer and the scanner pointers are rebased onto it.
+ * Afterwards p points just past the preserved prefix, which is where the next
+ * block should be read in. With the noshift option nothing is copied. The
+ * host has already arranged for the prefix to be visible at data, as is the
+ * case with a double-mapped ring buffer, and only the pointers are moved. */
+void FsmCodeGen::writeRefill()
+{
+	out << 
+		"	{\n"
+		"	if ( " << TOKSTART() << " == " << NULL_ITEM() << " )\n"
+		"		" << P() << " = " << PE() << " = " << DATA() << ";\n"
+		"	else {\n";
+
+	if ( !noShift ) {
+		out <<
+			"		if ( " << DATA() << " != " << TOKSTART() << " )\n"
+			"			memmove( " << DATA() << ", " << TOKSTART() << ", " << 
+						PE() << " - " << TOKSTART() << " );\n";
+	}
+
+	out <<
+		"		" << TOKEND() << " = " << DATA() << " + (" << 
+				TOKEND() << " - " << TOKSTART() << ");\n"
+		"		" << P() << " = " << DATA() << " + (" << 
+				P() << " - " << TOKSTART() << ");\n"
+		"		" << PE() << " = " << DATA() << " + (" << 
+				PE() << " - " << TOKSTART() << ");\n"
+		"		" << TOKSTART() << " = " << DATA() << ";\n"
+		"	}\n"
+		"	}\n";
+}
+
 /*
  * Language specific, but style independent code generators functions.
  */
@@ -693,14 +946,48 @@ string CCodeGen::PTR_CONST_END()
 	return "";
 }
 
+CCodeGen::CCodeGen( const CodeGenArgs &args )
+:
+	FsmCodeGen(args),
+	sharedArrays(args.inputData.sharedArrays),
+	outBuf(0)
+{
+}
+
 std::ostream &CCodeGen::OPEN_ARRAY( string type, string name )
 {
+	if ( shareTables ) {
+		/* Divert the items until the array is closed. */
+		arrayType = type;
+		arrayName = name;
+		arrayItems.str( "" );
+		outBuf = out.rdbuf( arrayItems.rdbuf() );
+		return out;
+	}
+
 	out << "static const " << type << " " << name << "[] = {\n";
 	return out;
 }
 
 std::ostream &CCodeGen::CLOSE_ARRAY()
 {
+	if ( shareTables ) {
+		out.rdbuf( outBuf );
+
+		/* If an earlier machine wrote the same array, use it under this name
+		 * instead of writing another copy. */
+		string items = arrayItems.str();
+		SharedArrayMapEl *written = 0;
+		if ( sharedArrays.insert( arrayType + " " + items,
+				arrayName, &written ) == 0 )
+		{
+			return out << "#define " << arrayName << " " << written->value << "\n";
+		}
+
+		out << "static const " << arrayType << " " << arrayName << "[] = {\n";
+		out << items;
+	}
+
 	return out << "};\n";
 }
 
@@ -792,6 +1079,11 @@ std::ostream &DCodeGen::CLOSE_ARRAY()
 	return out << "];\n";
 }
 
+void DCodeGen::COUNTERS_DATA()
+{
+	D_COUNTERS_DATA( "char[]" );
+}
+
 std::ostream &DCodeGen::STATIC_VAR( string type, string name )
 {
 	out << "static const " << type << " " << name;
@@ -875,6 +1167,11 @@ std::ostream &D2CodeGen::CLOSE_ARRAY()
 	return out << "];\n";
 }
 
+void D2CodeGen::COUNTERS_DATA()
+{
+	D_COUNTERS_DATA( "string" );
+}
+
 std::ostream &D2CodeGen::STATIC_VAR( string type, string name )
 {
 	out << "enum " << type << " " << name;
@@ -967,9 +1264,47 @@ void FsmCodeGen::finishRagelDef()
 	/* Maybe do flat expand, otherwise choose single. */
 	if ( codeStyle == GenFlat || codeStyle == GenFFlat )
 		redFsm->makeFlat();
+	else if ( codeStyle == GenComb ) {
+		/* The comb vector is packed from the flat lists. */
+		redFsm->makeFlat();
+		redFsm->makeComb();
+
+		if ( printStatistics ) {
+			long flatSlots = 0;
+			for ( RedStateList::Iter st = redFsm->stateList; st.lte(); st++ ) {
+				if ( st->transList != 0 )
+					flatSlots += keyOps->span( st->lowKey, st->highKey );
+				flatSlots += 1;
+			}
+			cerr << "fsm name  : " << fsmName << endl;
+			cerr << "flat slots: " << flatSlots << endl;
+			cerr << "comb slots: " << redFsm->combNext.length() << endl;
+			cerr << endl;
+		}
+	}
+	else if ( codeStyle == GenHybrid ) {
+		/* Table states read the flat lists, goto states test the singles and
+		 * ranges. */
+		redFsm->makeFlat();
+		redFsm->chooseSingle();
+
+		if ( gotoProfileFileName != 0 )
+			readGotoProfile();
+		redFsm->chooseGotoStates( gotoBudget );
+
+		if ( printStatistics ) {
+			cerr << "fsm name   : " << fsmName << endl;
+			cerr << "goto states: " << redFsm->numGotoStates << endl;
+			cerr << "goto tests : " << redFsm->gotoTests << endl;
+			cerr << endl;
+		}
+	}
 	else
 		redFsm->chooseSingle();
 
+	/* Lay out the action array with shared tails. */
+	redFsm->assignSharedActionLocs();
+
 	/* If any errors have occured in the input file then don't write anything. */
 	if ( gblErrorCount > 0 )
 		return;
@@ -985,6 +1320,10 @@ void FsmCodeGen::finishRagelDef()
 	 * of fsm directives in action code. */
 	analyzeMachine();
 
+	/* The action array must also hold the list terminator. */
+	if ( redFsm->maxActArrItem < actionList.length() )
+		redFsm->maxActArrItem = actionList.length();
+
 	/* Determine if we should use indicies. */
 	calcIndexSize();
 }
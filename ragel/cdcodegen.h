@@ -25,6 +25,7 @@
 #define _CDCODEGEN_H
 
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <stdio.h>
 #include "common.h"
@@ -65,11 +66,13 @@ public:
 	virtual void writeStart();
 	virtual void writeFirstFinal();
 	virtual void writeError();
+	virtual void writeRefill();
 
 protected:
 	string FSM_NAME();
 	string START_STATE_ID();
 	ostream &ACTIONS_ARRAY();
+	string ACTS_END();
 	string GET_WIDE_KEY();
 	string GET_WIDE_KEY( RedStateAp *state );
 	string TABS( int level );
@@ -97,6 +100,7 @@ protected:
 	string P();
 	string PE();
 	string vEOF();
+	string DATA();
 
 	string ACCESS();
 	string vCS();
@@ -105,6 +109,7 @@ protected:
 	string TOKSTART();
 	string TOKEND();
 	string ACT();
+	string REP_COUNTERS();
 
 	string DATA_PREFIX();
 	string PM() { return "_" + DATA_PREFIX() + "partition_map"; }
@@ -127,11 +132,20 @@ protected:
 	string ET() { return "_" + DATA_PREFIX() + "eof_trans"; }
 	string SP() { return "_" + DATA_PREFIX() + "key_spans"; }
 	string CSP() { return "_" + DATA_PREFIX() + "cond_key_spans"; }
+	string CB() { return "_" + DATA_PREFIX() + "comb_base"; }
+	string CC() { return "_" + DATA_PREFIX() + "comb_check"; }
+	string CN() { return "_" + DATA_PREFIX() + "comb_next"; }
+	string DT() { return "_" + DATA_PREFIX() + "trans_defaults"; }
 	string START() { return DATA_PREFIX() + "start"; }
 	string ERROR() { return DATA_PREFIX() + "error"; }
 	string FIRST_FINAL() { return DATA_PREFIX() + "first_final"; }
 	string CTXDATA() { return DATA_PREFIX() + "ctxdata"; }
 
+	/* Runtime counters written with --instrument. */
+	string COUNTERS() { return DATA_PREFIX() + "counters"; }
+	string DUMP_COUNTERS() { return DATA_PREFIX() + "dump_counters"; }
+	string TL() { return "_" + DATA_PREFIX() + "trans_locs"; }
+
 	void INLINE_LIST( ostream &ret, GenInlineList *inlineList, 
 			int targState, bool inFinish, bool csForced );
 	virtual void GOTO( ostream &ret, int gotoDest, bool inFinish ) = 0;
@@ -158,6 +172,13 @@ protected:
 			int targState, bool inFinish, bool csForced );
 	void STATE_IDS();
 
+	void TRANS_LOCS();
+	void readGotoProfile();
+	void D_COUNTERS_DATA( string locType );
+	virtual void COUNTERS_DATA();
+	virtual void COUNT_STATE();
+	virtual void COUNT_TRANS();
+
 	string ERROR_STATE();
 	string FIRST_FINAL_STATE();
 
@@ -179,7 +200,7 @@ protected:
 	bool againLabelUsed;
 	bool useIndicies;
 
-	void genLineDirective( ostream &out );
+	virtual void genLineDirective( ostream &out );
 
 public:
 	/* Determine if we should use indicies. */
@@ -189,7 +210,7 @@ public:
 class CCodeGen : virtual public FsmCodeGen
 {
 public:
-	CCodeGen( const CodeGenArgs &args ) : FsmCodeGen(args) {}
+	CCodeGen( const CodeGenArgs &args );
 
 	virtual string NULL_ITEM();
 	virtual string POINTER();
@@ -205,6 +226,14 @@ public:
 	virtual string CTRL_FLOW();
 
 	virtual void writeExports();
+
+private:
+	/* With --share-tables the items of an array are collected while it is
+	 * written, then matched against the arrays already in the output. */
+	SharedArrayMap &sharedArrays;
+	std::ostringstream arrayItems;
+	std::streambuf *outBuf;
+	string arrayType, arrayName;
 };
 
 class DCodeGen : virtual public FsmCodeGen
@@ -226,6 +255,7 @@ public:
 	virtual string CTRL_FLOW();
 
 	virtual void writeExports();
+	virtual void COUNTERS_DATA();
 };
 
 class D2CodeGen : virtual public FsmCodeGen
@@ -247,6 +277,7 @@ public:
 	virtual string CTRL_FLOW();
 
 	virtual void writeExports();
+	virtual void COUNTERS_DATA();
 	virtual void SUB_ACTION( ostream &ret, GenInlineItem *item, 
 			int targState, bool inFinish, bool csForced );
 	virtual void ACTION( ostream &ret, GenAction *action, int targState, 
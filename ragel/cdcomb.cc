@@ -0,0 +1,240 @@
+/*
+ *  Copyright 2026 agent <agent@local>
+ */
+
+/*  This file is part of Ragel.
+ *
+ *  Ragel is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  Ragel is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with Ragel; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#include "ragel.h"
+#include "cdcomb.h"
+#include "redfsm.h"
+#include "gendata.h"
+
+std::ostream &CombCodeGen::KEYS()
+{
+	out << '\t';
+	int totalTrans = 0;
+	for ( RedStateList::Iter st = redFsm->stateList; st.lte(); st++ ) {
+		/* States without a row get an empty key range so the default
+		 * transition is always taken. */
+		if ( st->transList != 0 ) {
+			out << KEY( st->lowKey ) << ", ";
+			out << KEY( st->highKey ) << ", ";
+		}
+		else {
+			out << KEY( 1 ) << ", ";
+			out << KEY( 0 ) << ", ";
+		}
+		if ( ++totalTrans % IALL == 0 )
+			out << "\n\t";
+	}
+
+	/* Output one last number so we don't have to figure out when the last
+	 * entry is and avoid writing a comma. */
+	out << 0 << "\n";
+	return out;
+}
+
+std::ostream &CombCodeGen::COMB_BASE()
+{
+	out << "\t";
+	int totalStateNum = 0;
+	for ( RedStateList::Iter st = redFsm->stateList; st.lte(); st++ ) {
+		out << st->combBase;
+		if ( !st.last() ) {
+			out << ", ";
+			if ( ++totalStateNum % IALL == 0 )
+				out << "\n\t";
+		}
+	}
+	out << "\n";
+	return out;
+}
+
+std::ostream &CombCodeGen::COMB_CHECK()
+{
+	out << "\t";
+	int totalSlots = 0;
+	for ( int slot = 0; slot < redFsm->combCheck.length(); slot++ ) {
+		/* Unused slots get an id that no state has. */
+		RedStateAp *owner = redFsm->combCheck[slot];
+		out << ( owner != 0 ? owner->id : redFsm->nextStateId ) << ", ";
+		if ( ++totalSlots % IALL == 0 )
+			out << "\n\t";
+	}
+
+	/* Output one last number so we don't have to figure out when the last
+	 * entry is and avoid writing a comma. */
+	out << redFsm->nextStateId << "\n";
+	return out;
+}
+
+std::ostream &CombCodeGen::COMB_NEXT()
+{
+	out << "\t";
+	int totalSlots = 0;
+	for ( int slot = 0; slot < redFsm->combNext.length(); slot++ ) {
+		RedTransAp *trans = redFsm->combNext[slot];
+		out << ( trans != 0 ? trans->id : 0 ) << ", ";
+		if ( ++totalSlots % IALL == 0 )
+			out << "\n\t";
+	}
+
+	/* Output one last number so we don't have to figure out when the last
+	 * entry is and avoid writing a comma. */
+	out << 0 << "\n";
+	return out;
+}
+
+std::ostream &CombCodeGen::TRANS_DEFAULTS()
+{
+	out << "\t";
+	int totalStateNum = 0;
+	for ( RedStateList::Iter st = redFsm->stateList; st.lte(); st++ ) {
+		/* Every state but the error state has a default. The error state
+		 * is never looked up. */
+		if ( st->defTrans != 0 )
+			out << st->defTrans->id;
+		else
+			out << 0;
+		if ( !st.last() ) {
+			out << ", ";
+			if ( ++totalStateNum % IALL == 0 )
+				out << "\n\t";
+		}
+	}
+	out << "\n";
+	return out;
+}
+
+void CombCodeGen::LOCATE_TRANS()
+{
+	out <<
+		"	_keys = " << ARR_OFF( K(), "(" + vCS() + "<<1)" ) << ";\n"
+		"	_inds = " << ARR_OFF( CN(), CB() + "[" + vCS() + "]" ) << ";\n"
+		"\n"
+		"	_trans = " << DT() << "[" << vCS() << "];\n"
+		"	if ( _keys[0] <= " << GET_WIDE_KEY() << " && " << 
+				GET_WIDE_KEY() << " <= _keys[1] ) {\n"
+		"		_slen = " << GET_WIDE_KEY() << " - _keys[0];\n"
+		"		if ( " << CC() << "[" << CB() << "[" << vCS() << "] + _slen] == " << 
+				vCS() << " )\n"
+		"			_trans = _inds[_slen];\n"
+		"	}\n"
+		"\n";
+}
+
+void CombCodeGen::writeData()
+{
+	/* If there are any transtion functions then output the array. If there
+	 * are none, don't bother emitting an empty array that won't be used. */
+	if ( redFsm->anyActions() ) {
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxActArrItem), A() );
+		ACTIONS_ARRAY();
+		CLOSE_ARRAY() <<
+		"\n";
+	}
+
+	if ( redFsm->anyConditions() ) {
+		OPEN_ARRAY( WIDE_ALPH_TYPE(), CK() );
+		COND_KEYS();
+		CLOSE_ARRAY() <<
+		"\n";
+
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxCondSpan), CSP() );
+		COND_KEY_SPANS();
+		CLOSE_ARRAY() <<
+		"\n";
+
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxCond), C() );
+		CONDS();
+		CLOSE_ARRAY() <<
+		"\n";
+
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxCondIndexOffset), CO() );
+		COND_INDEX_OFFSET();
+		CLOSE_ARRAY() <<
+		"\n";
+	}
+
+	OPEN_ARRAY( WIDE_ALPH_TYPE(), K() );
+	KEYS();
+	CLOSE_ARRAY() <<
+	"\n";
+
+	OPEN_ARRAY( ARRAY_TYPE(redFsm->maxCombBase), CB() );
+	COMB_BASE();
+	CLOSE_ARRAY() <<
+	"\n";
+
+	OPEN_ARRAY( ARRAY_TYPE(redFsm->nextStateId), CC() );
+	COMB_CHECK();
+	CLOSE_ARRAY() <<
+	"\n";
+
+	OPEN_ARRAY( ARRAY_TYPE(redFsm->maxIndex), CN() );
+	COMB_NEXT();
+	CLOSE_ARRAY() <<
+	"\n";
+
+	OPEN_ARRAY( ARRAY_TYPE(redFsm->maxIndex), DT() );
+	TRANS_DEFAULTS();
+	CLOSE_ARRAY() <<
+	"\n";
+
+	OPEN_ARRAY( ARRAY_TYPE(redFsm->maxState), TT() );
+	TRANS_TARGS();
+	CLOSE_ARRAY() <<
+	"\n";
+
+	if ( redFsm->anyActions() ) {
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxActionLoc), TA() );
+		TRANS_ACTIONS();
+		CLOSE_ARRAY() <<
+		"\n";
+	}
+
+	if ( redFsm->anyToStateActions() ) {
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxActionLoc), TSA() );
+		TO_STATE_ACTIONS();
+		CLOSE_ARRAY() <<
+		"\n";
+	}
+
+	if ( redFsm->anyFromStateActions() ) {
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxActionLoc), FSA() );
+		FROM_STATE_ACTIONS();
+		CLOSE_ARRAY() <<
+		"\n";
+	}
+
+	if ( redFsm->anyEofActions() ) {
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxActionLoc), EA() );
+		EOF_ACTIONS();
+		CLOSE_ARRAY() <<
+		"\n";
+	}
+
+	if ( redFsm->anyEofTrans() ) {
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxIndexOffset+1), ET() );
+		EOF_TRANS();
+		CLOSE_ARRAY() <<
+		"\n";
+	}
+
+	STATE_IDS();
+}
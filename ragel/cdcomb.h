@@ -0,0 +1,86 @@
+/*
+ *  Copyright 2026 agent <agent@local>
+ */
+
+/*  This file is part of Ragel.
+ *
+ *  Ragel is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  Ragel is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with Ragel; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#ifndef _CDCOMB_H
+#define _CDCOMB_H
+
+#include <iostream>
+#include "cdflat.h"
+
+/* Forwards. */
+struct CodeGenData;
+struct RedStateAp;
+
+/*
+ * CombCodeGen
+ *
+ * Flat tables with the per-state rows overlapped in a single comb vector.
+ * The check vector records which state owns each slot. Characters that miss
+ * the row take the state's default transition.
+ */
+class CombCodeGen : public FlatCodeGen
+{
+public:
+	CombCodeGen( const CodeGenArgs &args ) : FsmCodeGen(args), FlatCodeGen(args) {}
+	virtual ~CombCodeGen() { }
+
+protected:
+	std::ostream &KEYS();
+	std::ostream &COMB_BASE();
+	std::ostream &COMB_CHECK();
+	std::ostream &COMB_NEXT();
+	std::ostream &TRANS_DEFAULTS();
+	virtual void LOCATE_TRANS();
+
+	virtual void writeData();
+};
+
+/*
+ * CCombCodeGen
+ */
+struct CCombCodeGen
+	: public CombCodeGen, public CCodeGen
+{
+	CCombCodeGen( const CodeGenArgs &args ) : 
+		FsmCodeGen(args), CombCodeGen(args), CCodeGen(args) {}
+};
+
+/*
+ * DCombCodeGen
+ */
+struct DCombCodeGen
+	: public CombCodeGen, public DCodeGen
+{
+	DCombCodeGen( const CodeGenArgs &args ) : 
+		FsmCodeGen(args), CombCodeGen(args), DCodeGen(args) {}
+};
+
+/*
+ * D2CombCodeGen
+ */
+struct D2CombCodeGen
+	: public CombCodeGen, public D2CodeGen
+{
+	D2CombCodeGen( const CodeGenArgs &args ) : 
+		FsmCodeGen(args), CombCodeGen(args), D2CodeGen(args) {}
+};
+
+#endif
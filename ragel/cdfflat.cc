@@ -234,6 +234,9 @@ void FFlatCodeGen::writeData()
 	}
 
 	STATE_IDS();
+
+	if ( instrument )
+		COUNTERS_DATA();
 }
 
 void FFlatCodeGen::writeExec()
@@ -282,6 +285,9 @@ void FFlatCodeGen::writeExec()
 
 	out << "_resume:\n";
 
+	if ( instrument )
+		COUNT_STATE();
+
 	if ( redFsm->anyFromStateActions() ) {
 		out <<
 			"	switch ( " << FSA() << "[" << vCS() << "] ) {\n";
@@ -302,6 +308,9 @@ void FFlatCodeGen::writeExec()
 	if ( redFsm->anyRegCurStateRef() )
 		out << "	_ps = " << vCS() << ";\n";
 
+	if ( instrument )
+		COUNT_TRANS();
+
 	out << 
 		"	" << vCS() << " = " << TT() << "[_trans];\n\n";
 
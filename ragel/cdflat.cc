@@ -631,6 +631,9 @@ void FlatCodeGen::writeData()
 	}
 
 	STATE_IDS();
+
+	if ( instrument )
+		COUNTERS_DATA();
 }
 
 void FlatCodeGen::COND_TRANSLATE()
@@ -698,8 +701,7 @@ void FlatCodeGen::writeExec()
 			redFsm->anyRegActions() || redFsm->anyFromStateActions() )
 	{
 		out << 
-			"	" << PTR_CONST() << ARRAY_TYPE(redFsm->maxActArrItem) << PTR_CONST_END() << POINTER() << "_acts;\n"
-			"	" << UINT() << " _nacts;\n"; 
+			"	" << PTR_CONST() << ARRAY_TYPE(redFsm->maxActArrItem) << PTR_CONST_END() << POINTER() << "_acts;\n";
 	}
 
 	out <<
@@ -730,11 +732,13 @@ void FlatCodeGen::writeExec()
 
 	out << "_resume:\n";
 
+	if ( instrument )
+		COUNT_STATE();
+
 	if ( redFsm->anyFromStateActions() ) {
 		out <<
 			"	_acts = " << ARR_OFF( A(), FSA() + "[" + vCS() + "]" ) << ";\n"
-			"	_nacts = " << CAST(UINT()) << " *_acts++;\n"
-			"	while ( _nacts-- > 0 ) {\n"
+			"	while ( *_acts != " << ACTS_END() << " ) {\n"
 			"		switch ( *_acts++ ) {\n";
 			FROM_STATE_ACTION_SWITCH();
 			SWITCH_DEFAULT() <<
@@ -754,6 +758,9 @@ void FlatCodeGen::writeExec()
 	if ( redFsm->anyRegCurStateRef() )
 		out << "	_ps = " << vCS() << ";\n";
 
+	if ( instrument )
+		COUNT_TRANS();
+
 	out <<
 		"	" << vCS() << " = " << TT() << "[_trans];\n"
 		"\n";
@@ -764,8 +771,7 @@ void FlatCodeGen::writeExec()
 			"		goto _again;\n"
 			"\n"
 			"	_acts = " << ARR_OFF( A(), TA() + "[_trans]" ) << ";\n"
-			"	_nacts = " << CAST(UINT()) << " *_acts++;\n"
-			"	while ( _nacts-- > 0 ) {\n"
+			"	while ( *_acts != " << ACTS_END() << " ) {\n"
 			"		switch ( *(_acts++) )\n		{\n";
 			ACTION_SWITCH();
 			SWITCH_DEFAULT() <<
@@ -781,8 +787,7 @@ void FlatCodeGen::writeExec()
 	if ( redFsm->anyToStateActions() ) {
 		out <<
 			"	_acts = " << ARR_OFF( A(),  TSA() + "[" + vCS() + "]" ) << ";\n"
-			"	_nacts = " << CAST(UINT()) << " *_acts++;\n"
-			"	while ( _nacts-- > 0 ) {\n"
+			"	while ( *_acts != " << ACTS_END() << " ) {\n"
 			"		switch ( *_acts++ ) {\n";
 			TO_STATE_ACTION_SWITCH();
 			SWITCH_DEFAULT() <<
@@ -830,8 +835,7 @@ void FlatCodeGen::writeExec()
 				"	" << PTR_CONST() << ARRAY_TYPE(redFsm->maxActArrItem) << PTR_CONST_END() << 
 						POINTER() << "__acts = " << 
 						ARR_OFF( A(), EA() + "[" + vCS() + "]" ) << ";\n"
-				"	" << UINT() << " __nacts = " << CAST(UINT()) << " *__acts++;\n"
-				"	while ( __nacts-- > 0 ) {\n"
+				"	while ( *__acts != " << ACTS_END() << " ) {\n"
 				"		switch ( *__acts++ ) {\n";
 				EOF_ACTION_SWITCH();
 				SWITCH_DEFAULT() <<
@@ -57,7 +57,7 @@ protected:
 	std::ostream &EOF_TRANS();
 	std::ostream &TRANS_TARGS();
 	std::ostream &TRANS_ACTIONS();
-	void LOCATE_TRANS();
+	virtual void LOCATE_TRANS();
 
 	std::ostream &COND_INDEX_OFFSET();
 	void COND_TRANSLATE();
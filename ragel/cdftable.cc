@@ -50,8 +50,9 @@ void FTabCodeGen::calcIndexSize()
 			sizeWithoutInds += arrayTypeSize(redFsm->maxActListId) * totalIndex;
 	}
 
-	/* If using indicies reduces the size, use them. */
-	useIndicies = sizeWithInds < sizeWithoutInds;
+	/* If using indicies reduces the size, use them. The counters are indexed
+	 * by transition id, which _trans only holds when indicies are used. */
+	useIndicies = instrument || sizeWithInds < sizeWithoutInds;
 }
 
 std::ostream &FTabCodeGen::TO_STATE_ACTION( RedStateAp *state )
@@ -288,6 +289,9 @@ void FTabCodeGen::writeData()
 	}
 
 	STATE_IDS();
+
+	if ( instrument )
+		COUNTERS_DATA();
 }
 
 void FTabCodeGen::writeExec()
@@ -328,6 +332,9 @@ void FTabCodeGen::writeExec()
 
 	out << "_resume:\n";
 
+	if ( instrument )
+		COUNT_STATE();
+
 	if ( redFsm->anyFromStateActions() ) {
 		out <<
 			"	switch ( " << FSA() << "[" << vCS() << "] ) {\n";
@@ -353,6 +360,9 @@ void FTabCodeGen::writeExec()
 	if ( redFsm->anyRegCurStateRef() )
 		out << "	_ps = " << vCS() << ";\n";
 
+	if ( instrument )
+		COUNT_TRANS();
+
 	out <<
 		"	" << vCS() << " = " << TT() << "[_trans];\n"
 		"\n";
@@ -415,8 +415,7 @@ std::ostream &GotoCodeGen::EXEC_FUNCS()
 	out <<
 		"\n"
 		"execFuncs:\n"
-		"	_nacts = *_acts++;\n"
-		"	while ( _nacts-- > 0 ) {\n"
+		"	while ( *_acts != " << ACTS_END() << " ) {\n"
 		"		switch ( *_acts++ ) {\n";
 		ACTION_SWITCH();
 		SWITCH_DEFAULT() <<
@@ -671,8 +670,7 @@ void GotoCodeGen::writeExec()
 			|| redFsm->anyFromStateActions() )
 	{
 		out << 
-			"	" << PTR_CONST() << ARRAY_TYPE(redFsm->maxActArrItem) << PTR_CONST_END() << POINTER() << "_acts;\n"
-			"	" << UINT() << " _nacts;\n";
+			"	" << PTR_CONST() << ARRAY_TYPE(redFsm->maxActArrItem) << PTR_CONST_END() << POINTER() << "_acts;\n";
 	}
 
 	if ( redFsm->anyConditions() )
@@ -699,8 +697,7 @@ void GotoCodeGen::writeExec()
 	if ( redFsm->anyFromStateActions() ) {
 		out <<
 			"	_acts = " << ARR_OFF( A(), FSA() + "[" + vCS() + "]" ) << ";\n"
-			"	_nacts = " << CAST(UINT()) << " *_acts++;\n"
-			"	while ( _nacts-- > 0 ) {\n"
+			"	while ( *_acts != " << ACTS_END() << " ) {\n"
 			"		switch ( *_acts++ ) {\n";
 			FROM_STATE_ACTION_SWITCH();
 			SWITCH_DEFAULT() <<
@@ -726,8 +723,7 @@ void GotoCodeGen::writeExec()
 	if ( redFsm->anyToStateActions() ) {
 		out <<
 			"	_acts = " << ARR_OFF( A(), TSA() + "[" + vCS() + "]" ) << ";\n"
-			"	_nacts = " << CAST(UINT()) << " *_acts++;\n"
-			"	while ( _nacts-- > 0 ) {\n"
+			"	while ( *_acts != " << ACTS_END() << " ) {\n"
 			"		switch ( *_acts++ ) {\n";
 			TO_STATE_ACTION_SWITCH();
 			SWITCH_DEFAULT() <<
@@ -780,8 +776,7 @@ void GotoCodeGen::writeExec()
 				"	" << PTR_CONST() << ARRAY_TYPE(redFsm->maxActArrItem) << PTR_CONST_END() << 
 						POINTER() << "__acts = " << 
 						ARR_OFF( A(), EA() + "[" + vCS() + "]" ) << ";\n"
-				"	" << UINT() << " __nacts = " << CAST(UINT()) << " *__acts++;\n"
-				"	while ( __nacts-- > 0 ) {\n"
+				"	while ( *__acts != " << ACTS_END() << " ) {\n"
 				"		switch ( *__acts++ ) {\n";
 				EOF_ACTION_SWITCH();
 				SWITCH_DEFAULT() <<
@@ -0,0 +1,656 @@
+/*
+ *  Copyright 2026 agent <agent@local>
+ */
+
+/*  This file is part of Ragel.
+ *
+ *  Ragel is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  Ragel is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with Ragel; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#include "ragel.h"
+#include "cdhybrid.h"
+#include "redfsm.h"
+#include "gendata.h"
+
+std::ostream &HybridCodeGen::KEY_SPANS()
+{
+	out << "\t";
+	int totalStateNum = 0;
+	for ( RedStateList::Iter st = redFsm->stateList; st.lte(); st++ ) {
+		/* Goto states have no row. */
+		unsigned long long span = 0;
+		if ( st->transList != 0 && !st->hybridGoto )
+			span = keyOps->span( st->lowKey, st->highKey );
+		out << span;
+		if ( !st.last() ) {
+			out << ", ";
+			if ( ++totalStateNum % IALL == 0 )
+				out << "\n\t";
+		}
+	}
+	out << "\n";
+	return out;
+}
+
+std::ostream &HybridCodeGen::FLAT_INDEX_OFFSET()
+{
+	out << "\t";
+	int totalStateNum = 0, curIndOffset = 0;
+	for ( RedStateList::Iter st = redFsm->stateList; st.lte(); st++ ) {
+		/* Write the index offset. */
+		out << curIndOffset;
+		if ( !st.last() ) {
+			out << ", ";
+			if ( ++totalStateNum % IALL == 0 )
+				out << "\n\t";
+		}
+
+		/* Move the index offset ahead. */
+		if ( !st->hybridGoto ) {
+			if ( st->transList != 0 )
+				curIndOffset += keyOps->span( st->lowKey, st->highKey );
+
+			if ( st->defTrans != 0 )
+				curIndOffset += 1;
+		}
+	}
+	out << "\n";
+	return out;
+}
+
+std::ostream &HybridCodeGen::INDICIES()
+{
+	int totalTrans = 0;
+	out << '\t';
+	for ( RedStateList::Iter st = redFsm->stateList; st.lte(); st++ ) {
+		if ( st->hybridGoto )
+			continue;
+
+		if ( st->transList != 0 ) {
+			/* Walk the singles. */
+			unsigned long long span = keyOps->span( st->lowKey, st->highKey );
+			for ( unsigned long long pos = 0; pos < span; pos++ ) {
+				out << st->transList[pos]->id << ", ";
+				if ( ++totalTrans % IALL == 0 )
+					out << "\n\t";
+			}
+		}
+
+		/* The state's default index goes next. */
+		if ( st->defTrans != 0 )
+			out << st->defTrans->id << ", ";
+
+		if ( ++totalTrans % IALL == 0 )
+			out << "\n\t";
+	}
+
+	/* Output one last number so we don't have to figure out when the last
+	 * entry is and avoid writing a comma. */
+	out << 0 << "\n";
+	return out;
+}
+
+/* With a big enough budget there is nothing left in the tables. */
+bool HybridCodeGen::anyTableStates()
+{
+	for ( RedStateList::Iter st = redFsm->stateList; st.lte(); st++ ) {
+		if ( st != redFsm->errState && !st->hybridGoto )
+			return true;
+	}
+	return false;
+}
+
+/* Emit the goto to take for a given transition. */
+std::ostream &HybridCodeGen::TRANS_GOTO( RedTransAp *trans, int level )
+{
+	out << TABS(level) << "goto tr" << trans->id << ";";
+	return out;
+}
+
+void HybridCodeGen::emitSingleSwitch( RedStateAp *state )
+{
+	/* Load up the singles. */
+	int numSingles = state->outSingle.length();
+	RedTransEl *data = state->outSingle.data;
+
+	if ( numSingles == 1 ) {
+		/* If there is a single single key then write it out as an if. */
+		out << "\tif ( " << GET_WIDE_KEY(state) << " == " << 
+				WIDE_KEY(state, data[0].lowKey) << " )\n\t\t"; 
+
+		TRANS_GOTO(data[0].value, 0) << "\n";
+	}
+	else if ( numSingles > 1 ) {
+		/* Write out single keys in a switch if there is more than one. */
+		out << "\tswitch( " << GET_WIDE_KEY(state) << " ) {\n";
+
+		/* Write out the single indicies. */
+		for ( int j = 0; j < numSingles; j++ ) {
+			out << "\t\tcase " << WIDE_KEY(state, data[j].lowKey) << ": ";
+			TRANS_GOTO(data[j].value, 0) << "\n";
+		}
+		
+		/* Emits a default case for D code. */
+		SWITCH_DEFAULT();
+
+		/* Close off the transition switch. */
+		out << "\t}\n";
+	}
+}
+
+void HybridCodeGen::emitRangeBSearch( RedStateAp *state, int level, int low, int high )
+{
+	/* Get the mid position, staying on the lower end of the range. */
+	int mid = (low + high) >> 1;
+	RedTransEl *data = state->outRange.data;
+
+	/* Determine if we need to look higher or lower. */
+	bool anyLower = mid > low;
+	bool anyHigher = mid < high;
+
+	/* Determine if the keys at mid are the limits of the alphabet. */
+	bool limitLow = data[mid].lowKey == keyOps->minKey;
+	bool limitHigh = data[mid].highKey == keyOps->maxKey;
+
+	if ( anyLower && anyHigher ) {
+		/* Can go lower and higher than mid. */
+		out << TABS(level) << "if ( " << GET_WIDE_KEY(state) << " < " << 
+				WIDE_KEY(state, data[mid].lowKey) << " ) {\n";
+		emitRangeBSearch( state, level+1, low, mid-1 );
+		out << TABS(level) << "} else if ( " << GET_WIDE_KEY(state) << " > " << 
+				WIDE_KEY(state, data[mid].highKey) << " ) {\n";
+		emitRangeBSearch( state, level+1, mid+1, high );
+		out << TABS(level) << "} else\n";
+		TRANS_GOTO(data[mid].value, level+1) << "\n";
+	}
+	else if ( anyLower && !anyHigher ) {
+		/* Can go lower than mid but not higher. */
+		out << TABS(level) << "if ( " << GET_WIDE_KEY(state) << " < " << 
+				WIDE_KEY(state, data[mid].lowKey) << " ) {\n";
+		emitRangeBSearch( state, level+1, low, mid-1 );
+
+		/* if the higher is the highest in the alphabet then there is no
+		 * sense testing it. */
+		if ( limitHigh ) {
+			out << TABS(level) << "} else\n";
+			TRANS_GOTO(data[mid].value, level+1) << "\n";
+		}
+		else {
+			out << TABS(level) << "} else if ( " << GET_WIDE_KEY(state) << " <= " << 
+					WIDE_KEY(state, data[mid].highKey) << " )\n";
+			TRANS_GOTO(data[mid].value, level+1) << "\n";
+		}
+	}
+	else if ( !anyLower && anyHigher ) {
+		/* Can go higher than mid but not lower. */
+		out << TABS(level) << "if ( " << GET_WIDE_KEY(state) << " > " << 
+				WIDE_KEY(state, data[mid].highKey) << " ) {\n";
+		emitRangeBSearch( state, level+1, mid+1, high );
+
+		/* If the lower end is the lowest in the alphabet then there is no
+		 * sense testing it. */
+		if ( limitLow ) {
+			out << TABS(level) << "} else\n";
+			TRANS_GOTO(data[mid].value, level+1) << "\n";
+		}
+		else {
+			out << TABS(level) << "} else if ( " << GET_WIDE_KEY(state) << " >= " << 
+					WIDE_KEY(state, data[mid].lowKey) << " )\n";
+			TRANS_GOTO(data[mid].value, level+1) << "\n";
+		}
+	}
+	else {
+		/* Cannot go higher or lower than mid. It's mid or bust. What
+		 * tests to do depends on limits of alphabet. */
+		if ( !limitLow && !limitHigh ) {
+			out << TABS(level) << "if ( " << WIDE_KEY(state, data[mid].lowKey) << " <= " << 
+					GET_WIDE_KEY(state) << " && " << GET_WIDE_KEY(state) << " <= " << 
+					WIDE_KEY(state, data[mid].highKey) << " )\n";
+			TRANS_GOTO(data[mid].value, level+1) << "\n";
+		}
+		else if ( limitLow && !limitHigh ) {
+			out << TABS(level) << "if ( " << GET_WIDE_KEY(state) << " <= " << 
+					WIDE_KEY(state, data[mid].highKey) << " )\n";
+			TRANS_GOTO(data[mid].value, level+1) << "\n";
+		}
+		else if ( !limitLow && limitHigh ) {
+			out << TABS(level) << "if ( " << WIDE_KEY(state, data[mid].lowKey) << " <= " << 
+					GET_WIDE_KEY(state) << " )\n";
+			TRANS_GOTO(data[mid].value, level+1) << "\n";
+		}
+		else {
+			/* Both high and low are at the limit. No tests to do. */
+			TRANS_GOTO(data[mid].value, level+1) << "\n";
+		}
+	}
+}
+
+/* The code of the goto states. The conditions have already been folded into
+ * _widec by the table lookup of the condition spaces. */
+std::ostream &HybridCodeGen::STATE_GOTOS()
+{
+	for ( RedStateList::Iter st = redFsm->stateList; st.lte(); st++ ) {
+		if ( st->hybridGoto ) {
+			out << "st" << st->id << ":\n";
+
+			/* Try singles. */
+			if ( st->outSingle.length() > 0 )
+				emitSingleSwitch( st );
+
+			/* Default case is to binary search for the ranges, if that fails then */
+			if ( st->outRange.length() > 0 )
+				emitRangeBSearch( st, 1, 0, st->outRange.length() - 1 );
+
+			/* Write the default transition. */
+			TRANS_GOTO( st->defTrans, 1 ) << "\n";
+		}
+	}
+	return out;
+}
+
+std::ostream &HybridCodeGen::TRANSITIONS()
+{
+	for ( TransApSet::Iter trans = redFsm->transSet; trans.lte(); trans++ ) {
+		if ( !transUsed[trans->id] )
+			continue;
+
+		/* Write the label for the transition so it can be jumped to. */
+		out << "	tr" << trans->id << ": ";
+
+		/* Destination state. */
+		if ( trans->action != 0 && trans->action->anyCurStateRef() )
+			out << "_ps = " << vCS() << ";";
+		out << vCS() << " = " << trans->targ->id << "; ";
+
+		if ( trans->action != 0 ) {
+			/* Write out the transition func. */
+			out << "goto f" << trans->action->actListId << ";\n";
+		}
+		else if ( directJumps && trans->targ->hybridGoto ) {
+			/* Move on to the next character and straight to the state. */
+			if ( !noEnd ) {
+				testEofUsed = true;
+				out << "if ( ++" << P() << " == " << PE() << " ) goto _test_eof; ";
+			}
+			else {
+				out << P() << " += 1; ";
+			}
+			out << "goto st" << trans->targ->id << ";\n";
+		}
+		else {
+			/* No code to execute, just loop around. */
+			out << "goto _again;\n";
+		}
+	}
+	return out;
+}
+
+std::ostream &HybridCodeGen::EXEC_FUNCS()
+{
+	/* Make labels that set acts and jump to execFuncs. */
+	for ( GenActionTableMap::Iter redAct = redFsm->actionMap; redAct.lte(); redAct++ ) {
+		if ( actListUsed[redAct->actListId] ) {
+			out << "	f" << redAct->actListId << ": " <<
+				"_acts = " << ARR_OFF(A(), itoa( redAct->location+1 ) ) << ";"
+				" goto execFuncs;\n";
+		}
+	}
+
+	out <<
+		"\n"
+		"execFuncs:\n"
+		"	while ( *_acts != " << ACTS_END() << " ) {\n"
+		"		switch ( *_acts++ ) {\n";
+		ACTION_SWITCH();
+		SWITCH_DEFAULT() <<
+		"		}\n"
+		"	}\n";
+	return out;
+}
+
+void HybridCodeGen::writeData()
+{
+	/* If there are any transtion functions then output the array. If there
+	 * are none, don't bother emitting an empty array that won't be used. */
+	if ( redFsm->anyActions() ) {
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxActArrItem), A() );
+		ACTIONS_ARRAY();
+		CLOSE_ARRAY() <<
+		"\n";
+	}
+
+	if ( redFsm->anyConditions() ) {
+		OPEN_ARRAY( WIDE_ALPH_TYPE(), CK() );
+		COND_KEYS();
+		CLOSE_ARRAY() <<
+		"\n";
+
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxCondSpan), CSP() );
+		COND_KEY_SPANS();
+		CLOSE_ARRAY() <<
+		"\n";
+
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxCond), C() );
+		CONDS();
+		CLOSE_ARRAY() <<
+		"\n";
+
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxCondIndexOffset), CO() );
+		COND_INDEX_OFFSET();
+		CLOSE_ARRAY() <<
+		"\n";
+	}
+
+	if ( anyTableStates() ) {
+		OPEN_ARRAY( WIDE_ALPH_TYPE(), K() );
+		KEYS();
+		CLOSE_ARRAY() <<
+		"\n";
+
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxSpan), SP() );
+		KEY_SPANS();
+		CLOSE_ARRAY() <<
+		"\n";
+
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxFlatIndexOffset), IO() );
+		FLAT_INDEX_OFFSET();
+		CLOSE_ARRAY() <<
+		"\n";
+
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxIndex), I() );
+		INDICIES();
+		CLOSE_ARRAY() <<
+		"\n";
+	}
+
+	/* The positions of the transitions are also needed by the EOF
+	 * transitions. */
+	if ( anyTableStates() || redFsm->anyEofTrans() ) {
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxState), TT() );
+		TRANS_TARGS();
+		CLOSE_ARRAY() <<
+		"\n";
+
+		if ( redFsm->anyActions() ) {
+			OPEN_ARRAY( ARRAY_TYPE(redFsm->maxActionLoc), TA() );
+			TRANS_ACTIONS();
+			CLOSE_ARRAY() <<
+			"\n";
+		}
+	}
+
+	if ( redFsm->anyToStateActions() ) {
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxActionLoc), TSA() );
+		TO_STATE_ACTIONS();
+		CLOSE_ARRAY() <<
+		"\n";
+	}
+
+	if ( redFsm->anyFromStateActions() ) {
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxActionLoc), FSA() );
+		FROM_STATE_ACTIONS();
+		CLOSE_ARRAY() <<
+		"\n";
+	}
+
+	if ( redFsm->anyEofActions() ) {
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxActionLoc), EA() );
+		EOF_ACTIONS();
+		CLOSE_ARRAY() <<
+		"\n";
+	}
+
+	if ( redFsm->anyEofTrans() ) {
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxIndexOffset+1), ET() );
+		EOF_TRANS();
+		CLOSE_ARRAY() <<
+		"\n";
+	}
+
+	STATE_IDS();
+}
+
+void HybridCodeGen::writeExec()
+{
+	testEofUsed = false;
+	outLabelUsed = false;
+
+	/* Find the transitions and action lists the goto states need labels
+	 * for. */
+	transUsed = new bool[redFsm->transSet.length()];
+	memset( transUsed, 0, sizeof(bool) * redFsm->transSet.length() );
+	actListUsed = new bool[redFsm->actionMap.length()];
+	memset( actListUsed, 0, sizeof(bool) * redFsm->actionMap.length() );
+
+	for ( RedStateList::Iter st = redFsm->stateList; st.lte(); st++ ) {
+		if ( st->hybridGoto ) {
+			for ( RedTransList::Iter rtel = st->outSingle; rtel.lte(); rtel++ )
+				transUsed[rtel->value->id] = true;
+			for ( RedTransList::Iter rtel = st->outRange; rtel.lte(); rtel++ )
+				transUsed[rtel->value->id] = true;
+			transUsed[st->defTrans->id] = true;
+		}
+	}
+
+	for ( TransApSet::Iter trans = redFsm->transSet; trans.lte(); trans++ ) {
+		if ( transUsed[trans->id] && trans->action != 0 )
+			actListUsed[trans->action->actListId] = true;
+	}
+
+	directJumps = !redFsm->anyFromStateActions() && 
+			!redFsm->anyToStateActions() && !redFsm->anyConditions();
+
+	/* The key pointers are also used to find the condition spaces. */
+	bool lookups = anyTableStates() || redFsm->anyConditions();
+
+	string vars;
+	if ( anyTableStates() || redFsm->anyEofTrans() )
+		vars += ", _trans";
+	if ( lookups )
+		vars += ", _slen";
+	if ( redFsm->anyRegCurStateRef() )
+		vars += ", _ps";
+	if ( redFsm->anyConditions() )
+		vars += ", _cond";
+
+	out << "	{\n";
+	if ( vars.length() > 0 )
+		out << "	int " << vars.substr( 2 ) << ";\n";
+
+	if ( redFsm->anyToStateActions() || 
+			redFsm->anyRegActions() || redFsm->anyFromStateActions() )
+	{
+		out << 
+			"	" << PTR_CONST() << ARRAY_TYPE(redFsm->maxActArrItem) << PTR_CONST_END() << POINTER() << "_acts;\n";
+	}
+
+	if ( lookups ) {
+		out <<
+			"	" << PTR_CONST() << WIDE_ALPH_TYPE() << PTR_CONST_END() << POINTER() << "_keys;\n";
+	}
+
+	if ( anyTableStates() ) {
+		out <<
+			"	" << PTR_CONST() << ARRAY_TYPE(redFsm->maxIndex) << PTR_CONST_END() << POINTER() << "_inds;\n";
+	}
+
+	if ( redFsm->anyConditions() ) {
+		out << 
+			"	" << PTR_CONST() << ARRAY_TYPE(redFsm->maxCond) << PTR_CONST_END() << POINTER() << "_conds;\n"
+			"	" << WIDE_ALPH_TYPE() << " _widec;\n";
+	}
+
+	out << "\n";
+
+	if ( !noEnd ) {
+		testEofUsed = true;
+		out << 
+			"	if ( " << P() << " == " << PE() << " )\n"
+			"		goto _test_eof;\n";
+	}
+
+	if ( redFsm->errState != 0 ) {
+		outLabelUsed = true;
+		out << 
+			"	if ( " << vCS() << " == " << redFsm->errState->id << " )\n"
+			"		goto _out;\n";
+	}
+
+	out << "_resume:\n";
+
+	if ( redFsm->anyFromStateActions() ) {
+		out <<
+			"	_acts = " << ARR_OFF( A(), FSA() + "[" + vCS() + "]" ) << ";\n"
+			"	while ( *_acts != " << ACTS_END() << " ) {\n"
+			"		switch ( *_acts++ ) {\n";
+			FROM_STATE_ACTION_SWITCH();
+			SWITCH_DEFAULT() <<
+			"		}\n"
+			"	}\n"
+			"\n";
+	}
+
+	if ( redFsm->anyConditions() )
+		COND_TRANSLATE();
+
+	if ( redFsm->numGotoStates > 0 ) {
+		out <<
+			"	switch ( " << vCS() << " ) {\n";
+
+		for ( RedStateList::Iter st = redFsm->stateList; st.lte(); st++ ) {
+			if ( st->hybridGoto )
+				out << "	case " << st->id << ": goto st" << st->id << ";\n";
+		}
+
+		SWITCH_DEFAULT() <<
+			"	}\n"
+			"\n";
+	}
+
+	if ( anyTableStates() )
+		LOCATE_TRANS();
+
+	/* Transitions found in the tables and those taken at EOF run from the
+	 * tables. */
+	if ( anyTableStates() || redFsm->anyEofTrans() ) {
+		if ( redFsm->anyEofTrans() )
+			out << "_eof_trans:\n";
+
+		if ( redFsm->anyRegCurStateRef() )
+			out << "	_ps = " << vCS() << ";\n";
+
+		out <<
+			"	" << vCS() << " = " << TT() << "[_trans];\n"
+			"\n";
+
+		if ( redFsm->anyRegActions() ) {
+			out <<
+				"	if ( " << TA() << "[_trans] == 0 )\n"
+				"		goto _again;\n"
+				"\n"
+				"	_acts = " << ARR_OFF( A(), TA() + "[_trans]" ) << ";\n"
+				"	goto execFuncs;\n"
+				"\n";
+		}
+		else {
+			out << 
+				"	goto _again;\n"
+				"\n";
+		}
+	}
+
+	STATE_GOTOS() <<
+		"\n";
+	TRANSITIONS() <<
+		"\n";
+
+	if ( redFsm->anyRegActions() )
+		EXEC_FUNCS() << "\n";
+
+	out << "_again:\n";
+
+	if ( redFsm->anyToStateActions() ) {
+		out <<
+			"	_acts = " << ARR_OFF( A(),  TSA() + "[" + vCS() + "]" ) << ";\n"
+			"	while ( *_acts != " << ACTS_END() << " ) {\n"
+			"		switch ( *_acts++ ) {\n";
+			TO_STATE_ACTION_SWITCH();
+			SWITCH_DEFAULT() <<
+			"		}\n"
+			"	}\n"
+			"\n";
+	}
+
+	if ( redFsm->errState != 0 ) {
+		outLabelUsed = true;
+		out << 
+			"	if ( " << vCS() << " == " << redFsm->errState->id << " )\n"
+			"		goto _out;\n";
+	}
+
+	if ( !noEnd ) {
+		out << 
+			"	if ( ++" << P() << " != " << PE() << " )\n"
+			"		goto _resume;\n";
+	}
+	else {
+		out << 
+			"	" << P() << " += 1;\n"
+			"	goto _resume;\n";
+	}
+
+	if ( testEofUsed )
+		out << "	_test_eof: {}\n";
+
+	if ( redFsm->anyEofTrans() || redFsm->anyEofActions() ) {
+		out << 
+			"	if ( " << P() << " == " << vEOF() << " )\n"
+			"	{\n";
+
+		if ( redFsm->anyEofTrans() ) {
+			out <<
+				"	if ( " << ET() << "[" << vCS() << "] > 0 ) {\n"
+				"		_trans = " << ET() << "[" << vCS() << "] - 1;\n"
+				"		goto _eof_trans;\n"
+				"	}\n";
+		}
+
+		if ( redFsm->anyEofActions() ) {
+			out <<
+				"	" << PTR_CONST() << ARRAY_TYPE(redFsm->maxActArrItem) << PTR_CONST_END() << 
+						POINTER() << "__acts = " << 
+						ARR_OFF( A(), EA() + "[" + vCS() + "]" ) << ";\n"
+				"	while ( *__acts != " << ACTS_END() << " ) {\n"
+				"		switch ( *__acts++ ) {\n";
+				EOF_ACTION_SWITCH();
+				SWITCH_DEFAULT() <<
+				"		}\n"
+				"	}\n";
+		}
+
+		out <<
+			"	}\n"
+			"\n";
+	}
+
+	if ( outLabelUsed )
+		out << "	_out: {}\n";
+
+	out << "	}\n";
+
+	delete[] transUsed;
+	delete[] actListUsed;
+	transUsed = actListUsed = 0;
+}
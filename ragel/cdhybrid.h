@@ -0,0 +1,104 @@
+/*
+ *  Copyright 2026 agent <agent@local>
+ */
+
+/*  This file is part of Ragel.
+ *
+ *  Ragel is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  Ragel is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with Ragel; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#ifndef _CDHYBRID_H
+#define _CDHYBRID_H
+
+#include <iostream>
+#include "cdflat.h"
+
+/* Forwards. */
+struct CodeGenData;
+struct RedTransAp;
+struct RedStateAp;
+
+/*
+ * HybridCodeGen
+ *
+ * Flat tables for most states, goto code for the states picked by
+ * RedFsmAp::chooseGotoStates. A goto state jumps to a label for each of its
+ * transitions, which sets the target and runs the actions through the same
+ * action switch as the table path. Goto states have no row in the tables.
+ */
+class HybridCodeGen : public FlatCodeGen
+{
+public:
+	HybridCodeGen( const CodeGenArgs &args ) : FsmCodeGen(args), FlatCodeGen(args),
+		transUsed(0), actListUsed(0), directJumps(false) {}
+	virtual ~HybridCodeGen() { }
+
+protected:
+	std::ostream &INDICIES();
+	std::ostream &FLAT_INDEX_OFFSET();
+	std::ostream &KEY_SPANS();
+
+	bool anyTableStates();
+	std::ostream &TRANS_GOTO( RedTransAp *trans, int level );
+	void emitSingleSwitch( RedStateAp *state );
+	void emitRangeBSearch( RedStateAp *state, int level, int low, int high );
+
+	std::ostream &STATE_GOTOS();
+	std::ostream &TRANSITIONS();
+	std::ostream &EXEC_FUNCS();
+
+	virtual void writeData();
+	virtual void writeExec();
+
+	/* Transitions and action lists reached from goto code, by id. */
+	bool *transUsed;
+	bool *actListUsed;
+
+	/* Transitions without actions can jump straight to a goto state when
+	 * nothing has to run between states. */
+	bool directJumps;
+};
+
+/*
+ * CHybridCodeGen
+ */
+struct CHybridCodeGen
+	: public HybridCodeGen, public CCodeGen
+{
+	CHybridCodeGen( const CodeGenArgs &args ) :
+		FsmCodeGen(args), HybridCodeGen(args), CCodeGen(args) {}
+};
+
+/*
+ * DHybridCodeGen
+ */
+struct DHybridCodeGen
+	: public HybridCodeGen, public DCodeGen
+{
+	DHybridCodeGen( const CodeGenArgs &args ) :
+		FsmCodeGen(args), HybridCodeGen(args), DCodeGen(args) {}
+};
+
+/*
+ * D2HybridCodeGen
+ */
+struct D2HybridCodeGen
+	: public HybridCodeGen, public D2CodeGen
+{
+	D2HybridCodeGen( const CodeGenArgs &args ) :
+		FsmCodeGen(args), HybridCodeGen(args), D2CodeGen(args) {}
+};
+
+#endif
@@ -0,0 +1,472 @@
+/*
+ *  Copyright 2026 agent <agent@local>
+ */
+
+/*  This file is part of Ragel.
+ *
+ *  Ragel is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  Ragel is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with Ragel; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#include "ragel.h"
+#include "cdlazy.h"
+#include "parsedata.h"
+#include "gendata.h"
+#include <string.h>
+
+using std::endl;
+
+void LazyCodeGen::finishRagelDef()
+{
+	Vector<FsmAp*> &comps = pd->lazyComps;
+
+	/* Number the component states consecutively and find the points where
+	 * any transition range starts or ends. These split the alphabet into
+	 * the character classes of the DFA states. */
+	numStates = 0;
+	numTrans = 0;
+	classKeys.empty();
+	classKeys.insert( keyOps->minKey );
+	for ( int c = 0; c < comps.length(); c++ ) {
+		comps[c]->setStateNumbers( numStates + 1 );
+		numStates += comps[c]->stateList.length();
+
+		for ( StateList::Iter st = comps[c]->stateList; st.lte(); st++ ) {
+			for ( TransList::Iter trans = st->outList; trans.lte(); trans++ ) {
+				if ( trans->ctList.head->toState != 0 ) {
+					numTrans += 1;
+					classKeys.insert( trans->lowKey );
+					if ( trans->highKey < keyOps->maxKey ) {
+						Key next = trans->highKey;
+						next.increment();
+						classKeys.insert( next );
+					}
+				}
+			}
+		}
+	}
+
+	directClasses = keyOps->span( keyOps->minKey, keyOps->maxKey ) <= 256;
+
+	exprDepth = 0;
+	int depth = 0;
+	for ( Vector<int>::Iter op = pd->lazyExpr; op.lte(); op++ ) {
+		depth += *op >= 0 ? 1 : -1;
+		if ( depth > exprDepth )
+			exprDepth = depth;
+	}
+}
+
+void LazyCodeGen::writeStatement( InputLoc &loc, int nargs, char **args )
+{
+	/* There are no state ids to give out. */
+	if ( strcmp( args[0], "data" ) != 0 && strcmp( args[0], "init" ) != 0 &&
+			strcmp( args[0], "exec" ) != 0 )
+	{
+		source_error(loc) << "write " << args[0] << 
+				" is not available in lazy DFA mode" << endl;
+	}
+	else {
+		CodeGenData::writeStatement( loc, nargs, args );
+	}
+}
+
+std::ostream &LazyCodeGen::ARRAY_ITEMS( const Vector<long> &items )
+{
+	out << '\t';
+	for ( int i = 0; i < items.length(); i++ ) {
+		out << items[i];
+		if ( i < items.length() - 1 ) {
+			out << ", ";
+			if ( (i+1) % IALL == 0 )
+				out << "\n\t";
+		}
+	}
+
+	/* C does not allow empty arrays. */
+	if ( items.length() == 0 )
+		out << 0;
+	out << '\n';
+	return out;
+}
+
+std::ostream &LazyCodeGen::TRANS_KEYS()
+{
+	Vector<FsmAp*> &comps = pd->lazyComps;
+
+	out << '\t';
+	int totalTrans = 0;
+	for ( int c = 0; c < comps.length(); c++ ) {
+		for ( StateList::Iter st = comps[c]->stateList; st.lte(); st++ ) {
+			for ( TransList::Iter trans = st->outList; trans.lte(); trans++ ) {
+				if ( trans->ctList.head->toState != 0 ) {
+					out << KEY( trans->lowKey ) << ", " << 
+							KEY( trans->highKey ) << ", ";
+					if ( ++totalTrans % IALL == 0 )
+						out << "\n\t";
+				}
+			}
+		}
+	}
+
+	/* Output one last number so we don't have to figure out when the last
+	 * entry is and avoid writing a comma. */
+	out << 0 << "\n";
+	return out;
+}
+
+/* Expression for the character class of a key. */
+string LazyCodeGen::CLASS( string key )
+{
+	if ( directClasses )
+		return LCL() + "[(int)" + key + " - (" + KEY( keyOps->minKey ) + ")]";
+	return LF( "class" ) + "( " + key + " )";
+}
+
+void LazyCodeGen::writeData()
+{
+	Vector<FsmAp*> &comps = pd->lazyComps;
+	Vector<long> items;
+
+	for ( int c = 0; c < comps.length(); c++ )
+		items.append( comps[c]->startState->alg.stateNum );
+
+	OPEN_ARRAY( ARRAY_TYPE(numStates), LS() );
+	ARRAY_ITEMS( items );
+	CLOSE_ARRAY() <<
+	"\n";
+
+	/* The dead state has no transitions. */
+	items.empty();
+	items.append( 0 );
+	long offset = 0;
+	for ( int c = 0; c < comps.length(); c++ ) {
+		for ( StateList::Iter st = comps[c]->stateList; st.lte(); st++ ) {
+			items.append( offset );
+			for ( TransList::Iter trans = st->outList; trans.lte(); trans++ ) {
+				if ( trans->ctList.head->toState != 0 )
+					offset += 1;
+			}
+		}
+	}
+	items.append( offset );
+
+	OPEN_ARRAY( ARRAY_TYPE(numTrans), LKO() );
+	ARRAY_ITEMS( items );
+	CLOSE_ARRAY() <<
+	"\n";
+
+	OPEN_ARRAY( ALPH_TYPE(), LK() );
+	TRANS_KEYS();
+	CLOSE_ARRAY() <<
+	"\n";
+
+	items.empty();
+	for ( int c = 0; c < comps.length(); c++ ) {
+		for ( StateList::Iter st = comps[c]->stateList; st.lte(); st++ ) {
+			for ( TransList::Iter trans = st->outList; trans.lte(); trans++ ) {
+				if ( trans->ctList.head->toState != 0 )
+					items.append( trans->ctList.head->toState->alg.stateNum );
+			}
+		}
+	}
+
+	OPEN_ARRAY( ARRAY_TYPE(numStates), LT() );
+	ARRAY_ITEMS( items );
+	CLOSE_ARRAY() <<
+	"\n";
+
+	items.empty();
+	items.append( 0 );
+	for ( int c = 0; c < comps.length(); c++ ) {
+		for ( StateList::Iter st = comps[c]->stateList; st.lte(); st++ )
+			items.append( st->isFinState() ? 1 : 0 );
+	}
+
+	OPEN_ARRAY( ARRAY_TYPE(1), LFIN() );
+	ARRAY_ITEMS( items );
+	CLOSE_ARRAY() <<
+	"\n";
+
+	/* Component indicies and operators, in postfix. */
+	items.empty();
+	for ( Vector<int>::Iter op = pd->lazyExpr; op.lte(); op++ )
+		items.append( *op );
+
+	OPEN_ARRAY( "int", LEX() );
+	ARRAY_ITEMS( items );
+	CLOSE_ARRAY() <<
+	"\n";
+
+	items.empty();
+	if ( directClasses ) {
+		/* Map every key to its class. */
+		unsigned long long span = keyOps->span( keyOps->minKey, keyOps->maxKey );
+		KeySet::Iter ck = classKeys;
+		Key key = keyOps->minKey;
+		long cls = -1;
+		for ( unsigned long long pos = 0; pos < span; pos++ ) {
+			if ( ck.lte() && *ck == key ) {
+				cls += 1;
+				ck++;
+			}
+			items.append( cls );
+			key.increment();
+		}
+
+		OPEN_ARRAY( ARRAY_TYPE(classKeys.length()), LCL() );
+		ARRAY_ITEMS( items );
+		CLOSE_ARRAY() <<
+		"\n";
+	}
+	else {
+		/* The lowest key of each class, searched at runtime. */
+		OPEN_ARRAY( ALPH_TYPE(), LCL() );
+		out << '\t';
+		for ( KeySet::Iter ck = classKeys; ck.lte(); ck++ ) {
+			out << KEY( *ck );
+			if ( !ck.last() ) {
+				out << ", ";
+				if ( (ck.pos()+1) % IALL == 0 )
+					out << "\n\t";
+			}
+		}
+		out << "\n";
+		CLOSE_ARRAY() <<
+		"\n";
+	}
+
+	RUNTIME();
+}
+
+/* The runtime. A DFA state is a tuple of component states. Transitions out
+ * of it are made on the first visit and stored by character class. A stored
+ * transition records the generation of its target, so a target that has been
+ * reclaimed is noticed and rebuilt. */
+void LazyCodeGen::RUNTIME()
+{
+	long numComps = pd->lazyComps.length();
+	long numClasses = classKeys.length();
+	long numBuckets = lazyDfaStates * 2;
+
+	out <<
+		"struct " << LZ() << "_state\n"
+		"{\n"
+		"	int tuple[" << numComps << "];\n"
+		"	int next[" << numClasses << "];\n"
+		"	unsigned int next_gen[" << numClasses << "];\n"
+		"	unsigned int gen;\n"
+		"	int hash_next;\n"
+		"	char ref;\n"
+		"	char accept;\n"
+		"};\n"
+		"\n"
+		"struct " << LZ() << "\n"
+		"{\n"
+		"	struct " << LZ() << "_state states[" << lazyDfaStates << "];\n"
+		"	int buckets[" << numBuckets << "];\n"
+		"	int used;\n"
+		"	int hand;\n"
+		"	int cur;\n"
+		"	int accept;\n"
+		"};\n"
+		"\n";
+
+	/* Evaluates the component expression. When live is set, whether the
+	 * expression can still become true. */
+	out <<
+		"static int " << LF( "eval" ) << "( const int *tuple, int live )\n"
+		"{\n"
+		"	int stack[" << exprDepth << "], top = 0, i, op;\n"
+		"	for ( i = 0; i < " << pd->lazyExpr.length() << "; i++ ) {\n"
+		"		op = " << LEX() << "[i];\n"
+		"		if ( op >= 0 )\n"
+		"			stack[top++] = tuple[op] != 0 && ( live || " << LFIN() << "[tuple[op]] );\n"
+		"		else {\n"
+		"			top -= 1;\n"
+		"			if ( op == " << LazyOr << " )\n"
+		"				stack[top-1] = stack[top-1] || stack[top];\n"
+		"			else if ( op == " << LazyAnd << " )\n"
+		"				stack[top-1] = stack[top-1] && stack[top];\n"
+		"			else\n"
+		"				stack[top-1] = stack[top-1] && ( live || !stack[top] );\n"
+		"		}\n"
+		"	}\n"
+		"	return stack[0];\n"
+		"}\n"
+		"\n";
+
+	out <<
+		"static unsigned int " << LF( "hash" ) << "( const int *tuple )\n"
+		"{\n"
+		"	unsigned int h = 0;\n"
+		"	int i;\n"
+		"	for ( i = 0; i < " << numComps << "; i++ )\n"
+		"		h = h * 31 + (unsigned int) tuple[i];\n"
+		"	return h % " << numBuckets << ";\n"
+		"}\n"
+		"\n";
+
+	/* Finds the DFA state for a tuple, making it if needed. A full cache
+	 * gives up a state that has not been used since the clock hand last
+	 * passed, other than the one being kept. */
+	out <<
+		"static int " << LF( "find" ) << "( struct " << LZ() << " *lz, const int *tuple, int keep )\n"
+		"{\n"
+		"	unsigned int h = " << LF( "hash" ) << "( tuple );\n"
+		"	int s, i, *link;\n"
+		"\n"
+		"	for ( s = lz->buckets[h]; s >= 0; s = lz->states[s].hash_next ) {\n"
+		"		for ( i = 0; i < " << numComps << " && lz->states[s].tuple[i] == tuple[i]; i++ ) {}\n"
+		"		if ( i == " << numComps << " )\n"
+		"			return s;\n"
+		"	}\n"
+		"\n"
+		"	if ( lz->used < " << lazyDfaStates << " )\n"
+		"		s = lz->used++;\n"
+		"	else {\n"
+		"		while ( 1 ) {\n"
+		"			s = lz->hand;\n"
+		"			lz->hand = ( lz->hand + 1 ) % " << lazyDfaStates << ";\n"
+		"			if ( s != keep ) {\n"
+		"				if ( !lz->states[s].ref )\n"
+		"					break;\n"
+		"				lz->states[s].ref = 0;\n"
+		"			}\n"
+		"		}\n"
+		"\n"
+		"		link = &lz->buckets[" << LF( "hash" ) << "( lz->states[s].tuple )];\n"
+		"		while ( *link != s )\n"
+		"			link = &lz->states[*link].hash_next;\n"
+		"		*link = lz->states[s].hash_next;\n"
+		"	}\n"
+		"\n"
+		"	for ( i = 0; i < " << numComps << "; i++ )\n"
+		"		lz->states[s].tuple[i] = tuple[i];\n"
+		"	for ( i = 0; i < " << numClasses << "; i++ )\n"
+		"		lz->states[s].next[i] = 0;\n"
+		"	lz->states[s].gen += 1;\n"
+		"	lz->states[s].ref = 1;\n"
+		"	lz->states[s].accept = " << LF( "eval" ) << "( tuple, 0 );\n"
+		"	lz->states[s].hash_next = lz->buckets[h];\n"
+		"	lz->buckets[h] = s;\n"
+		"	return s;\n"
+		"}\n"
+		"\n";
+
+	/* Makes the transition out of the current state on a character. Returns
+	 * -1 when the expression can no longer be satisfied. */
+	out <<
+		"static int " << LF( "next" ) << "( struct " << LZ() << " *lz, int cls, " << 
+				ALPH_TYPE() << " c )\n"
+		"{\n"
+		"	int tuple[" << numComps << "], i, s, lo, hi, mid;\n"
+		"\n"
+		"	for ( i = 0; i < " << numComps << "; i++ ) {\n"
+		"		s = lz->states[lz->cur].tuple[i];\n"
+		"		tuple[i] = 0;\n"
+		"		lo = " << LKO() << "[s];\n"
+		"		hi = " << LKO() << "[s+1] - 1;\n"
+		"		while ( lo <= hi ) {\n"
+		"			mid = ( lo + hi ) >> 1;\n"
+		"			if ( c < " << LK() << "[mid<<1] )\n"
+		"				hi = mid - 1;\n"
+		"			else if ( c > " << LK() << "[(mid<<1)+1] )\n"
+		"				lo = mid + 1;\n"
+		"			else {\n"
+		"				tuple[i] = " << LT() << "[mid];\n"
+		"				break;\n"
+		"			}\n"
+		"		}\n"
+		"	}\n"
+		"\n"
+		"	if ( !" << LF( "eval" ) << "( tuple, 1 ) ) {\n"
+		"		lz->states[lz->cur].next[cls] = -1;\n"
+		"		return -1;\n"
+		"	}\n"
+		"\n"
+		"	s = " << LF( "find" ) << "( lz, tuple, lz->cur );\n"
+		"	lz->states[lz->cur].next[cls] = s + 1;\n"
+		"	lz->states[lz->cur].next_gen[cls] = lz->states[s].gen;\n"
+		"	return s;\n"
+		"}\n"
+		"\n";
+
+	if ( !directClasses ) {
+		out <<
+			"static int " << LF( "class" ) << "( " << ALPH_TYPE() << " c )\n"
+			"{\n"
+			"	int lo = 0, hi = " << numClasses - 1 << ", mid;\n"
+			"	while ( lo < hi ) {\n"
+			"		mid = ( lo + hi + 1 ) >> 1;\n"
+			"		if ( c < " << LCL() << "[mid] )\n"
+			"			hi = mid - 1;\n"
+			"		else\n"
+			"			lo = mid;\n"
+			"	}\n"
+			"	return lo;\n"
+			"}\n"
+			"\n";
+	}
+
+	out <<
+		"static void " << LF( "init" ) << "( struct " << LZ() << " *lz )\n"
+		"{\n"
+		"	int tuple[" << numComps << "], i;\n"
+		"	for ( i = 0; i < " << numComps << "; i++ )\n"
+		"		tuple[i] = " << LS() << "[i];\n"
+		"	for ( i = 0; i < " << numBuckets << "; i++ )\n"
+		"		lz->buckets[i] = -1;\n"
+		"	for ( i = 0; i < " << lazyDfaStates << "; i++ )\n"
+		"		lz->states[i].gen = 0;\n"
+		"	lz->used = 0;\n"
+		"	lz->hand = 0;\n"
+		"	lz->cur = " << LF( "find" ) << "( lz, tuple, -1 );\n"
+		"	lz->accept = lz->states[lz->cur].accept;\n"
+		"}\n"
+		"\n";
+}
+
+void LazyCodeGen::writeInit()
+{
+	if ( !noCS )
+		out << "	" << LF( "init" ) << "( &" << vCS() << " );\n";
+}
+
+void LazyCodeGen::writeExec()
+{
+	string cs = vCS();
+	out << 
+		"	{\n"
+		"	int _cls, _next;\n"
+		"	while ( " << P() << " != " << PE() << " && " << cs << ".cur >= 0 ) {\n"
+		"		_cls = " << CLASS( GET_KEY() ) << ";\n"
+		"		_next = " << cs << ".states[" << cs << ".cur].next[_cls];\n"
+		"		if ( _next > 0 && " << cs << ".states[_next-1].gen != \n"
+		"				" << cs << ".states[" << cs << ".cur].next_gen[_cls] )\n"
+		"			_next = 0;\n"
+		"		if ( _next == 0 )\n"
+		"			_next = " << LF( "next" ) << "( &" << cs << ", _cls, " << GET_KEY() << " ) + 1;\n"
+		"		if ( _next <= 0 ) {\n"
+		"			" << cs << ".cur = -1;\n"
+		"			break;\n"
+		"		}\n"
+		"		" << cs << ".cur = _next - 1;\n"
+		"		" << cs << ".states[" << cs << ".cur].ref = 1;\n"
+		"		" << P() << " += 1;\n"
+		"	}\n"
+		"	" << cs << ".accept = " << cs << ".cur >= 0 && " << 
+				cs << ".states[" << cs << ".cur].accept;\n"
+		"	}\n";
+}
@@ -0,0 +1,103 @@
+/*
+ *  Copyright 2026 agent <agent@local>
+ */
+
+/*  This file is part of Ragel.
+ *
+ *  Ragel is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  Ragel is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with Ragel; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#ifndef _CDLAZY_H
+#define _CDLAZY_H
+
+#include <iostream>
+#include "cdcodegen.h"
+#include "fsmgraph.h"
+
+/* Forwards. */
+struct CodeGenData;
+
+/*
+ * LazyCodeGen
+ *
+ * Writes the components of a machine built in lazy DFA mode along with a
+ * runtime that determinizes them on demand. DFA states are kept in a bounded
+ * cache and reclaimed with the clock algorithm.
+ */
+class LazyCodeGen : virtual public FsmCodeGen
+{
+public:
+	LazyCodeGen( const CodeGenArgs &args ) : FsmCodeGen(args) {}
+	virtual ~LazyCodeGen() { }
+
+	virtual void finishRagelDef();
+	virtual void writeStatement( InputLoc &loc, int nargs, char **args );
+	virtual void writeData();
+	virtual void writeInit();
+	virtual void writeExec();
+
+protected:
+	string LZ() { return FSM_NAME() + "_lazy"; }
+	string LF( string name ) { return "_" + FSM_NAME() + "_lazy_" + name; }
+	string LS() { return "_" + DATA_PREFIX() + "lazy_start"; }
+	string LKO() { return "_" + DATA_PREFIX() + "lazy_key_offsets"; }
+	string LK() { return "_" + DATA_PREFIX() + "lazy_trans_keys"; }
+	string LT() { return "_" + DATA_PREFIX() + "lazy_trans_targs"; }
+	string LFIN() { return "_" + DATA_PREFIX() + "lazy_final"; }
+	string LEX() { return "_" + DATA_PREFIX() + "lazy_expr"; }
+	string LCL() { return "_" + DATA_PREFIX() + "lazy_classes"; }
+
+	std::ostream &ARRAY_ITEMS( const Vector<long> &items );
+	std::ostream &TRANS_KEYS();
+	void RUNTIME();
+	string CLASS( string key );
+
+	/* There are no actions in lazy mode. */
+	void GOTO( ostream &, int, bool ) {}
+	void CALL( ostream &, int, int, bool ) {}
+	void NEXT( ostream &, int, bool ) {}
+	void GOTO_EXPR( ostream &, GenInlineItem *, bool ) {}
+	void NEXT_EXPR( ostream &, GenInlineItem *, bool ) {}
+	void CALL_EXPR( ostream &, GenInlineItem *, int, bool ) {}
+	void RET( ostream &, bool ) {}
+	void BREAK( ostream &, int, bool ) {}
+	void CURS( ostream &, bool ) {}
+	void TARGS( ostream &, bool, int ) {}
+
+	/* Component states are numbered from one. Zero is the dead state. */
+	long numStates;
+	long numTrans;
+
+	/* Lowest key of each character class. */
+	KeySet classKeys;
+
+	/* Classes are looked up directly, rather than searched for. */
+	bool directClasses;
+
+	/* Stack depth needed to evaluate the component expression. */
+	int exprDepth;
+};
+
+/*
+ * CLazyCodeGen
+ */
+struct CLazyCodeGen
+	: public LazyCodeGen, public CCodeGen
+{
+	CLazyCodeGen( const CodeGenArgs &args ) : 
+		FsmCodeGen(args), LazyCodeGen(args), CCodeGen(args) {}
+};
+
+#endif
@@ -321,6 +321,11 @@ void SplitCodeGen::writeData()
 			"\n";
 	}
 
+	if ( numRepCounters > 0 ) {
+		out <<
+			"static const int " << DATA_PREFIX() << "num_counters = " << numRepCounters << ";\n"
+			"\n";
+	}
 
 	OPEN_ARRAY( ARRAY_TYPE(numSplitPartitions), PM() );
 	PART_MAP();
@@ -357,7 +362,7 @@ std::ostream &SplitCodeGen::ALL_PARTITIONS()
 		partFilter->open( fn, ios::out|ios::trunc );
 		if ( !partFilter->is_open() ) {
 			error() << "error opening " << fn << " for writing" << endl;
-			exit(1);
+			exitCompile(1);
 		}
 
 		/* Attach the new file to the output stream. */
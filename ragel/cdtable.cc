@@ -50,8 +50,9 @@ void TabCodeGen::calcIndexSize()
 			sizeWithoutInds += arrayTypeSize(redFsm->maxActionLoc) * totalIndex;
 	}
 
-	/* If using indicies reduces the size, use them. */
-	useIndicies = sizeWithInds < sizeWithoutInds;
+	/* If using indicies reduces the size, use them. The counters are indexed
+	 * by transition id, which _trans only holds when indicies are used. */
+	useIndicies = instrument || sizeWithInds < sizeWithoutInds;
 }
 
 std::ostream &TabCodeGen::TO_STATE_ACTION( RedStateAp *state )
@@ -867,6 +868,9 @@ void TabCodeGen::writeData()
 	}
 
 	STATE_IDS();
+
+	if ( instrument )
+		COUNTERS_DATA();
 }
 
 void TabCodeGen::COND_TRANSLATE()
@@ -946,8 +950,7 @@ void TabCodeGen::writeExec()
 	{
 		out << 
 			"	" << PTR_CONST() << ARRAY_TYPE(redFsm->maxActArrItem) << PTR_CONST_END() << 
-					POINTER() << "_acts;\n"
-			"	" << UINT() << " _nacts;\n";
+					POINTER() << "_acts;\n";
 	}
 
 	out <<
@@ -970,11 +973,13 @@ void TabCodeGen::writeExec()
 
 	out << "_resume:\n";
 
+	if ( instrument )
+		COUNT_STATE();
+
 	if ( redFsm->anyFromStateActions() ) {
 		out <<
 			"	_acts = " << ARR_OFF( A(),  FSA() + "[" + vCS() + "]" ) << ";\n"
-			"	_nacts = " << CAST(UINT()) << " *_acts++;\n"
-			"	while ( _nacts-- > 0 ) {\n"
+			"	while ( *_acts != " << ACTS_END() << " ) {\n"
 			"		switch ( *_acts++ ) {\n";
 			FROM_STATE_ACTION_SWITCH();
 			SWITCH_DEFAULT() <<
@@ -999,6 +1004,9 @@ void TabCodeGen::writeExec()
 	if ( redFsm->anyRegCurStateRef() )
 		out << "	_ps = " << vCS() << ";\n";
 
+	if ( instrument )
+		COUNT_TRANS();
+
 	out <<
 		"	" << vCS() << " = " << TT() << "[_trans];\n"
 		"\n";
@@ -1009,8 +1017,7 @@ void TabCodeGen::writeExec()
 			"		goto _again;\n"
 			"\n"
 			"	_acts = " << ARR_OFF( A(), TA() + "[_trans]" ) << ";\n"
-			"	_nacts = " << CAST(UINT()) << " *_acts++;\n"
-			"	while ( _nacts-- > 0 )\n	{\n"
+			"	while ( *_acts != " << ACTS_END() << " )\n	{\n"
 			"		switch ( *_acts++ )\n		{\n";
 			ACTION_SWITCH();
 			SWITCH_DEFAULT() <<
@@ -1026,8 +1033,7 @@ void TabCodeGen::writeExec()
 	if ( redFsm->anyToStateActions() ) {
 		out <<
 			"	_acts = " << ARR_OFF( A(), TSA() + "[" + vCS() + "]" ) << ";\n"
-			"	_nacts = " << CAST(UINT()) << " *_acts++;\n"
-			"	while ( _nacts-- > 0 ) {\n"
+			"	while ( *_acts != " << ACTS_END() << " ) {\n"
 			"		switch ( *_acts++ ) {\n";
 			TO_STATE_ACTION_SWITCH();
 			SWITCH_DEFAULT() <<
@@ -1075,8 +1081,7 @@ void TabCodeGen::writeExec()
 				"	" << PTR_CONST() << ARRAY_TYPE(redFsm->maxActArrItem) << PTR_CONST_END() << 
 						POINTER() << "__acts = " << 
 						ARR_OFF( A(), EA() + "[" + vCS() + "]" ) << ";\n"
-				"	" << UINT() << " __nacts = " << CAST(UINT()) << " *__acts++;\n"
-				"	while ( __nacts-- > 0 ) {\n"
+				"	while ( *__acts != " << ACTS_END() << " ) {\n"
 				"		switch ( *__acts++ ) {\n";
 				EOF_ACTION_SWITCH();
 				SWITCH_DEFAULT() <<
@@ -314,9 +314,25 @@ std::streamsize output_filter::xsputn( const char *s, std::streamsize n )
 		if ( s[i] == '\n' )
 			line += 1;
 	}
+	if ( buffer != 0 ) {
+		buffer->append( s, n );
+		return n;
+	}
 	return std::filebuf::xsputn( s, n );
 }
 
+/* Single characters arrive here when writing to a string, since there is no
+ * file buffer to put them in. */
+int output_filter::overflow( int c )
+{
+	if ( buffer == 0 )
+		return std::filebuf::overflow( c );
+
+	if ( c != EOF )
+		buffer->push_back( c );
+	return 0;
+}
+
 /* Scans a string looking for the file extension. If there is a file
  * extension then pointer returned points to inside the string
  * passed in. Otherwise returns null. */
@@ -375,5 +391,14 @@ exit_object endp;
 void operator<<( std::ostream &out, exit_object & )
 {
     out << std::endl;
-    exit(1);
+    exitCompile(1);
+}
+
+bool compileExitThrows = false;
+
+void exitCompile( int status )
+{
+	if ( compileExitThrows )
+		throw CompileExit( status );
+	exit( status );
 }
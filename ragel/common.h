@@ -23,6 +23,7 @@
 #define _COMMON_H
 
 #include <fstream>
+#include <string>
 #include <climits>
 #include "dlist.h"
 
@@ -308,13 +309,18 @@ inline Key operator/(const Key key1, const Key key2)
 class output_filter : public std::filebuf
 {
 public:
-	output_filter( const char *fileName ) : fileName(fileName), line(1) { }
+	output_filter( const char *fileName, std::string *buffer = 0 )
+		: fileName(fileName), line(1), buffer(buffer) { }
 
 	virtual int sync();
 	virtual std::streamsize xsputn(const char* s, std::streamsize n);
+	virtual int overflow( int c );
 
 	const char *fileName;
 	int line;
+
+	/* If set, output is appended to the string and no file is opened. */
+	std::string *buffer;
 };
 
 class cfilebuf : public std::streambuf
@@ -380,4 +386,16 @@ struct exit_object { };
 extern exit_object endp;
 void operator<<( std::ostream &out, exit_object & );
 
+/* Thrown in place of exiting the process when the compiler is embedded. */
+struct CompileExit
+{
+	CompileExit( int status ) : status(status) {}
+	int status;
+};
+
+/* Ends the compilation with an exit status. The ragel program exits, an
+ * embedded compiler throws a CompileExit. */
+extern bool compileExitThrows;
+void exitCompile( int status );
+
 #endif
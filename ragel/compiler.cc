@@ -0,0 +1,130 @@
+/*
+ *  Copyright 2026 agent <agent@local>
+ */
+
+/*  This file is part of Ragel.
+ *
+ *  Ragel is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  Ragel is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with Ragel; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#include <iostream>
+#include <sstream>
+
+#include "compiler.h"
+#include "ragel.h"
+#include "inputdata.h"
+#include "parsedata.h"
+#include "rlparse.h"
+#include "profile.h"
+
+#ifdef HAVE_LIBPTHREAD
+#include <pthread.h>
+#endif
+
+using std::cout;
+using std::cerr;
+using std::string;
+using std::vector;
+
+#ifdef HAVE_LIBPTHREAD
+/* The options and the machine state are globals, so compilations started
+ * from several threads take turns. */
+static pthread_mutex_t compileMutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/* Sends cerr and cout to a buffer and makes exits throw for the length of a
+ * compilation. Both are put back however the compilation ends. */
+struct CompileScope
+{
+	CompileScope( std::streambuf *diagnostics )
+	{
+#ifdef HAVE_LIBPTHREAD
+		pthread_mutex_lock( &compileMutex );
+#endif
+		cerrBuf = cerr.rdbuf( diagnostics );
+		coutBuf = cout.rdbuf( diagnostics );
+		compileExitThrows = true;
+	}
+
+	~CompileScope()
+	{
+		compileExitThrows = false;
+		cerr.rdbuf( cerrBuf );
+		cout.rdbuf( coutBuf );
+#ifdef HAVE_LIBPTHREAD
+		pthread_mutex_unlock( &compileMutex );
+#endif
+	}
+
+	std::streambuf *cerrBuf;
+	std::streambuf *coutBuf;
+};
+
+bool RagelCompiler::compile( const string &fileName, const string &source,
+		const vector<string> &options )
+{
+	outputText.clear();
+	diagnosticText.clear();
+
+	/* The arguments as the ragel program would get them. */
+	ArgsVector args;
+	args.append( PROGNAME );
+	for ( vector<string>::const_iterator o = options.begin(); o != options.end(); o++ )
+		args.append( o->c_str() );
+	args.append( fileName.c_str() );
+
+	/* Errors and warnings go to cerr, usage and version to cout. Collect them
+	 * both. */
+	std::ostringstream diagnostics;
+	int status = 0;
+	{
+		CompileScope scope( diagnostics.rdbuf() );
+		resetOptions();
+
+		std::istringstream input( source );
+		InputData id;
+		id.inStream = &input;
+		id.outString = &outputText;
+
+		try {
+			id.parseArgs( args.length(), args.data );
+			id.checkArgs();
+			id.process();
+			writeProfile();
+		}
+		catch ( const CompileExit &ce ) {
+			status = ce.status;
+		}
+
+		/* Does nothing if process() got to the end. */
+		id.closeOutput();
+
+		/* The ragel program leaves the parse data to the end of the process.
+		 * Here it goes with the compilation. The parsers are deleted with the
+		 * input data. */
+		for ( ParserList::Iter parser = id.parserList; parser.lte(); parser++ )
+			delete parser->pd;
+
+		errors = gblErrorCount;
+	}
+
+	diagnosticText = diagnostics.str();
+
+	if ( status != 0 || errors > 0 ) {
+		outputText.clear();
+		return false;
+	}
+	return true;
+}
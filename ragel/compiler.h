@@ -0,0 +1,66 @@
+/*
+ *  Copyright 2026 agent <agent@local>
+ */
+
+/*  This file is part of Ragel.
+ *
+ *  Ragel is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  Ragel is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with Ragel; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#ifndef _COMPILER_H
+#define _COMPILER_H
+
+#include <string>
+#include <vector>
+
+/*
+ * RagelCompiler
+ *
+ * Runs ragel inside the calling program. The source text and the options are
+ * given in memory and the generated code and the diagnostics come back in
+ * memory, so a batch of machines can be compiled without starting a process
+ * and reading and writing files for each one. Every compilation starts from
+ * the default options.
+ *
+ * The compiler is not reentrant. Its options and machine state are process
+ * globals that each compilation resets, and cerr and cout of the whole
+ * process are redirected while it runs. Compilations started from several
+ * threads take turns when ragel is built with pthreads. Otherwise only one
+ * may run at a time.
+ */
+class RagelCompiler
+{
+public:
+	RagelCompiler() : errors(0) {}
+
+	/* Compile source text. The file name is used in diagnostics and line
+	 * directives, includes are looked up relative to it. The options are
+	 * those of the ragel program, without the input file. Returns true if
+	 * the compilation succeeded. */
+	bool compile( const std::string &fileName, const std::string &source,
+			const std::vector<std::string> &options );
+
+	/* Results of the last compilation. There is no output when it failed. */
+	const std::string &output() const { return outputText; }
+	const std::string &diagnostics() const { return diagnosticText; }
+	int errorCount() const { return errors; }
+
+private:
+	std::string outputText;
+	std::string diagnosticText;
+	int errors;
+};
+
+#endif
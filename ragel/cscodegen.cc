@@ -112,6 +112,18 @@ string CSharpFsmCodeGen::ARRAY_TYPE( unsigned long maxVal, bool forceSigned )
 	return ret;
 }
 
+/* With --span-tables the item is read through a reference to the static data
+ * so there is no bounds check. */
+string CSharpFsmCodeGen::ARR_REF( string name, string index )
+{
+	if ( spanTables ) {
+		return "System.Runtime.CompilerServices.Unsafe.Add( ref "
+				"System.Runtime.InteropServices.MemoryMarshal.GetReference( " +
+				name + " ), (int)(" + index + ") )";
+	}
+	return name + "[" + index + "]";
+}
+
 /* Write out the fsm name. */
 string CSharpFsmCodeGen::FSM_NAME()
 {
@@ -510,6 +522,11 @@ void CSharpFsmCodeGen::INLINE_LIST( ostream &ret, GenInlineList *inlineList,
 		case GenInlineItem::Break:
 			BREAK( ret, targState );
 			break;
+		case GenInlineItem::RepInit:
+		case GenInlineItem::RepIncr:
+		case GenInlineItem::RepTest:
+			/* Counted repetition is not supported for this language. */
+			break;
 		}
 	}
 }
@@ -702,6 +719,14 @@ string CSharpCodeGen::PTR_CONST()
 
 std::ostream &CSharpCodeGen::OPEN_ARRAY( string type, string name )
 {
+	if ( spanTables ) {
+		arrayType = type;
+		arrayName = name;
+		arrayBuf.str( "" );
+		arraySaved = out.rdbuf( arrayBuf.rdbuf() );
+		return out;
+	}
+
 	out << "static readonly " << type << "[] " << name << " =  ";
 	/*
 	if (type == "char")
@@ -713,7 +738,83 @@ std::ostream &CSharpCodeGen::OPEN_ARRAY( string type, string name )
 
 std::ostream &CSharpCodeGen::CLOSE_ARRAY()
 {
-	return out << "};\n";
+	if ( !spanTables )
+		return out << "};\n";
+
+	out.rdbuf( arraySaved );
+	arraySaved = 0;
+
+	HostType *hostType = 0;
+	for ( int i = 0; i < hostLang->numHostTypes; i++ ) {
+		if ( arrayType == hostLang->hostTypes[i].data1 )
+			hostType = hostLang->hostTypes + i;
+	}
+	assert( hostType != 0 );
+
+	/* Items are written as plain or unsigned integers, or as character
+	 * literals or casts when the alphabet type is char. */
+	Vector<long long> items;
+	string text = arrayBuf.str();
+	const char *p = text.c_str();
+	while ( true ) {
+		while ( *p != 0 && ( *p == ',' || isspace( *p ) ) )
+			p += 1;
+		if ( *p == 0 )
+			break;
+
+		if ( *p == '(' ) {
+			while ( *p != 0 && *p != ')' )
+				p += 1;
+			p += 1;
+			while ( isspace( *p ) )
+				p += 1;
+		}
+
+		char *end;
+		if ( p[0] == '\'' ) {
+			items.append( strtoll( p + 3, &end, 16 ) );
+			end += 1;
+		}
+		else if ( p[0] == '-' )
+			items.append( strtoll( p, &end, 10 ) );
+		else
+			items.append( (long long) strtoull( p, &end, 10 ) );
+
+		assert( end != p );
+		while ( *end == 'u' || *end == 'U' || *end == 'L' )
+			end += 1;
+		p = end;
+	}
+
+	/* Byte sized tables are static data as is. Wider items are stored little
+	 * endian in a byte blob and read through a typed view of it. */
+	string blobName = hostType->size == 1 ? arrayName : arrayName + "_data";
+	string blobType = hostType->size == 1 ? arrayType : "byte";
+
+	out << "static System.ReadOnlySpan<" << blobType << "> " << blobName <<
+			" => new " << blobType << "[] {\n\t";
+	long count = 0;
+	for ( int i = 0; i < items.length(); i++ ) {
+		unsigned long long item = (unsigned long long) items[i];
+		for ( unsigned int b = 0; b < hostType->size; b++ ) {
+			if ( count > 0 )
+				out << ( count % ( IALL * 2 ) == 0 ? ",\n\t" : ", " );
+
+			long long byte = ( item >> ( b * 8 ) ) & 0xff;
+			if ( hostType->size == 1 && hostType->isSigned && byte >= 0x80 )
+				byte -= 0x100;
+			out << byte;
+			count += 1;
+		}
+	}
+	out << "\n};\n";
+
+	if ( hostType->size > 1 ) {
+		out << "static System.ReadOnlySpan<" << arrayType << "> " << arrayName <<
+				" => System.Runtime.InteropServices.MemoryMarshal.Cast<byte, " <<
+				arrayType << ">( " << blobName << " );\n";
+	}
+	return out;
 }
 
 std::ostream &CSharpCodeGen::STATIC_VAR( string type, string name )
@@ -25,6 +25,7 @@
 #define _CSCODEGEN_H
 
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <stdio.h>
 #include "common.h"
@@ -82,6 +83,9 @@ protected:
 	string ARRAY_TYPE( unsigned long maxVal );
 	string ARRAY_TYPE( unsigned long maxVal, bool forceSigned );
 
+	/* Read an item of a table. */
+	string ARR_REF( string name, string index );
+
 	virtual string ARR_OFF( string ptr, string offset ) = 0;
 	virtual string CAST( string type ) = 0;
 	virtual string UINT() = 0;
@@ -183,7 +187,7 @@ class CSharpCodeGen : virtual public CSharpFsmCodeGen
 {
 public:
 	CSharpCodeGen( const CodeGenArgs &args ) 
-			: CSharpFsmCodeGen(args) {}
+			: CSharpFsmCodeGen(args), arraySaved(0) {}
 
 	virtual string GET_KEY();
 	virtual string NULL_ITEM();
@@ -199,6 +203,13 @@ public:
 	virtual string CTRL_FLOW();
 
 	virtual void writeExports();
+
+protected:
+	/* With --span-tables the items are collected and written as a byte
+	 * blob when the array is closed. */
+	string arrayType, arrayName;
+	std::ostringstream arrayBuf;
+	std::streambuf *arraySaved;
 };
 
 #define MAX(a, b) (a > b ? a : b)
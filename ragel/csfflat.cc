@@ -288,7 +288,7 @@ void CSharpFFlatCodeGen::writeExec()
 
 	if ( redFsm->anyFromStateActions() ) {
 		out <<
-			"	switch ( " << FSA() << "[" << vCS() << "] ) {\n";
+			"	switch ( " << ARR_REF( FSA(), vCS() ) << " ) {\n";
 			FROM_STATE_ACTION_SWITCH();
 			SWITCH_DEFAULT() <<
 			"	}\n"
@@ -307,14 +307,14 @@ void CSharpFFlatCodeGen::writeExec()
 		out << "	_ps = " << vCS() << ";\n";
 
 	out << 
-		"	" << vCS() << " = " << TT() << "[_trans];\n\n";
+		"	" << vCS() << " = " << ARR_REF( TT(), "_trans" ) << ";\n\n";
 
 	if ( redFsm->anyRegActions() ) {
 		out << 
-			"	if ( " << TA() << "[_trans] == 0 )\n"
+			"	if ( " << ARR_REF( TA(), "_trans" ) << " == 0 )\n"
 			"		goto _again;\n"
 			"\n"
-			"	switch ( " << TA() << "[_trans] ) {\n";
+			"	switch ( " << ARR_REF( TA(), "_trans" ) << " ) {\n";
 			ACTION_SWITCH();
 			SWITCH_DEFAULT() <<
 			"	}\n"
@@ -327,7 +327,7 @@ void CSharpFFlatCodeGen::writeExec()
 
 	if ( redFsm->anyToStateActions() ) {
 		out <<
-			"	switch ( " << TSA() << "[" << vCS() << "] ) {\n";
+			"	switch ( " << ARR_REF( TSA(), vCS() ) << " ) {\n";
 			TO_STATE_ACTION_SWITCH();
 			SWITCH_DEFAULT() <<
 			"	}\n"
@@ -362,16 +362,16 @@ void CSharpFFlatCodeGen::writeExec()
 
 		if ( redFsm->anyEofTrans() ) {
 			out <<
-				"	if ( " << ET() << "[" << vCS() << "] > 0 ) {\n"
-				"		_trans = " << CAST(transType) << " (" << ET() <<
-					"[" << vCS() << "] - 1);\n"
+				"	if ( " << ARR_REF( ET(), vCS() ) << " > 0 ) {\n"
+				"		_trans = " << CAST(transType) << " (" <<
+					ARR_REF( ET(), vCS() ) << " - 1);\n"
 				"		goto _eof_trans;\n"
 				"	}\n";
 		}
 
 		if ( redFsm->anyEofActions() ) {
 			out <<
-				"	switch ( " << EA() << "[" << vCS() << "] ) {\n";
+				"	switch ( " << ARR_REF( EA(), vCS() ) << " ) {\n";
 				EOF_ACTION_SWITCH();
 				SWITCH_DEFAULT() <<
 				"	}\n";
@@ -451,13 +451,13 @@ void CSharpFlatCodeGen::LOCATE_TRANS()
 {
 	out <<
 		"	_keys = " << vCS() << "<<1;\n"
-		"	_inds = " << IO() << "[" << vCS() << "];\n"
+		"	_inds = " << ARR_REF( IO(), vCS() ) << ";\n"
 		"\n"
-		"	_slen = " << SP() << "[" << vCS() << "];\n"
-		"	_trans = " << I() << "[_inds + (\n"
-		"		_slen > 0 && " << K() << "[_keys] <=" << GET_WIDE_KEY() << " &&\n"
-		"		" << GET_WIDE_KEY() << " <= " << K() <<"[_keys+1] ?\n"
-		"		" << GET_WIDE_KEY() << " - " << K() << "[_keys] : _slen ) ];\n"
+		"	_slen = " << ARR_REF( SP(), vCS() ) << ";\n"
+		"	_trans = " << ARR_REF( I(), "_inds + (\n"
+		"		_slen > 0 && " + ARR_REF( K(), "_keys" ) + " <=" + GET_WIDE_KEY() + " &&\n"
+		"		" + GET_WIDE_KEY() + " <= " + ARR_REF( K(), "_keys+1" ) + " ?\n"
+		"		" + GET_WIDE_KEY() + " - " + ARR_REF( K(), "_keys" ) + " : _slen )" ) << ";\n"
 		"\n";
 }
 
@@ -649,16 +649,16 @@ void CSharpFlatCodeGen::COND_TRANSLATE()
 
 	out <<
 		"   _keys = " << vCS() << "<<1;\n"
-		"   _conds = " << CO() << "[" << vCS() << "];\n"
+		"   _conds = " << ARR_REF( CO(), vCS() ) << ";\n"
 //		"	_keys = " << ARR_OFF( CK(), "(" + vCS() + "<<1)" ) << ";\n"
 //		"	_conds = " << ARR_OFF( C(), CO() + "[" + vCS() + "]" ) << ";\n"
 		"\n"
-		"	_slen = " << CSP() << "[" << vCS() << "];\n"
-		"	if (_slen > 0 && " << CK() << "[_keys] <=" 
+		"	_slen = " << ARR_REF( CSP(), vCS() ) << ";\n"
+		"	if (_slen > 0 && " << ARR_REF( CK(), "_keys" ) << " <=" 
 			<< GET_WIDE_KEY() << " &&\n"
-		"		" << GET_WIDE_KEY() << " <= " << CK() << "[_keys+1])\n"
-		"		_cond = " << C() << "[_conds+" << GET_WIDE_KEY() << " - " << 
-			CK() << "[_keys]];\n"
+		"		" << GET_WIDE_KEY() << " <= " << ARR_REF( CK(), "_keys+1" ) << ")\n"
+		"		_cond = " << ARR_REF( C(), "_conds+" + GET_WIDE_KEY() + " - " +
+			ARR_REF( CK(), "_keys" ) ) << ";\n"
 		"	else\n"
 		"		_cond = 0;"
 		"\n";
@@ -761,10 +761,10 @@ void CSharpFlatCodeGen::writeExec()
 
 	if ( redFsm->anyFromStateActions() ) {
 		out <<
-			"	_acts = " << FSA() << "[" << vCS() << "];\n"
-			"	_nacts = " << A() << "[_acts++];\n"
+			"	_acts = " << ARR_REF( FSA(), vCS() ) << ";\n"
+			"	_nacts = " << ARR_REF( A(), "_acts++" ) << ";\n"
 			"	while ( _nacts-- > 0 ) {\n"
-			"		switch ( " << A() << "[_acts++] ) {\n";
+			"		switch ( " << ARR_REF( A(), "_acts++" ) << " ) {\n";
 			FROM_STATE_ACTION_SWITCH();
 			SWITCH_DEFAULT() <<
 			"		}\n"
@@ -784,18 +784,18 @@ void CSharpFlatCodeGen::writeExec()
 		out << "	_ps = " << vCS() << ";\n";
 
 	out <<
-		"	" << vCS() << " = " << TT() << "[_trans];\n"
+		"	" << vCS() << " = " << ARR_REF( TT(), "_trans" ) << ";\n"
 		"\n";
 
 	if ( redFsm->anyRegActions() ) {
 		out <<
-			"	if ( " << TA() << "[_trans] == 0 )\n"
+			"	if ( " << ARR_REF( TA(), "_trans" ) << " == 0 )\n"
 			"		goto _again;\n"
 			"\n"
-			"	_acts = " << TA() << "[_trans];\n"
-			"	_nacts = " << A() << "[_acts++];\n"
+			"	_acts = " << ARR_REF( TA(), "_trans" ) << ";\n"
+			"	_nacts = " << ARR_REF( A(), "_acts++" ) << ";\n"
 			"	while ( _nacts-- > 0 ) {\n"
-			"		switch ( " << A() << "[_acts++] )\n		{\n";
+			"		switch ( " << ARR_REF( A(), "_acts++" ) << " )\n		{\n";
 			ACTION_SWITCH();
 			SWITCH_DEFAULT() <<
 			"		}\n"
@@ -809,10 +809,10 @@ void CSharpFlatCodeGen::writeExec()
 
 	if ( redFsm->anyToStateActions() ) {
 		out <<
-			"	_acts = " << TSA() << "[" << vCS() << "];\n"
-			"	_nacts = " << A() << "[_acts++];\n"
+			"	_acts = " << ARR_REF( TSA(), vCS() ) << ";\n"
+			"	_nacts = " << ARR_REF( A(), "_acts++" ) << ";\n"
 			"	while ( _nacts-- > 0 ) {\n"
-			"		switch ( " << A() << "[_acts++] ) {\n";
+			"		switch ( " << ARR_REF( A(), "_acts++" ) << " ) {\n";
 			TO_STATE_ACTION_SWITCH();
 			SWITCH_DEFAULT() <<
 			"		}\n"
@@ -848,9 +848,9 @@ void CSharpFlatCodeGen::writeExec()
 
 		if ( redFsm->anyEofTrans() ) {
 			out <<
-				"	if ( " << ET() << "[" << vCS() << "] > 0 ) {\n"
-				"		_trans = " << CAST(transType) << " (" << ET() << 
-					"[" << vCS() << "] - 1);\n"
+				"	if ( " << ARR_REF( ET(), vCS() ) << " > 0 ) {\n"
+				"		_trans = " << CAST(transType) << " (" <<
+					ARR_REF( ET(), vCS() ) << " - 1);\n"
 				"		goto _eof_trans;\n"
 				"	}\n";
 		}
@@ -859,11 +859,11 @@ void CSharpFlatCodeGen::writeExec()
 			out <<
 				"	" << PTR_CONST() << ARRAY_TYPE(redFsm->maxActArrItem) << 
 						POINTER() << "__acts = " << 
-						EA() << "[" << vCS() << "];\n"
+						ARR_REF( EA(), vCS() ) << ";\n"
 				"	" << UINT() << " __nacts = " << CAST(UINT()) << " " <<
-							A() << "[__acts++];\n"
+							ARR_REF( A(), "__acts++" ) << ";\n"
 				"	while ( __nacts-- > 0 ) {\n"
-				"		switch ( " << A() << "[__acts++] ) {\n";
+				"		switch ( " << ARR_REF( A(), "__acts++" ) << " ) {\n";
 				EOF_ACTION_SWITCH();
 				SWITCH_DEFAULT() <<
 				"		}\n"
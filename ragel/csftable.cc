@@ -331,7 +331,7 @@ void CSharpFTabCodeGen::writeExec()
 
 	if ( redFsm->anyFromStateActions() ) {
 		out <<
-			"	switch ( " << FSA() << "[" << vCS() << "] ) {\n";
+			"	switch ( " << ARR_REF( FSA(), vCS() ) << " ) {\n";
 			FROM_STATE_ACTION_SWITCH();
 			SWITCH_DEFAULT() <<
 			"	}\n"
@@ -346,7 +346,7 @@ void CSharpFTabCodeGen::writeExec()
 	out << "_match:\n";
 
 	if ( useIndicies )
-		out << "	_trans = " << CAST(transType) << I() << "[_trans];\n";
+		out << "	_trans = " << CAST(transType) << ARR_REF( I(), "_trans" ) << ";\n";
 
 	if ( redFsm->anyEofTrans() )
 		out << "_eof_trans:\n";
@@ -355,15 +355,15 @@ void CSharpFTabCodeGen::writeExec()
 		out << "	_ps = " << vCS() << ";\n";
 
 	out <<
-		"	" << vCS() << " = " << TT() << "[_trans];\n"
+		"	" << vCS() << " = " << ARR_REF( TT(), "_trans" ) << ";\n"
 		"\n";
 
 	if ( redFsm->anyRegActions() ) {
 		out << 
-			"	if ( " << TA() << "[_trans] == 0 )\n"
+			"	if ( " << ARR_REF( TA(), "_trans" ) << " == 0 )\n"
 			"		goto _again;\n"
 			"\n"
-			"	switch ( " << TA() << "[_trans] ) {\n";
+			"	switch ( " << ARR_REF( TA(), "_trans" ) << " ) {\n";
 			ACTION_SWITCH();
 			SWITCH_DEFAULT() <<
 			"	}\n"
@@ -376,7 +376,7 @@ void CSharpFTabCodeGen::writeExec()
 
 	if ( redFsm->anyToStateActions() ) {
 		out <<
-			"	switch ( " << TSA() << "[" << vCS() << "] ) {\n";
+			"	switch ( " << ARR_REF( TSA(), vCS() ) << " ) {\n";
 			TO_STATE_ACTION_SWITCH();
 			SWITCH_DEFAULT() <<
 			"	}\n"
@@ -411,16 +411,16 @@ void CSharpFTabCodeGen::writeExec()
 
 		if ( redFsm->anyEofTrans() ) {
 			out <<
-				"	if ( " << ET() << "[" << vCS() << "] > 0 ) {\n"
-				"		_trans = " << CAST(transType) << " (" << ET() <<
-					"[" << vCS() << "] - 1);\n"
+				"	if ( " << ARR_REF( ET(), vCS() ) << " > 0 ) {\n"
+				"		_trans = " << CAST(transType) << " (" <<
+					ARR_REF( ET(), vCS() ) << " - 1);\n"
 				"		goto _eof_trans;\n"
 				"	}\n";
 		}
 
 		if ( redFsm->anyEofActions() ) {
 			out <<
-				"	switch ( " << EA() << "[" << vCS() << "] ) {\n";
+				"	switch ( " << ARR_REF( EA(), vCS() ) << " ) {\n";
 				EOF_ACTION_SWITCH();
 				SWITCH_DEFAULT() <<
 				"	}\n";
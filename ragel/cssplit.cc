@@ -349,7 +349,7 @@ std::ostream &CSharpSplitCodeGen::ALL_PARTITIONS()
 		partFilter->open( fn, ios::out|ios::trunc );
 		if ( !partFilter->is_open() ) {
 			error() << "error opening " << fn << " for writing" << endl;
-			exit(1);
+			exitCompile(1);
 		}
 
 		/* Attach the new file to the output stream. */
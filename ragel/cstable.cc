@@ -824,10 +824,10 @@ void CSharpTabCodeGen::writeData()
 void CSharpTabCodeGen::LOCATE_TRANS()
 {
 	out <<
-		"	_keys = " << KO() + "[" + vCS() + "]" << ";\n"
-		"	_trans = " << CAST(transType) << IO() << "[" << vCS() << "];\n"
+		"	_keys = " << ARR_REF( KO(), vCS() ) << ";\n"
+		"	_trans = " << CAST(transType) << ARR_REF( IO(), vCS() ) << ";\n"
 		"\n"
-		"	_klen = " << SL() << "[" << vCS() << "];\n"
+		"	_klen = " << ARR_REF( SL(), vCS() ) << ";\n"
 		"	if ( _klen > 0 ) {\n"
 		"		" << signedKeysType << " _lower = _keys;\n"
 		"		" << signedKeysType << " _mid;\n"
@@ -839,9 +839,9 @@ void CSharpTabCodeGen::LOCATE_TRANS()
 		"\n"
 		"			_mid = " << CAST(signedKeysType) << 
 			" (_lower + ((_upper-_lower) >> 1));\n"
-		"			if ( " << GET_WIDE_KEY() << " < " << K() << "[_mid] )\n"
+		"			if ( " << GET_WIDE_KEY() << " < " << ARR_REF( K(), "_mid" ) << " )\n"
 		"				_upper = " << CAST(signedKeysType) << " (_mid - 1);\n"
-		"			else if ( " << GET_WIDE_KEY() << " > " << K() << "[_mid] )\n"
+		"			else if ( " << GET_WIDE_KEY() << " > " << ARR_REF( K(), "_mid" ) << " )\n"
 		"				_lower = " << CAST(signedKeysType) << " (_mid + 1);\n"
 		"			else {\n"
 		"				_trans += " << CAST(transType) << " (_mid - _keys);\n"
@@ -852,7 +852,7 @@ void CSharpTabCodeGen::LOCATE_TRANS()
 		"		_trans += " << CAST(transType) << " _klen;\n"
 		"	}\n"
 		"\n"
-		"	_klen = " << RL() << "[" << vCS() << "];\n"
+		"	_klen = " << ARR_REF( RL(), vCS() ) << ";\n"
 		"	if ( _klen > 0 ) {\n"
 		"		" << signedKeysType << " _lower = _keys;\n"
 		"		" << signedKeysType << " _mid;\n"
@@ -864,9 +864,9 @@ void CSharpTabCodeGen::LOCATE_TRANS()
 		"\n"
 		"			_mid = " << CAST(signedKeysType) << 
 			" (_lower + (((_upper-_lower) >> 1) & ~1));\n"
-		"			if ( " << GET_WIDE_KEY() << " < " << K() << "[_mid] )\n"
+		"			if ( " << GET_WIDE_KEY() << " < " << ARR_REF( K(), "_mid" ) << " )\n"
 		"				_upper = " << CAST(signedKeysType) << " (_mid - 2);\n"
-		"			else if ( " << GET_WIDE_KEY() << " > " << K() << "[_mid+1] )\n"
+		"			else if ( " << GET_WIDE_KEY() << " > " << ARR_REF( K(), "_mid+1" ) << " )\n"
 		"				_lower = " << CAST(signedKeysType) << " (_mid + 2);\n"
 		"			else {\n"
 		"				_trans += " << CAST(transType) << "((_mid - _keys)>>1);\n"
@@ -882,8 +882,8 @@ void CSharpTabCodeGen::COND_TRANSLATE()
 {
 	out << 
 		"	_widec = " << GET_KEY() << ";\n"
-		"	_klen = " << CL() << "[" << vCS() << "];\n"
-		"	_keys = " << CAST(keysType) << " ("<< CO() << "[" << vCS() << "]*2);\n"
+		"	_klen = " << ARR_REF( CL(), vCS() ) << ";\n"
+		"	_keys = " << CAST(keysType) << " ("<< ARR_REF( CO(), vCS() ) << "*2);\n"
 		"	if ( _klen > 0 ) {\n"
 		"		" << signedKeysType << " _lower = _keys;\n"
 		"		" << signedKeysType << " _mid;\n"
@@ -895,13 +895,13 @@ void CSharpTabCodeGen::COND_TRANSLATE()
 		"\n"
 		"			_mid = " << CAST(signedKeysType) << 
 			" (_lower + (((_upper-_lower) >> 1) & ~1));\n"
-		"			if ( " << GET_WIDE_KEY() << " < " << CK() << "[_mid] )\n"
+		"			if ( " << GET_WIDE_KEY() << " < " << ARR_REF( CK(), "_mid" ) << " )\n"
 		"				_upper = " << CAST(signedKeysType) << " (_mid - 2);\n"
-		"			else if ( " << GET_WIDE_KEY() << " > " << CK() << "[_mid+1] )\n"
+		"			else if ( " << GET_WIDE_KEY() << " > " << ARR_REF( CK(), "_mid+1" ) << " )\n"
 		"				_lower = " << CAST(signedKeysType) << " (_mid + 2);\n"
 		"			else {\n"
-		"				switch ( " << C() << "[" << CO() << "[" << vCS() << "]"
-							" + ((_mid - _keys)>>1)] ) {\n";
+		"				switch ( " << ARR_REF( C(), ARR_REF( CO(), vCS() ) +
+							" + ((_mid - _keys)>>1)" ) << " ) {\n";
 
 	for ( CondSpaceList::Iter csi = condSpaceList; csi.lte(); csi++ ) {
 		GenCondSpace *condSpace = csi;
@@ -984,10 +984,10 @@ void CSharpTabCodeGen::writeExec()
 
 	if ( redFsm->anyFromStateActions() ) {
 		out <<
-			"	_acts = " << FSA() << "[" + vCS() + "]" << ";\n"
-			"	_nacts = " << A() << "[_acts++];\n"
+			"	_acts = " << ARR_REF( FSA(), vCS() ) << ";\n"
+			"	_nacts = " << ARR_REF( A(), "_acts++" ) << ";\n"
 			"	while ( _nacts-- > 0 ) {\n"
-			"		switch ( " << A() << "[_acts++] ) {\n";
+			"		switch ( " << ARR_REF( A(), "_acts++" ) << " ) {\n";
 			FROM_STATE_ACTION_SWITCH();
 			SWITCH_DEFAULT() <<
 			"		}\n"
@@ -1003,7 +1003,7 @@ void CSharpTabCodeGen::writeExec()
 	out << "_match:\n";
 
 	if ( useIndicies )
-		out << "	_trans = " << CAST(transType) << I() << "[_trans];\n";
+		out << "	_trans = " << CAST(transType) << ARR_REF( I(), "_trans" ) << ";\n";
 	
 	if ( redFsm->anyEofTrans() )
 		out << "_eof_trans:\n";
@@ -1012,18 +1012,18 @@ void CSharpTabCodeGen::writeExec()
 		out << "	_ps = " << vCS() << ";\n";
 
 	out <<
-		"	" << vCS() << " = " << TT() << "[_trans];\n"
+		"	" << vCS() << " = " << ARR_REF( TT(), "_trans" ) << ";\n"
 		"\n";
 
 	if ( redFsm->anyRegActions() ) {
 		out <<
-			"	if ( " << TA() << "[_trans] == 0 )\n"
+			"	if ( " << ARR_REF( TA(), "_trans" ) << " == 0 )\n"
 			"		goto _again;\n"
 			"\n"
-			"	_acts = " << TA() << "[_trans]" << ";\n"
-			"	_nacts = " << A() << "[_acts++];\n"
+			"	_acts = " << ARR_REF( TA(), "_trans" ) << ";\n"
+			"	_nacts = " << ARR_REF( A(), "_acts++" ) << ";\n"
 			"	while ( _nacts-- > 0 )\n	{\n"
-			"		switch ( " << A() << "[_acts++] )\n		{\n";
+			"		switch ( " << ARR_REF( A(), "_acts++" ) << " )\n		{\n";
 			ACTION_SWITCH();
 			SWITCH_DEFAULT() <<
 			"		}\n"
@@ -1037,10 +1037,10 @@ void CSharpTabCodeGen::writeExec()
 
 	if ( redFsm->anyToStateActions() ) {
 		out <<
-			"	_acts = " << TSA() << "[" << vCS() << "]" << ";\n"
-			"	_nacts = " << A() << "[_acts++];\n"
+			"	_acts = " << ARR_REF( TSA(), vCS() ) << ";\n"
+			"	_nacts = " << ARR_REF( A(), "_acts++" ) << ";\n"
 			"	while ( _nacts-- > 0 ) {\n"
-			"		switch ( " << A() << "[_acts++] ) {\n";
+			"		switch ( " << ARR_REF( A(), "_acts++" ) << " ) {\n";
 			TO_STATE_ACTION_SWITCH();
 			SWITCH_DEFAULT() <<
 			"		}\n"
@@ -1076,9 +1076,9 @@ void CSharpTabCodeGen::writeExec()
 
 		if ( redFsm->anyEofTrans() ) {
 			out <<
-				"	if ( " << ET() << "[" << vCS() << "] > 0 ) {\n"
-				"		_trans = " << CAST(transType) << " (" << ET() <<
-					"[" << vCS() << "] - 1);\n"
+				"	if ( " << ARR_REF( ET(), vCS() ) << " > 0 ) {\n"
+				"		_trans = " << CAST(transType) << " (" <<
+					ARR_REF( ET(), vCS() ) << " - 1);\n"
 				"		goto _eof_trans;\n"
 				"	}\n";
 		}
@@ -1086,11 +1086,11 @@ void CSharpTabCodeGen::writeExec()
 		if ( redFsm->anyEofActions() ) {
 			out <<
 				"	int __acts = " << 
-						EA() << "[" << vCS() << "]" << ";\n"
+						ARR_REF( EA(), vCS() ) << ";\n"
 				"	int __nacts = " << 
-				A() << "[__acts++];\n"
+				ARR_REF( A(), "__acts++" ) << ";\n"
 				"	while ( __nacts-- > 0 ) {\n"
-				"		switch ( " << A() << "[__acts++] ) {\n";
+				"		switch ( " << ARR_REF( A(), "__acts++" ) << " ) {\n";
 				EOF_ACTION_SWITCH();
 				SWITCH_DEFAULT() <<
 				"		}\n"
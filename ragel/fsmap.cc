@@ -35,9 +35,15 @@ void ActionTable::setAction( int ordering, Action *action )
 	insertMulti( ordering, action );
 }
 
-/* Set all the action from another action table in this table. */
+/* Set all the action from another action table in this table. If this table
+ * is empty the union is the other table and we share its data. */
 void ActionTable::setActions( const ActionTable &other )
 {
+	if ( length() == 0 ) {
+		*this = other;
+		return;
+	}
+
 	for ( ActionTable::Iter action = other; action.lte(); action++ )
 		insertMulti( action->key, action->value );
 }
@@ -65,9 +71,15 @@ void LmActionTable::setAction( int ordering, LongestMatchPart *action )
 	insertMulti( ordering, action );
 }
 
-/* Set all the action from another action table in this table. */
+/* Set all the action from another action table in this table. If this table
+ * is empty the union is the other table and we share its data. */
 void LmActionTable::setActions( const LmActionTable &other )
 {
+	if ( length() == 0 ) {
+		*this = other;
+		return;
+	}
+
 	for ( LmActionTable::Iter action = other; action.lte(); action++ )
 		insertMulti( action->key, action->value );
 }
@@ -93,13 +105,19 @@ void PriorTable::setPrior( int ordering, PriorDesc *desc )
 		/* This already has a priority on the same key as desc. Overwrite the
 		 * priority if the ordering is larger (later in time). */
 		if ( ordering >= lastHit->ordering )
-			*lastHit = PriorEl( ordering, desc );
+			replace( lastHit - data, PriorEl( ordering, desc ) );
 	}
 }
 
 /* Set all the priorities from a priorTable in this table. */
 void PriorTable::setPriors( const PriorTable &other )
 {
+	/* Nothing to overwrite, share the other table's data. */
+	if ( length() == 0 ) {
+		*this = other;
+		return;
+	}
+
 	/* Loop src priorities once to overwrite duplicates. */
 	PriorTable::Iter priorIt = other;
 	for ( ; priorIt.lte(); priorIt++ )
@@ -156,7 +174,7 @@ void FsmAp::allTransPrior( int ordering, PriorDesc *prior )
 void FsmAp::finishFsmPrior( int ordering, PriorDesc *prior )
 {
 	/* Walk all final states. */
-	for ( StateSet::Iter state = finStateSet; state.lte(); state++ ) {
+	for ( FinStateSet::Iter state = finStateSet; state.lte(); state++ ) {
 		/* Walk all in transitions of the final state. */
 		for ( TransInList<CondAp>::Iter t = (*state)->inList; t.lte(); t++ )
 			t->priorTable.setPrior( ordering, prior );
@@ -168,7 +186,7 @@ void FsmAp::finishFsmPrior( int ordering, PriorDesc *prior )
 void FsmAp::leaveFsmPrior( int ordering, PriorDesc *prior )
 {
 	/* Set priority in all final states. */
-	for ( StateSet::Iter state = finStateSet; state.lte(); state++ )
+	for ( FinStateSet::Iter state = finStateSet; state.lte(); state++ )
 		(*state)->outPriorTable.setPrior( ordering, prior );
 }
 
@@ -223,7 +241,7 @@ void FsmAp::allTransAction( int ordering, Action *action )
 void FsmAp::finishFsmAction( int ordering, Action *action )
 {
 	/* Walk all final states. */
-	for ( StateSet::Iter state = finStateSet; state.lte(); state++ ) {
+	for ( FinStateSet::Iter state = finStateSet; state.lte(); state++ ) {
 		/* Walk the final state's in list. */
 		for ( TransInList<CondAp>::Iter t = (*state)->inList; t.lte(); t++ )
 			t->actionTable.setAction( ordering, action );
@@ -235,7 +253,7 @@ void FsmAp::finishFsmAction( int ordering, Action *action )
 void FsmAp::leaveFsmAction( int ordering, Action *action )
 {
 	/* Insert the action in the outActionTable of all final states. */
-	for ( StateSet::Iter state = finStateSet; state.lte(); state++ )
+	for ( FinStateSet::Iter state = finStateSet; state.lte(); state++ )
 		(*state)->outActionTable.setAction( ordering, action );
 }
 
@@ -243,7 +261,7 @@ void FsmAp::leaveFsmAction( int ordering, Action *action )
 void FsmAp::longMatchAction( int ordering, LongestMatchPart *lmPart )
 {
 	/* Walk all final states. */
-	for ( StateSet::Iter state = finStateSet; state.lte(); state++ ) {
+	for ( FinStateSet::Iter state = finStateSet; state.lte(); state++ ) {
 		/* Walk the final state's in list. */
 		for ( TransInList<CondAp>::Iter t = (*state)->inList; t.lte(); t++ )
 			t->lmActionTable.setAction( ordering, lmPart );
@@ -405,7 +423,7 @@ void FsmAp::allErrorAction( int ordering, Action *action, int transferPoint )
 void FsmAp::finalErrorAction( int ordering, Action *action, int transferPoint )
 {
 	/* Add the action to the error table of final states. */
-	for ( StateSet::Iter state = finStateSet; state.lte(); state++ )
+	for ( FinStateSet::Iter state = finStateSet; state.lte(); state++ )
 		(*state)->errActionTable.setAction( ordering, action, transferPoint );
 }
 
@@ -458,7 +476,7 @@ void FsmAp::allEOFAction( int ordering, Action *action )
 void FsmAp::finalEOFAction( int ordering, Action *action )
 {
 	/* Add the action to the error table of final states. */
-	for ( StateSet::Iter state = finStateSet; state.lte(); state++ )
+	for ( FinStateSet::Iter state = finStateSet; state.lte(); state++ )
 		(*state)->eofActionTable.setAction( ordering, action );
 }
 
@@ -512,7 +530,7 @@ void FsmAp::allToStateAction( int ordering, Action *action )
 void FsmAp::finalToStateAction( int ordering, Action *action )
 {
 	/* Add the action to the error table of final states. */
-	for ( StateSet::Iter state = finStateSet; state.lte(); state++ )
+	for ( FinStateSet::Iter state = finStateSet; state.lte(); state++ )
 		(*state)->toStateActionTable.setAction( ordering, action );
 }
 
@@ -563,7 +581,7 @@ void FsmAp::allFromStateAction( int ordering, Action *action )
 void FsmAp::finalFromStateAction( int ordering, Action *action )
 {
 	/* Add the action to the error table of final states. */
-	for ( StateSet::Iter state = finStateSet; state.lte(); state++ )
+	for ( FinStateSet::Iter state = finStateSet; state.lte(); state++ )
 		(*state)->fromStateActionTable.setAction( ordering, action );
 }
 
@@ -592,6 +610,16 @@ void FsmAp::middleFromStateAction( int ordering, Action *action )
 	}
 }
 
+/* Tables share their data when copied or unioned into an empty table. Code
+ * that writes to a table through an iterator must first take a private copy
+ * of the data. */
+template <class Table> static void unshareTable( Table &table )
+{
+	Table copy;
+	copy.deepCopy( table );
+	table = copy;
+}
+
 /* Shift the function ordering of the start transitions to start
  * at fromOrder and increase in units of 1. Useful before staring.
  * Returns the maximum number of order numbers used. */
@@ -605,6 +633,7 @@ int FsmAp::shiftStartActionOrder( int fromOrder )
 			/* Walk the function data for the transition and set the keys to
 			 * increasing values starting at fromOrder. */
 			int curFromOrder = fromOrder;
+			unshareTable( cond->actionTable );
 			ActionTable::Iter action = cond->actionTable;
 			for ( ; action.lte(); action++ ) 
 				action->key = curFromOrder++;
@@ -618,6 +647,107 @@ int FsmAp::shiftStartActionOrder( int fromOrder )
 	return maxUsed;
 }
 
+template <class Table> static bool tableKeysInRange( const Table &table,
+		int fromOrder, int toOrder )
+{
+	for ( typename Table::Iter el = table; el.lte(); el++ ) {
+		if ( fromOrder <= el->key && el->key < toOrder )
+			return true;
+	}
+	return false;
+}
+
+template <class Table> static void shiftTableKeys( Table &table,
+		int fromOrder, int toOrder, int shift )
+{
+	if ( tableKeysInRange( table, fromOrder, toOrder ) ) {
+		unshareTable( table );
+		for ( typename Table::Iter el = table; el.lte(); el++ ) {
+			if ( fromOrder <= el->key && el->key < toOrder )
+				el->key += shift;
+		}
+	}
+}
+
+static void shiftActionTable( ActionTable &table, int fromOrder, int toOrder, int shift )
+{
+	shiftTableKeys( table, fromOrder, toOrder, shift );
+}
+
+/* Shift the orderings from a range of action embeddings. Orderings outside
+ * the range are lower than the ones in it, so the tables stay sorted. */
+void FsmAp::shiftActionOrdering( int fromOrder, int toOrder, int shift )
+{
+	for ( StateList::Iter state = stateList; state.lte(); state++ ) {
+		for ( TransList::Iter trans = state->outList; trans.lte(); trans++ ) {
+			for ( CondTransList::Iter cond = trans->ctList; cond.lte(); cond++ ) {
+				shiftActionTable( cond->actionTable, fromOrder, toOrder, shift );
+				shiftTableKeys( cond->lmActionTable, fromOrder, toOrder, shift );
+			}
+		}
+
+		shiftActionTable( state->toStateActionTable, fromOrder, toOrder, shift );
+		shiftActionTable( state->fromStateActionTable, fromOrder, toOrder, shift );
+		shiftActionTable( state->outActionTable, fromOrder, toOrder, shift );
+		shiftActionTable( state->eofActionTable, fromOrder, toOrder, shift );
+
+		unshareTable( state->errActionTable );
+		for ( ErrActionTable::Iter action = state->errActionTable;
+				action.lte(); action++ )
+		{
+			if ( fromOrder <= action->ordering && action->ordering < toOrder )
+				action->ordering += shift;
+		}
+	}
+}
+
+/* Shift the orderings from a range of priority embeddings. */
+void FsmAp::shiftPriorOrdering( int fromOrder, int toOrder, int shift )
+{
+	for ( StateList::Iter state = stateList; state.lte(); state++ ) {
+		for ( TransList::Iter trans = state->outList; trans.lte(); trans++ ) {
+			for ( CondTransList::Iter cond = trans->ctList; cond.lte(); cond++ ) {
+				unshareTable( cond->priorTable );
+				for ( PriorTable::Iter prior = cond->priorTable; prior.lte(); prior++ ) {
+					if ( fromOrder <= prior->ordering && prior->ordering < toOrder )
+						prior->ordering += shift;
+				}
+			}
+		}
+
+		unshareTable( state->outPriorTable );
+		for ( PriorTable::Iter prior = state->outPriorTable; prior.lte(); prior++ ) {
+			if ( fromOrder <= prior->ordering && prior->ordering < toOrder )
+				prior->ordering += shift;
+		}
+	}
+}
+
+template <class Table, class Compare> static void internTable(
+		AvlSet<Table, Compare> &pool, Table &table )
+{
+	AvlSetEl<Table> *lastFound = 0;
+	if ( table.length() > 0 && pool.insert( table, &lastFound ) == 0 )
+		table = lastFound->key;
+}
+
+void FsmAp::internTables()
+{
+	AvlSet<ActionTable, CmpActionTable> actionPool;
+	AvlSet<PriorTable, CmpPriorTable> priorPool;
+	AvlSet<LmActionTable, CmpLmActionTable> lmActionPool;
+
+	for ( StateList::Iter state = stateList; state.lte(); state++ ) {
+		for ( TransList::Iter trans = state->outList; trans.lte(); trans++ ) {
+			for ( CondTransList::Iter cond = trans->ctList; cond.lte(); cond++ ) {
+				internTable( actionPool, cond->actionTable );
+				internTable( priorPool, cond->priorTable );
+				internTable( lmActionPool, cond->lmActionTable );
+			}
+		}
+	}
+}
+
 /* Remove all priorities. */
 void FsmAp::clearAllPriorities()
 {
@@ -642,37 +772,44 @@ void FsmAp::nullActionKeys( )
 		/* Walk the transitions for the state. */
 		for ( TransList::Iter trans = state->outList; trans.lte(); trans++ ) {
 			/* Walk the action table for the transition. */
+			unshareTable( trans->ctList.head->actionTable );
 			for ( ActionTable::Iter action = trans->ctList.head->actionTable;
 					action.lte(); action++ )
 				action->key = 0;
 
 			/* Walk the action table for the transition. */
+			unshareTable( trans->ctList.head->lmActionTable );
 			for ( LmActionTable::Iter action = trans->ctList.head->lmActionTable;
 					action.lte(); action++ )
 				action->key = 0;
 		}
 
 		/* Null the action keys of the to state action table. */
+		unshareTable( state->toStateActionTable );
 		for ( ActionTable::Iter action = state->toStateActionTable;
 				action.lte(); action++ )
 			action->key = 0;
 
 		/* Null the action keys of the from state action table. */
+		unshareTable( state->fromStateActionTable );
 		for ( ActionTable::Iter action = state->fromStateActionTable;
 				action.lte(); action++ )
 			action->key = 0;
 
 		/* Null the action keys of the out transtions. */
+		unshareTable( state->outActionTable );
 		for ( ActionTable::Iter action = state->outActionTable;
 				action.lte(); action++ )
 			action->key = 0;
 
 		/* Null the action keys of the error action table. */
+		unshareTable( state->errActionTable );
 		for ( ErrActionTable::Iter action = state->errActionTable;
 				action.lte(); action++ )
 			action->ordering = 0;
 
 		/* Null the action keys eof action table. */
+		unshareTable( state->eofActionTable );
 		for ( ActionTable::Iter action = state->eofActionTable;
 				action.lte(); action++ )
 			action->key = 0;
@@ -926,6 +1063,6 @@ void FsmAp::allTransCondition( Action *condAction, bool sense )
 
 void FsmAp::leaveFsmCondition( Action *condAction, bool sense )
 {
-	for ( StateSet::Iter state = finStateSet; state.lte(); state++ )
+	for ( FinStateSet::Iter state = finStateSet; state.lte(); state++ )
 		(*state)->outCondSet.insert( OutCond( condAction, sense ) );
 }
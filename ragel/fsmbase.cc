@@ -123,7 +123,7 @@ FsmAp::FsmAp( const FsmAp &graph )
 	startState->foreignInTrans += 1;
 
 	/* Build the final state set. */
-	StateSet::Iter st = graph.finStateSet; 
+	FinStateSet::Iter st = graph.finStateSet; 
 	for ( ; st.lte(); st++ ) 
 		finStateSet.insert((*st)->alg.stateMap);
 }
@@ -141,6 +141,28 @@ FsmAp::~FsmAp()
 	stateList.empty();
 }
 
+void FinStateSet::insert( StateAp *state )
+{
+	state->finIndex = length();
+	append( state );
+}
+
+void FinStateSet::remove( StateAp *state )
+{
+	/* Fill the hole with the last state. */
+	StateAp *last = data[length()-1];
+	data[state->finIndex] = last;
+	last->finIndex = state->finIndex;
+	StateVect::remove( length()-1 );
+	state->finIndex = -1;
+}
+
+void FinStateSet::insert( FinStateSet &other )
+{
+	for ( int s = 0; s < other.length(); s++ )
+		insert( other.data[s] );
+}
+
 /* Set a state final. The state has its isFinState set to true and the state
  * is added to the finStateSet. */
 void FsmAp::setFinState( StateAp *state )
@@ -339,7 +361,7 @@ void FsmAp::unsetAllEntryPoints()
 /* Assigning an epsilon transition into final states. */
 void FsmAp::epsilonTrans( int id )
 {
-	for ( StateSet::Iter fs = finStateSet; fs.lte(); fs++ )
+	for ( FinStateSet::Iter fs = finStateSet; fs.lte(); fs++ )
 		(*fs)->epsilonTrans.append( id );
 }
 
@@ -429,7 +451,7 @@ void FsmAp::copyInEntryPoints( FsmAp *other )
 
 void FsmAp::unsetAllFinStates()
 {
-	for ( StateSet::Iter st = finStateSet; st.lte(); st++ )
+	for ( FinStateSet::Iter st = finStateSet; st.lte(); st++ )
 		(*st)->stateBits &= ~ STB_ISFINAL;
 	finStateSet.empty();
 }
@@ -478,7 +500,7 @@ void FsmAp::verifyReachability()
 void FsmAp::verifyNoDeadEndStates()
 {
 	/* Mark all states that have paths to the final states. */
-	for ( StateSet::Iter pst = finStateSet; pst.lte(); pst++ )
+	for ( FinStateSet::Iter pst = finStateSet; pst.lte(); pst++ )
 		markReachableFromHereReverse( *pst );
 
 	/* Start state gets honorary marking. Must be done AFTER recursive call. */
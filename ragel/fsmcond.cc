@@ -41,7 +41,8 @@ using std::cout;
 void logNewExpansion( Expansion *exp );
 void logCondSpace( CondSpace *condSpace );
 
-void FsmAp::expandConds( StateAp *fromState, TransAp *trans, const CondSet &fromCS, const CondSet &mergedCS )
+void FsmAp::expandConds( StateAp *fromState, TransAp *trans, const CondSet &fromCS,
+		const CondSet &mergedCS, bool attached )
 {
 	/*CondSpace *mergedCondSpace = */addCondSpace( mergedCS );
 
@@ -69,7 +70,9 @@ void FsmAp::expandConds( StateAp *fromState, TransAp *trans, const CondSet &from
 		}
 
 		if ( origVal != newVal ) {
+			#ifdef LOG_CONDS
 			cout << "orig: " << origVal << " new: " << newVal << endl;
+			#endif
 			cti->lowKey = cti->highKey = newVal;
 		}
 	}
@@ -81,9 +84,21 @@ void FsmAp::expandConds( StateAp *fromState, TransAp *trans, const CondSet &from
 		Action **cim = fromCS.find( *csi );
 		if ( cim == 0 ) {
 			CondTransList newItems;
+			#ifdef LOG_CONDS
 			cout << "doubling up on condition" << endl;
+			#endif
 			for ( CondTransList::Iter cti = trans->ctList; cti.lte(); cti++ ) {
-				CondAp *cond = dupCondTrans( fromState, trans, cti  );
+				CondAp *cond;
+				if ( attached )
+					cond = dupCondTrans( fromState, trans, cti  );
+				else {
+					/* Copies made for an expansion are freed without
+					 * detaching, so they must not be attached either. */
+					cond = new CondAp( trans );
+					cond->fromState = cti->fromState;
+					cond->toState = cti->toState;
+					addInTrans( cond, cti );
+				}
 
 				cond->lowKey = cond->highKey = cti->lowKey.getVal() | (1 << csi.pos());
 
@@ -157,8 +172,8 @@ void FsmAp::expandCondTransitions( StateAp *fromState, TransAp *destTrans, Trans
 	mergedCS.insert( destCS );
 	mergedCS.insert( srcCS );
 
-	expandConds( fromState, destTrans, destCS, mergedCS );
-	expandConds( fromState, srcTrans, srcCS, mergedCS );
+	expandConds( fromState, destTrans, destCS, mergedCS, true );
+	expandConds( fromState, srcTrans, srcCS, mergedCS, false );
 
 	CondSpace *mergedCondSpace = addCondSpace( mergedCS );
 	destTrans->condSpace = mergedCondSpace;
@@ -368,7 +383,9 @@ void FsmAp::embedCondition( MergeData &md, StateAp *state, Action *condAction, b
 			}
 
 			if ( origVal != newVal ) {
+				#ifdef LOG_CONDS
 				cout << "orig: " << origVal << " new: " << newVal << endl;
+				#endif
 				cti->lowKey = cti->highKey = newVal;
 			}
 
@@ -389,7 +406,9 @@ void FsmAp::embedCondition( MergeData &md, StateAp *state, Action *condAction, b
 		Action **cim = fromCS.find( *csi );
 		if ( cim == 0 ) {
 			CondTransList newItems;
+			#ifdef LOG_CONDS
 			cout << "doubling up on condition" << endl;
+			#endif
 			for ( CondTransList::Iter cti = trans->ctList; cti.lte(); cti++ ) {
 				CondAp *cond = dupCondTrans( fromState, trans, cti  );
 
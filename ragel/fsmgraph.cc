@@ -25,6 +25,7 @@
 #include "fsmgraph.h"
 #include "mergesort.h"
 #include "parsedata.h"
+#include "unicode.h"
 
 using std::cerr;
 using std::endl;
@@ -98,6 +99,162 @@ void FsmAp::concatFsmCI( Key *str, int len )
 	setFinState( last );
 }
 
+/* A node of the trie built by unionLiteralsFsm. The id is assigned when the
+ * node is registered and names it in the signatures of its parents. */
+struct LitTrieNode
+{
+	LitTrieNode() : final(false), id(-1), state(0) { }
+
+	Vector<Key> keys;
+	Vector<LitTrieNode*> targs;
+	bool final;
+	long id;
+	StateAp *state;
+};
+
+struct LitWord
+{
+	Key *data;
+	long length;
+};
+
+/* Lexicographic order, a string sorting before its extensions. */
+struct CmpLitWord
+{
+	static int compare( const LitWord &w1, const LitWord &w2 )
+	{
+		long len = w1.length < w2.length ? w1.length : w2.length;
+		for ( long i = 0; i < len; i++ ) {
+			if ( w1.data[i] < w2.data[i] )
+				return -1;
+			else if ( w1.data[i] > w2.data[i] )
+				return 1;
+		}
+
+		if ( w1.length < w2.length )
+			return -1;
+		else if ( w1.length > w2.length )
+			return 1;
+		return 0;
+	}
+};
+
+/* Registered nodes keyed by finality followed by (key, target id) pairs. */
+typedef AvlMap< Vector<long>, LitTrieNode*, CmpTable<long> > LitRegister;
+typedef AvlMapEl< Vector<long>, LitTrieNode* > LitRegisterEl;
+
+/* The last target of parent will take no more strings. Replace it with an
+ * equivalent registered node or register it. Its own targets are already
+ * registered. */
+static void registerLitNode( LitRegister &reg, Vector<LitTrieNode*> &nodes,
+		LitTrieNode *parent )
+{
+	LitTrieNode *&target = parent->targs.data[parent->targs.length()-1];
+
+	Vector<long> sig;
+	sig.append( target->final );
+	for ( long i = 0; i < target->keys.length(); i++ ) {
+		sig.append( target->keys[i].getVal() );
+		sig.append( target->targs[i]->id );
+	}
+
+	LitRegisterEl *lastFound;
+	if ( reg.insert( sig, target, &lastFound ) == 0 ) {
+		delete target;
+		target = lastFound->value;
+	}
+	else {
+		target->id = nodes.length();
+		nodes.append( target );
+	}
+}
+
+/* Construct the minimal machine for a union of strings directly, without
+ * building a machine per string. The strings are sorted and added to a trie
+ * one at a time. Once a string shares less of its prefix with the next one,
+ * the nodes past the shared part are final and are merged with equivalent
+ * ones (Daciuk et al, incremental construction of minimal acyclic automata).
+ * Case insensitive strings must be given in lower case. */
+void FsmAp::unionLiteralsFsm( Key **strs, long *lens, long num,
+		bool caseInsensitive )
+{
+	LitWord *words = new LitWord[num];
+	for ( long w = 0; w < num; w++ ) {
+		words[w].data = strs[w];
+		words[w].length = lens[w];
+	}
+
+	MergeSort<LitWord, CmpLitWord> mergeSort;
+	mergeSort.sort( words, num );
+
+	LitTrieNode *root = new LitTrieNode();
+	Vector<LitTrieNode*> path, nodes;
+	LitRegister reg;
+	path.append( root );
+
+	for ( long w = 0; w < num; w++ ) {
+		/* Length of the prefix shared with the previous string. */
+		long prefix = 0;
+		if ( w > 0 ) {
+			LitWord &prev = words[w-1];
+			while ( prefix < prev.length && prefix < words[w].length &&
+					prev.data[prefix] == words[w].data[prefix] )
+				prefix++;
+
+			/* Duplicate. */
+			if ( prefix == prev.length && prefix == words[w].length )
+				continue;
+		}
+
+		/* Finish the previous string's path past the shared prefix, deepest
+		 * node first. */
+		for ( long d = path.length() - 1; d > prefix; d-- )
+			registerLitNode( reg, nodes, path[d-1] );
+		path.remove( prefix + 1, path.length() - prefix - 1 );
+
+		for ( long i = prefix; i < words[w].length; i++ ) {
+			LitTrieNode *node = new LitTrieNode();
+			LitTrieNode *last = path[path.length()-1];
+			last->keys.append( words[w].data[i] );
+			last->targs.append( node );
+			path.append( node );
+		}
+		path[path.length()-1]->final = true;
+	}
+
+	for ( long d = path.length() - 1; d > 0; d-- )
+		registerLitNode( reg, nodes, path[d-1] );
+	nodes.append( root );
+
+	/* Make the states, then the transitions. */
+	for ( long n = 0; n < nodes.length(); n++ ) {
+		nodes[n]->state = addState();
+		if ( nodes[n]->final )
+			setFinState( nodes[n]->state );
+	}
+	setStartState( root->state );
+
+	for ( long n = 0; n < nodes.length(); n++ ) {
+		LitTrieNode *node = nodes[n];
+
+		/* An upper case twin can sort between the node's other keys. */
+		BstMap<Key, StateAp*, CmpKey> out;
+		for ( long i = 0; i < node->keys.length(); i++ ) {
+			Key key = node->keys[i];
+			out.insert( key, node->targs[i]->state );
+			if ( caseInsensitive && key.isLower() )
+				out.insert( key.toUpper(), node->targs[i]->state );
+		}
+
+		for ( long i = 0; i < out.length(); i++ )
+			attachNewTrans( node->state, out[i].value, out[i].key, out[i].key );
+	}
+
+	for ( long n = 0; n < nodes.length(); n++ )
+		delete nodes[n];
+	delete[] words;
+}
+
 /* Construct a machine that matches one character.  A new machine will be made
  * that has two states with a single transition between the states. IsSigned
  * determines if the integers are to be considered as signed or unsigned ints. */
@@ -161,6 +318,244 @@ void FsmAp::rangeStarFsm( Key low, Key high)
 	attachNewTrans( startState, startState, low, high );
 }
 
+/* A sequence of code unit ranges. The cross product of the ranges encodes a
+ * contiguous block of unicode code points. */
+struct UnitSeq
+{
+	int len;
+	Key low[4], high[4];
+};
+
+/* Orders unit sequences by their keys. Since the sequences come from
+ * disjoint code point ranges, sequences sharing a prefix end up adjacent. */
+struct CmpUnitSeq
+{
+	static int compare( const UnitSeq &seq1, const UnitSeq &seq2 )
+	{
+		for ( int i = 0; i < seq1.len && i < seq2.len; i++ ) {
+			if ( seq1.low[i] < seq2.low[i] )
+				return -1;
+			else if ( seq1.low[i] > seq2.low[i] )
+				return 1;
+			else if ( seq1.high[i] < seq2.high[i] )
+				return -1;
+			else if ( seq1.high[i] > seq2.high[i] )
+				return 1;
+		}
+		return seq1.len - seq2.len;
+	}
+};
+
+/* Make a key from a code unit. If the alphabet is signed and exactly as wide
+ * as the code unit then units with the top bit set become negative keys. */
+static bool unitWraps( int bits )
+{
+	return keyOps->isSigned && keyOps->alphType->size * 8 == (unsigned)bits;
+}
+
+static Key unitKey( unsigned long unit, int bits )
+{
+	if ( unitWraps( bits ) && ( unit >> (bits - 1) ) )
+		return Key( (long)unit - (1L << bits) );
+	return Key( (long)unit );
+}
+
+static void utf8Encode( unsigned long *bytes, unsigned long c, int len )
+{
+	switch ( len ) {
+	case 1:
+		bytes[0] = c;
+		break;
+	case 2:
+		bytes[0] = 0xc0 | ( c >> 6 );
+		bytes[1] = 0x80 | ( c & 0x3f );
+		break;
+	case 3:
+		bytes[0] = 0xe0 | ( c >> 12 );
+		bytes[1] = 0x80 | ( ( c >> 6 ) & 0x3f );
+		bytes[2] = 0x80 | ( c & 0x3f );
+		break;
+	case 4:
+		bytes[0] = 0xf0 | ( c >> 18 );
+		bytes[1] = 0x80 | ( ( c >> 12 ) & 0x3f );
+		bytes[2] = 0x80 | ( ( c >> 6 ) & 0x3f );
+		bytes[3] = 0x80 | ( c & 0x3f );
+		break;
+	}
+}
+
+/* Split a range of code points into blocks whose UTF-8 encodings are the
+ * cross product of one byte range per position. */
+static void utf8Split( Vector<UnitSeq> &seqs, unsigned long low, unsigned long high )
+{
+	/* First split where the length of the encoding changes. */
+	static const unsigned long lenMax[] = { 0x7f, 0x7ff, 0xffff };
+	for ( int i = 0; i < 3; i++ ) {
+		if ( low <= lenMax[i] && high > lenMax[i] ) {
+			utf8Split( seqs, low, lenMax[i] );
+			utf8Split( seqs, lenMax[i] + 1, high );
+			return;
+		}
+	}
+
+	int len = low <= 0x7f ? 1 : low <= 0x7ff ? 2 : low <= 0xffff ? 3 : 4;
+
+	/* Where the leading bytes differ, the trailing bytes must cover the full
+	 * continuation range. Split off any partial blocks at either end. */
+	for ( int i = 1; i < len; i++ ) {
+		unsigned long mask = ( 1UL << ( 6 * i ) ) - 1;
+		if ( ( low & ~mask ) != ( high & ~mask ) ) {
+			if ( ( low & mask ) != 0 ) {
+				utf8Split( seqs, low, low | mask );
+				utf8Split( seqs, ( low | mask ) + 1, high );
+				return;
+			}
+			if ( ( high & mask ) != mask ) {
+				utf8Split( seqs, low, ( high & ~mask ) - 1 );
+				utf8Split( seqs, high & ~mask, high );
+				return;
+			}
+		}
+	}
+
+	unsigned long lowBytes[4], highBytes[4];
+	utf8Encode( lowBytes, low, len );
+	utf8Encode( highBytes, high, len );
+
+	UnitSeq seq;
+	seq.len = len;
+	for ( int i = 0; i < len; i++ ) {
+		seq.low[i] = unitKey( lowBytes[i], 8 );
+		seq.high[i] = unitKey( highBytes[i], 8 );
+	}
+	seqs.append( seq );
+}
+
+/* Split a range of code points into blocks whose UTF-16 encodings are the
+ * cross product of one code unit range per position. */
+static void utf16Split( Vector<UnitSeq> &seqs, unsigned long low, unsigned long high )
+{
+	/* Split at the end of the basic multilingual plane and, for a signed 16
+	 * bit alphabet, where the keys wrap to negative. */
+	if ( low <= 0xffff && high > 0xffff ) {
+		utf16Split( seqs, low, 0xffff );
+		utf16Split( seqs, 0x10000, high );
+		return;
+	}
+	if ( unitWraps( 16 ) && low <= 0x7fff && high > 0x7fff ) {
+		utf16Split( seqs, low, 0x7fff );
+		utf16Split( seqs, 0x8000, high );
+		return;
+	}
+
+	UnitSeq seq;
+	if ( high <= 0xffff ) {
+		seq.len = 1;
+		seq.low[0] = unitKey( low, 16 );
+		seq.high[0] = unitKey( high, 16 );
+	}
+	else {
+		/* Surrogate pairs. Where the high surrogates differ the low
+		 * surrogates must cover the full range. */
+		if ( ( low & ~0x3ffUL ) != ( high & ~0x3ffUL ) ) {
+			if ( ( low & 0x3ff ) != 0 ) {
+				utf16Split( seqs, low, low | 0x3ff );
+				utf16Split( seqs, ( low | 0x3ff ) + 1, high );
+				return;
+			}
+			if ( ( high & 0x3ff ) != 0x3ff ) {
+				utf16Split( seqs, low, ( high & ~0x3ffUL ) - 1 );
+				utf16Split( seqs, high & ~0x3ffUL, high );
+				return;
+			}
+		}
+
+		seq.len = 2;
+		seq.low[0] = unitKey( 0xd800 + ( ( low - 0x10000 ) >> 10 ), 16 );
+		seq.high[0] = unitKey( 0xd800 + ( ( high - 0x10000 ) >> 10 ), 16 );
+		seq.low[1] = unitKey( 0xdc00 + ( low & 0x3ff ), 16 );
+		seq.high[1] = unitKey( 0xdc00 + ( high & 0x3ff ), 16 );
+	}
+	seqs.append( seq );
+}
+
+/* Split code point ranges into unit sequences, leaving out the surrogate
+ * block and anything past the last code point. */
+static void unitSeqs( Vector<UnitSeq> &seqs, const CodeRange *ranges, int len, 
+		void (*split)( Vector<UnitSeq> &, unsigned long, unsigned long ) )
+{
+	for ( int r = 0; r < len; r++ ) {
+		unsigned long low = ranges[r].low;
+		unsigned long high = ranges[r].high;
+		if ( high > 0x10ffff )
+			high = 0x10ffff;
+		if ( low > high )
+			continue;
+
+		if ( low < 0xd800 )
+			split( seqs, low, high < 0xd800 ? high : 0xd7ff );
+		if ( high > 0xdfff )
+			split( seqs, low > 0xdfff ? low : 0xe000, high );
+	}
+
+	MergeSort<UnitSeq, CmpUnitSeq> mergeSort;
+	mergeSort.sort( seqs.data, seqs.length() );
+}
+
+/* Build a trie from sorted unit sequences. All sequences end in a single
+ * final state. Since each unit range following a shared prefix is either
+ * equal to or disjoint from its siblings, the result is deterministic and
+ * minimization only needs to share the suffixes. */
+static void unitSeqFsm( FsmAp *fsm, Vector<UnitSeq> &seqs )
+{
+	fsm->setStartState( fsm->addState() );
+	StateAp *final = fsm->addState();
+	fsm->setFinState( final );
+
+	for ( Vector<UnitSeq>::Iter seq = seqs; seq.lte(); seq++ ) {
+		StateAp *from = fsm->startState;
+		for ( int i = 0; i < seq->len - 1; i++ ) {
+			/* Sequences with a common prefix are adjacent so any shared
+			 * transition is the last one out of the state. */
+			TransAp *tail = from->outList.tail;
+			if ( tail != 0 && tail->lowKey == seq->low[i] && 
+					tail->highKey == seq->high[i] )
+			{
+				from = tail->ctList.head->toState;
+			}
+			else {
+				StateAp *to = fsm->addState();
+				fsm->attachNewTrans( from, to, seq->low[i], seq->high[i] );
+				from = to;
+			}
+		}
+
+		int last = seq->len - 1;
+		fsm->attachNewTrans( from, final, seq->low[last], seq->high[last] );
+	}
+
+	fsm->minimizePartition2();
+}
+
+/* Construct a machine that matches the UTF-8 encoding of any code point in
+ * the given ranges. The ranges must not overlap. Surrogates are not valid
+ * code points and are left out. */
+void FsmAp::utf8RangeFsm( const CodeRange *ranges, int len )
+{
+	Vector<UnitSeq> seqs;
+	unitSeqs( seqs, ranges, len, utf8Split );
+	unitSeqFsm( this, seqs );
+}
+
+/* Construct a machine that matches the UTF-16 encoding of any code point in
+ * the given ranges. The same restrictions as utf8RangeFsm apply. */
+void FsmAp::utf16RangeFsm( const CodeRange *ranges, int len )
+{
+	Vector<UnitSeq> seqs;
+	unitSeqs( seqs, ranges, len, utf16Split );
+	unitSeqFsm( this, seqs );
+}
+
 /* Construct a machine that matches the empty string.  A new machine will be
  * made with only one state. The new state will be both a start and final
  * state. IsSigned determines if the machine has a signed or unsigned
@@ -225,7 +620,7 @@ void FsmAp::starOp( )
 	 * follow it in the final state set. This will be determined by the order
 	 * of items in the final state set. To prevent this we just merge with the
 	 * start on a second pass. */
-	for ( StateSet::Iter st = finStateSet; st.lte(); st++ ) {
+	for ( FinStateSet::Iter st = finStateSet; st.lte(); st++ ) {
 		if ( *st != startState )
 			mergeStatesLeaving( md, *st, startState );
 	}
@@ -285,7 +680,7 @@ void FsmAp::optionalRepeatOp( int times )
 	/* The state set used in the from end of the concatentation. Starts with
 	 * the initial final state set, then after each concatenation, gets set to
 	 * the the final states that come from the the duplicate. */
-	StateSet lastFinSet( finStateSet );
+	StateVect lastFinSet( finStateSet );
 
 	/* Set the initial state to zero to allow zero copies. */
 	setFinState( startState );
@@ -306,7 +701,7 @@ void FsmAp::optionalRepeatOp( int times )
 			 * the bits. */
 			StateAp *fs = finStateSet[i];
 			if ( fs->stateBits & STB_GRAPH2 ) {
-				lastFinSet.insert( fs );
+				lastFinSet.append( fs );
 				fs->stateBits &= ~STB_GRAPH2;
 			}
 		}
@@ -319,10 +714,11 @@ void FsmAp::optionalRepeatOp( int times )
 
 /* Fsm concatentation worker. Supports treating the concatentation as optional,
  * which essentially leaves the final states of machine one as final. */
-void FsmAp::doConcat( FsmAp *other, StateSet *fromStates, bool optional )
+void FsmAp::doConcat( FsmAp *other, StateVect *fromStates, bool optional )
 {
 	/* For the merging process. */
-	StateSet finStateSetCopy, startStateSet;
+	StateVect finStateSetCopy;
+	StateSet startStateSet;
 	MergeData md;
 
 	/* Turn on misfit accounting for both graphs. */
@@ -703,7 +1099,7 @@ void FsmAp::joinOp( int startId, int finalId, FsmAp **others, int numOthers )
 	/* Take a copy of the final state set, before unsetting them all. This
 	 * will allow us to call clearOutData on the states that don't get
 	 * final state status back back. */
-	StateSet finStateSetCopy = finStateSet;
+	StateVect finStateSetCopy = finStateSet;
 
 	/* Now all final states are unset. */
 	unsetAllFinStates();
@@ -726,7 +1122,7 @@ void FsmAp::joinOp( int startId, int finalId, FsmAp **others, int numOthers )
 
 	/* Invoke the relinquish final callback on any states that did not get
 	 * final state status back. */
-	for ( StateSet::Iter st = finStateSetCopy; st.lte(); st++ ) {
+	for ( FinStateSet::Iter st = finStateSetCopy; st.lte(); st++ ) {
 		if ( !((*st)->stateBits & STB_ISFINAL) )
 			clearOutData( *st );
 	}
@@ -815,7 +1211,7 @@ void FsmAp::deterministicEntry()
 void FsmAp::unsetKilledFinals()
 {
 	/* Duplicate the final state set before we begin modifying it. */
-	StateSet fin( finStateSet );
+	StateVect fin( finStateSet );
 
 	for ( int s = 0; s < fin.length(); s++ ) {
 		/* Check for killing bit. */
@@ -835,7 +1231,7 @@ void FsmAp::unsetKilledFinals()
 void FsmAp::unsetIncompleteFinals()
 {
 	/* Duplicate the final state set before we begin modifying it. */
-	StateSet fin( finStateSet );
+	StateVect fin( finStateSet );
 
 	for ( int s = 0; s < fin.length(); s++ ) {
 		/* Check for one set but not the other. */
@@ -1290,3 +1686,20 @@ bool FsmAp::checkSingleCharMachine()
 	return true;
 }
 
+/* Check if every word the machine accepts is a single character. Unlike
+ * checkSingleCharMachine, any number of keys and ranges may lead out of the
+ * start state. */
+bool FsmAp::checkSingleCharClass()
+{
+	/* The start state cannot be final and must move on some key. */
+	if ( startState->isFinState() || startState->outList.length() == 0 )
+		return false;
+	/* All other states must be final with no transitions out. */
+	for ( StateList::Iter state = stateList; state.lte(); state++ ) {
+		if ( state != startState && ( !state->isFinState() || 
+				state->outList.length() != 0 ) )
+			return false;
+	}
+	return true;
+}
+
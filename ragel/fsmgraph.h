@@ -40,8 +40,6 @@
 #include "avlmap.h"
 #include "ragel.h"
 
-#define LOG_CONDS 1
-
 /* Flags that control merging. */
 #define STB_GRAPH1     0x01
 #define STB_GRAPH2     0x02
@@ -59,6 +57,7 @@ struct Action;
 struct LongestMatchPart;
 struct LengthDef;
 struct CondSpace;
+struct CodeRange;
 
 /* State list element for unambiguous access to list element. */
 struct FsmListEl 
@@ -498,6 +497,20 @@ typedef DList<TransAp> TransList;
 /* Set of states, list of states. */
 typedef BstSet<StateAp*> StateSet;
 typedef DList<StateAp> StateList;
+typedef Vector<StateAp*> StateVect;
+
+/* The final states of a machine. A final state records its position in the
+ * set, so states are added and removed in constant time. Removing a state
+ * moves the last state into its place, so the set is not sorted. */
+struct FinStateSet
+	: public StateVect
+{
+	void insert( StateAp *state );
+	void remove( StateAp *state );
+
+	/* Move all the states of other into this set. */
+	void insert( FinStateSet &other );
+};
 
 /* A element in a state dict. */
 struct StateDictEl 
@@ -560,11 +573,14 @@ typedef BstSet<Key, CmpKey> KeySet;
 
 struct MinPartition 
 {
-	MinPartition() : active(false) { }
+	MinPartition() : active(false), touched(false) { }
 
 	StateList list;
 	bool active;
 
+	/* Reached by a split while waiting to be split itself. */
+	bool touched;
+
 	MinPartition *prev, *next;
 };
 
@@ -782,6 +798,9 @@ struct StateAp
 	/* Bits controlling the behaviour of the state during collapsing to dfa. */
 	int stateBits;
 
+	/* Position in the final state set of the owning machine. */
+	int finIndex;
+
 	/* State list elements. */
 	StateAp *next, *prev;
 
@@ -1169,7 +1188,7 @@ struct FsmAp
 	StateAp *errState;
 
 	/* The set of final states. */
-	StateSet finStateSet;
+	FinStateSet finStateSet;
 
 	/* Misfit Accounting. Are misfits put on a separate list. */
 	bool misfitAccounting;
@@ -1254,6 +1273,17 @@ struct FsmAp
 	 * operation.  */
 	int shiftStartActionOrder( int fromOrder );
 
+	/* Add shift to the action and priority orderings that are at least
+	 * fromOrder and below toOrder. Gives a copy of a machine the orderings
+	 * it would have had if it were built at a later point. */
+	void shiftActionOrdering( int fromOrder, int toOrder, int shift );
+	void shiftPriorOrdering( int fromOrder, int toOrder, int shift );
+
+	/* Make transitions with equal action and priority tables share one copy
+	 * of the table data. Shared tables compare equal without looking at their
+	 * elements. */
+	void internTables();
+
 	/* Clear all priorities from the fsm to so they won't affcet minimization
 	 * of the final fsm. */
 	void clearAllPriorities();
@@ -1324,7 +1354,8 @@ struct FsmAp
 	CondAp *fsmAttachStates( MergeData &md, StateAp *from,
 			CondAp *destTrans, CondAp *srcTrans );
 
-	void expandConds( StateAp *fromState, TransAp *trans, const CondSet &origSet, const CondSet &mergedCS );
+	void expandConds( StateAp *fromState, TransAp *trans, const CondSet &origSet,
+			const CondSet &mergedCS, bool attached );
 	void expandCondTransitions( StateAp *fromState, TransAp *destTrans, TransAp *srcTrans );
 	TransAp *copyTransForExpanision( StateAp *fromState, TransAp *srcTrans );
 	void freeEffectiveTrans( TransAp *srcTrans );
@@ -1422,9 +1453,12 @@ struct FsmAp
 	void concatFsm( Key c );
 	void concatFsm( Key *str, int len );
 	void concatFsmCI( Key *str, int len );
+	void unionLiteralsFsm( Key **strs, long *lens, long num, bool caseInsensitive );
 	void orFsm( Key *set, int len );
 	void rangeFsm( Key low, Key high );
 	void rangeStarFsm( Key low, Key high );
+	void utf8RangeFsm( const CodeRange *ranges, int len );
+	void utf16RangeFsm( const CodeRange *ranges, int len );
 	void emptyFsm( );
 	void lambdaFsm( );
 
@@ -1462,7 +1496,7 @@ struct FsmAp
 	void resolveEpsilonTrans( MergeData &md );
 
 	/* Workers for concatenation and union. */
-	void doConcat( FsmAp *other, StateSet *fromStates, bool optional );
+	void doConcat( FsmAp *other, StateVect *fromStates, bool optional );
 	void doOr( FsmAp *other );
 
 	/*
@@ -1552,6 +1586,9 @@ struct FsmAp
 	 * states that have identical out transitions. */
 	bool minimizeRound( );
 
+	/* Merge states with identical out transitions in one hashed pass. */
+	bool mergeDuplicateStates();
+
 	/* Given an intial partioning of states, split partitions that have out trans
 	 * to differing partitions. */
 	int partitionRound( StateAp **statePtrs, MinPartition *parts, int numParts );
@@ -1560,6 +1597,10 @@ struct FsmAp
 	 * there are no more partitions to split. */
 	int splitCandidates( StateAp **statePtrs, MinPartition *parts, int numParts );
 
+	/* Split one sorted partition and queue the partitions it may split. */
+	int splitPartition( StateAp **statePtrs, MinPartition *parts, int numParts,
+			MinPartition *partition, PartitionList &partList, PartitionList &splittable );
+
 	/* Fuse together states in the same partition. */
 	void fusePartitions( MinPartition *parts, int numParts );
 
@@ -1596,6 +1637,9 @@ struct FsmAp
 	/* Check if a machine defines a single character. This is useful in
 	 * validating ranges and machines to export. */
 	bool checkSingleCharMachine( );
+
+	/* Check if all words of a machine are one character long. */
+	bool checkSingleCharClass( );
 };
 
 #endif
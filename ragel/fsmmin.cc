@@ -22,10 +22,246 @@
 #include "fsmgraph.h"
 #include "mergesort.h"
 
+#ifdef HAVE_LIBPTHREAD
+#include <pthread.h>
+#endif
+
+/* Partitions with fewer states than this are sorted by one thread. */
+#define PARALLEL_SORT_MIN 4096
+
+#ifdef HAVE_LIBPTHREAD
+
+/* One run of states, sorted or merged by a thread. */
+struct SortRun
+{
+	StateAp **data;
+	StateAp **tmpStor;
+	long mid, len;
+	pthread_t thread;
+	bool started;
+};
+
+template <class Compare> static void *sortRun( void *arg )
+{
+	SortRun *run = (SortRun*)arg;
+	MergeSort<StateAp*, Compare> mergeSort;
+	mergeSort.sort( run->data, run->len );
+	return 0;
+}
+
+/* Merge the two sorted halves of a run. Taking from the lower half on equal
+ * states keeps the merge stable. */
+template <class Compare> static void *mergeRun( void *arg )
+{
+	SortRun *run = (SortRun*)arg;
+	Compare compare;
+	StateAp **lower = run->data, **endLower = run->data + run->mid;
+	StateAp **upper = endLower, **endUpper = run->data + run->len;
+	StateAp **dest = run->tmpStor;
+	while ( lower < endLower && upper < endUpper ) {
+		if ( compare.compare( *lower, *upper ) <= 0 )
+			*dest++ = *lower++;
+		else
+			*dest++ = *upper++;
+	}
+	while ( lower < endLower )
+		*dest++ = *lower++;
+	while ( upper < endUpper )
+		*dest++ = *upper++;
+
+	memcpy( run->data, run->tmpStor, sizeof(StateAp*) * run->len );
+	return 0;
+}
+
+/* Run the worker on all the runs, the first one in this thread. A run whose
+ * thread cannot be created is also done in this thread. */
+static void runThreads( void *(*worker)(void*), SortRun *runs, int numRuns )
+{
+	for ( int r = 1; r < numRuns; r++ )
+		runs[r].started = pthread_create( &runs[r].thread, 0, worker, &runs[r] ) == 0;
+	worker( &runs[0] );
+	for ( int r = 1; r < numRuns; r++ ) {
+		if ( runs[r].started )
+			pthread_join( runs[r].thread, 0 );
+		else
+			worker( &runs[r] );
+	}
+}
+
+/* Sort runs of the states in separate threads, then merge neighbouring runs
+ * in pairs until one is left. Merge sort is stable, so the result is the same
+ * as sorting with one thread. */
+template <class Compare> static void parallelSort( StateAp **statePtrs, long numStates )
+{
+	int numRuns = minimizeThreads;
+	if ( numRuns > numStates / (PARALLEL_SORT_MIN / 2) )
+		numRuns = numStates / (PARALLEL_SORT_MIN / 2);
+
+	SortRun *runs = new SortRun[numRuns];
+	for ( int r = 0; r < numRuns; r++ ) {
+		long start = numStates * r / numRuns;
+		runs[r].data = statePtrs + start;
+		runs[r].len = numStates * (r+1) / numRuns - start;
+	}
+	runThreads( sortRun<Compare>, runs, numRuns );
+
+	StateAp **tmpStor = new StateAp*[numStates];
+	while ( numRuns > 1 ) {
+		/* Pair up the runs. An odd one out is carried to the next round. */
+		int numMerged = 0;
+		for ( int r = 0; r + 1 < numRuns; r += 2 ) {
+			SortRun &merged = runs[numMerged++];
+			merged.data = runs[r].data;
+			merged.tmpStor = tmpStor + ( runs[r].data - statePtrs );
+			merged.mid = runs[r].len;
+			merged.len = runs[r].len + runs[r+1].len;
+		}
+		runThreads( mergeRun<Compare>, runs, numMerged );
+
+		if ( numRuns % 2 == 1 )
+			runs[numMerged++] = runs[numRuns-1];
+		numRuns = numMerged;
+	}
+
+	delete[] tmpStor;
+	delete[] runs;
+}
+
+/* A partition sorted by the pool. */
+struct SortJob
+{
+	MinPartition *partition;
+	StateAp **data;
+	long len;
+};
+
+/* Threads that sort the partitions of a batch, each with one thread. They are
+ * started once for a minimization and wait for work between batches. A thread
+ * that cannot be created leaves its share of the work to the others. */
+struct SortPool
+{
+	SortPool( int numThreads );
+	~SortPool();
+
+	void sort( SortJob *jobs, int numJobs );
+	void runJobs();
+	static void *worker( void *arg );
+
+	pthread_mutex_t mutex;
+	pthread_cond_t workReady;
+	pthread_cond_t workDone;
+	pthread_t *threads;
+	int numThreads;
+
+	SortJob *jobs;
+	int numJobs, nextJob, jobsLeft;
+	bool quit;
+};
+
+SortPool::SortPool( int numThreads )
+:
+	numThreads(0),
+	jobs(0),
+	numJobs(0),
+	nextJob(0),
+	jobsLeft(0),
+	quit(false)
+{
+	pthread_mutex_init( &mutex, 0 );
+	pthread_cond_init( &workReady, 0 );
+	pthread_cond_init( &workDone, 0 );
+
+	/* The calling thread is one of the sorters. */
+	threads = new pthread_t[numThreads-1];
+	for ( int t = 0; t < numThreads-1; t++ ) {
+		if ( pthread_create( &threads[this->numThreads], 0, worker, this ) == 0 )
+			this->numThreads += 1;
+	}
+}
+
+SortPool::~SortPool()
+{
+	pthread_mutex_lock( &mutex );
+	quit = true;
+	pthread_cond_broadcast( &workReady );
+	pthread_mutex_unlock( &mutex );
+
+	for ( int t = 0; t < numThreads; t++ )
+		pthread_join( threads[t], 0 );
+	delete[] threads;
+
+	pthread_cond_destroy( &workDone );
+	pthread_cond_destroy( &workReady );
+	pthread_mutex_destroy( &mutex );
+}
+
+/* Take jobs until none are left. Called and returns with the mutex held. */
+void SortPool::runJobs()
+{
+	while ( nextJob < numJobs ) {
+		SortJob *job = &jobs[nextJob++];
+		pthread_mutex_unlock( &mutex );
+
+		MergeSort<StateAp*, PartitionCompare> mergeSort;
+		mergeSort.sort( job->data, job->len );
+
+		pthread_mutex_lock( &mutex );
+		if ( --jobsLeft == 0 )
+			pthread_cond_signal( &workDone );
+	}
+}
+
+void *SortPool::worker( void *arg )
+{
+	SortPool *pool = (SortPool*)arg;
+	pthread_mutex_lock( &pool->mutex );
+	while ( true ) {
+		while ( !pool->quit && pool->nextJob == pool->numJobs )
+			pthread_cond_wait( &pool->workReady, &pool->mutex );
+		if ( pool->quit )
+			break;
+		pool->runJobs();
+	}
+	pthread_mutex_unlock( &pool->mutex );
+	return 0;
+}
+
+/* Sort every job and return when all are done. */
+void SortPool::sort( SortJob *jobs, int numJobs )
+{
+	pthread_mutex_lock( &mutex );
+	this->jobs = jobs;
+	this->numJobs = numJobs;
+	nextJob = 0;
+	jobsLeft = numJobs;
+	pthread_cond_broadcast( &workReady );
+
+	runJobs();
+	while ( jobsLeft > 0 )
+		pthread_cond_wait( &workDone, &mutex );
+	pthread_mutex_unlock( &mutex );
+}
+
+#endif
+
+/* Sort the states of a partition. Large partitions are sorted with
+ * minimizeThreads threads. */
+template <class Compare> static void sortStates( StateAp **statePtrs, long numStates )
+{
+#ifdef HAVE_LIBPTHREAD
+	if ( minimizeThreads > 1 && numStates >= PARALLEL_SORT_MIN ) {
+		parallelSort<Compare>( statePtrs, numStates );
+		return;
+	}
+#endif
+
+	MergeSort<StateAp*, Compare> mergeSort;
+	mergeSort.sort( statePtrs, numStates );
+}
+
 int FsmAp::partitionRound( StateAp **statePtrs, MinPartition *parts, int numParts )
 {
-	/* Need a mergesort object and a single partition compare. */
-	MergeSort<StateAp*, PartitionCompare> mergeSort;
+	/* Need a single partition compare. */
 	PartitionCompare partCompare;
 
 	/* For each partition. */
@@ -37,7 +273,7 @@ int FsmAp::partitionRound( StateAp **statePtrs, MinPartition *parts, int numPart
 
 		/* Sort the states using the partitioning compare. */
 		int numStates = parts[p].list.length();
-		mergeSort.sort( statePtrs, numStates );
+		sortStates<PartitionCompare>( statePtrs, numStates );
 
 		/* Assign the states into partitions based on the results of the sort. */
 		int destPart = p, firstNewPart = numParts;
@@ -78,14 +314,16 @@ int FsmAp::partitionRound( StateAp **statePtrs, MinPartition *parts, int numPart
  */
 void FsmAp::minimizePartition1()
 {
-	/* Need one mergesort object and partition compares. */
-	MergeSort<StateAp*, InitPartitionCompare> mergeSort;
+	/* Need an initial partition compare. */
 	InitPartitionCompare initPartCompare;
 
 	/* Nothing to do if there are no states. */
 	if ( stateList.length() == 0 )
 		return;
 
+	/* Share equal transition tables so most table compares are cheap. */
+	internTables();
+
 	/* 
 	 * First thing is to partition the states by final state status and
 	 * transition functions. This gives us an initial partitioning to work
@@ -102,7 +340,7 @@ void FsmAp::minimizePartition1()
 		statePtrs[s] = state;
 		
 	/* Sort the states using the array of states. */
-	mergeSort.sort( statePtrs, numStates );
+	sortStates<InitPartitionCompare>( statePtrs, numStates );
 
 	/* An array of lists of states is used to partition the states. */
 	MinPartition *parts = new MinPartition[numStates];
@@ -147,19 +385,107 @@ void FsmAp::minimizePartition1()
 	delete[] parts;
 }
 
+/* Split a partition whose states are sorted in statePtrs. The partitions that
+ * may need splitting as a result go on the splittable list. */
+int FsmAp::splitPartition( StateAp **statePtrs, MinPartition *parts, int numParts,
+		MinPartition *partition, PartitionList &partList, PartitionList &splittable )
+{
+	/* Need a partition compare. */
+	PartitionCompare partCompare;
+
+	/* Assign the states into partitions based on the results of the sort. */
+	int numStates = partition->list.length();
+	MinPartition *destPart = partition;
+	int firstNewPart = numParts;
+	for ( int s = 1; s < numStates; s++ ) {
+		/* If this state differs from the last then move to the next partition. */
+		if ( partCompare.compare( statePtrs[s-1], statePtrs[s] ) < 0 ) {
+			/* The new partition is the next avail spot. */
+			destPart = &parts[numParts];
+			numParts += 1;
+		}
+
+		/* If the state is not staying in the first partition, then
+		 * transfer it to its destination partition. */
+		if ( destPart != partition ) {
+			StateAp *state = partition->list.detach( statePtrs[s] );
+			destPart->list.append( state );
+		}
+	}
+
+	/* Fix the partition pointer for all the states that got moved to a new
+	 * partition. This must be done after the states are transfered so the
+	 * result of the sort is not altered. */
+	int newPart;
+	for ( newPart = firstNewPart; newPart < numParts; newPart++ ) {
+		StateList::Iter state = parts[newPart].list;
+		for ( ; state.lte(); state++ )
+			state->alg.partition = &parts[newPart];
+	}
+
+	/* Put the partition we just split and any new partitions that came out
+	 * of the split onto the inactive list. A partition touched by a split
+	 * made after it was sorted was sorted against old partitions, so then
+	 * they all go back onto the splittable list. */
+	PartitionList &destList = partition->touched ? splittable : partList;
+	partition->active = partition->touched;
+	destList.append( partition );
+	for ( newPart = firstNewPart; newPart < numParts; newPart++ ) {
+		parts[newPart].active = partition->touched;
+		destList.append( &parts[newPart] );
+	}
+
+	if ( destPart == partition )
+		return numParts;
+
+	/* Now determine which partitions are splittable as a result of
+	 * splitting partition by walking the in lists of the states in
+	 * partitions that got split. Partition is the faked first item in the
+	 * loop. */
+	MinPartition *causalPart = partition;
+	newPart = firstNewPart - 1;
+	while ( newPart < numParts ) {
+		/* Loop all states in the causal partition. */
+		StateList::Iter state = causalPart->list;
+		for ( ; state.lte(); state++ ) {
+			/* Walk all transition into the state and put the partition
+			 * that the from state is in onto the splittable list. An active
+			 * partition is either waiting or sorted and waiting to be split,
+			 * so it is only marked. */
+			for ( TransInList<CondAp>::Iter t = state->inList; t.lte(); t++ ) {
+				TransAp *trans = t->transAp;
+				MinPartition *fromPart = trans->ctList.head->fromState->alg.partition;
+				if ( ! fromPart->active ) {
+					fromPart->active = true;
+					partList.detach( fromPart );
+					splittable.append( fromPart );
+				}
+				else {
+					fromPart->touched = true;
+				}
+			}
+		}
+
+		newPart += 1;
+		causalPart = &parts[newPart];
+	}
+
+	return numParts;
+}
+
 /* Split partitions that need splittting, decide which partitions might need
  * to be split as a result, continue until there are no more that might need
  * to be split. */
 int FsmAp::splitCandidates( StateAp **statePtrs, MinPartition *parts, int numParts )
 {
-	/* Need a mergesort and a partition compare. */
-	MergeSort<StateAp*, PartitionCompare> mergeSort;
-	PartitionCompare partCompare;
-
 	/* The lists of unsplitable (partList) and splitable partitions. 
 	 * Only partitions in the splitable list are check for needing splitting. */
 	PartitionList partList, splittable;
 
+	/* Eof targets are not on in lists, so a split does not reach the
+	 * partitions of the states that have them. */
+	bool eofTargets = false;
+
 	/* Initially, all partitions are born from a split (the initial
 	 * partitioning) and can cause other partitions to be split. So any
 	 * partition with a state with a transition out to another partition is a
@@ -171,12 +497,13 @@ int FsmAp::splitCandidates( StateAp **statePtrs, MinPartition *parts, int numPar
 
 		/* Look for a trans out of any state in the partition. */
 		for ( StateList::Iter state = parts[p].list; state.lte(); state++ ) {
+			if ( state->eofTarget != 0 )
+				eofTargets = true;
+
 			/* If there is at least one transition out to another state then 
 			 * the partition becomes splittable. */
-			if ( state->outList.length() > 0 ) {
+			if ( state->outList.length() > 0 )
 				parts[p].active = true;
-				break;
-			}
 		}
 
 		/* If it was found active then it goes on the splittable list. */
@@ -186,11 +513,65 @@ int FsmAp::splitCandidates( StateAp **statePtrs, MinPartition *parts, int numPar
 			partList.append( &parts[p] );
 	}
 
+#ifdef HAVE_LIBPTHREAD
+	/* With several threads, all the splittable partitions are sorted at once,
+	 * against the partitions as they are before any of them is split. Then
+	 * they are split in order. The partitions that come out are the same as
+	 * when splitting one at a time, only their order differs, and the machine
+	 * is renumbered depth first when it is written. */
+	if ( minimizeThreads > 1 && !eofTargets ) {
+		SortPool pool( minimizeThreads );
+		Vector<SortJob> jobs;
+		while ( splittable.length() > 0 ) {
+			/* Lay the partitions out one after another in the pointer array.
+			 * They stay active while they wait, so a split that reaches one
+			 * only marks it touched. */
+			long batchStates = 0;
+			jobs.empty();
+			while ( splittable.length() > 0 ) {
+				SortJob job;
+				job.partition = splittable.detachFirst();
+				job.partition->touched = false;
+				job.data = statePtrs + batchStates;
+				job.len = job.partition->list.length();
+
+				StateList::Iter state = job.partition->list;
+				for ( int s = 0; state.lte(); state++, s++ )
+					job.data[s] = state;
+
+				batchStates += job.len;
+				jobs.append( job );
+			}
+
+			/* One partition is sorted with all threads, a small batch in this
+			 * thread alone. */
+			if ( jobs.length() == 1 )
+				sortStates<PartitionCompare>( jobs[0].data, jobs[0].len );
+			else if ( batchStates < PARALLEL_SORT_MIN ) {
+				for ( int j = 0; j < jobs.length(); j++ ) {
+					MergeSort<StateAp*, PartitionCompare> mergeSort;
+					mergeSort.sort( jobs[j].data, jobs[j].len );
+				}
+			}
+			else {
+				pool.sort( jobs.data, jobs.length() );
+			}
+
+			for ( int j = 0; j < jobs.length(); j++ ) {
+				numParts = splitPartition( jobs[j].data, parts, numParts,
+						jobs[j].partition, partList, splittable );
+			}
+		}
+		return numParts;
+	}
+#endif
+
 	/* While there are partitions that are splittable, pull one off and try
 	 * to split it. If it splits, determine which partitions may now be split
 	 * as a result of the newly split partition. */
 	while ( splittable.length() > 0 ) {
 		MinPartition *partition = splittable.detachFirst();
+		partition->touched = false;
 
 		/* Fill the pointer array with the states in the partition. */
 		StateList::Iter state = partition->list;
@@ -199,75 +580,10 @@ int FsmAp::splitCandidates( StateAp **statePtrs, MinPartition *parts, int numPar
 
 		/* Sort the states using the partitioning compare. */
 		int numStates = partition->list.length();
-		mergeSort.sort( statePtrs, numStates );
-
-		/* Assign the states into partitions based on the results of the sort. */
-		MinPartition *destPart = partition;
-		int firstNewPart = numParts;
-		for ( int s = 1; s < numStates; s++ ) {
-			/* If this state differs from the last then move to the next partition. */
-			if ( partCompare.compare( statePtrs[s-1], statePtrs[s] ) < 0 ) {
-				/* The new partition is the next avail spot. */
-				destPart = &parts[numParts];
-				numParts += 1;
-			}
-
-			/* If the state is not staying in the first partition, then
-			 * transfer it to its destination partition. */
-			if ( destPart != partition ) {
-				StateAp *state = partition->list.detach( statePtrs[s] );
-				destPart->list.append( state );
-			}
-		}
-
-		/* Fix the partition pointer for all the states that got moved to a new
-		 * partition. This must be done after the states are transfered so the
-		 * result of the sort is not altered. */
-		int newPart;
-		for ( newPart = firstNewPart; newPart < numParts; newPart++ ) {
-			StateList::Iter state = parts[newPart].list;
-			for ( ; state.lte(); state++ )
-				state->alg.partition = &parts[newPart];
-		}
+		sortStates<PartitionCompare>( statePtrs, numStates );
 
-		/* Put the partition we just split and any new partitions that came out
-		 * of the split onto the inactive list. */
-		partition->active = false;
-		partList.append( partition );
-		for ( newPart = firstNewPart; newPart < numParts; newPart++ ) {
-			parts[newPart].active = false;
-			partList.append( &parts[newPart] );
-		}
-
-		if ( destPart == partition )
-			continue;
-
-		/* Now determine which partitions are splittable as a result of
-		 * splitting partition by walking the in lists of the states in
-		 * partitions that got split. Partition is the faked first item in the
-		 * loop. */
-		MinPartition *causalPart = partition;
-		newPart = firstNewPart - 1;
-		while ( newPart < numParts ) {
-			/* Loop all states in the causal partition. */
-			StateList::Iter state = causalPart->list;
-			for ( ; state.lte(); state++ ) {
-				/* Walk all transition into the state and put the partition
-				 * that the from state is in onto the splittable list. */
-				for ( TransInList<CondAp>::Iter t = state->inList; t.lte(); t++ ) {
-					TransAp *trans = t->transAp;
-					MinPartition *fromPart = trans->ctList.head->fromState->alg.partition;
-					if ( ! fromPart->active ) {
-						fromPart->active = true;
-						partList.detach( fromPart );
-						splittable.append( fromPart );
-					}
-				}
-			}
-
-			newPart += 1;
-			causalPart = &parts[newPart];
-		}
+		numParts = splitPartition( statePtrs, parts, numParts, partition,
+				partList, splittable );
 	}
 	return numParts;
 }
@@ -282,14 +598,16 @@ int FsmAp::splitCandidates( StateAp **statePtrs, MinPartition *parts, int numPar
  */
 void FsmAp::minimizePartition2()
 {
-	/* Need a mergesort and an initial partition compare. */
-	MergeSort<StateAp*, InitPartitionCompare> mergeSort;
+	/* Need an initial partition compare. */
 	InitPartitionCompare initPartCompare;
 
 	/* Nothing to do if there are no states. */
 	if ( stateList.length() == 0 )
 		return;
 
+	/* Share equal transition tables so most table compares are cheap. */
+	internTables();
+
 	/* 
 	 * First thing is to partition the states by final state status and
 	 * transition functions. This gives us an initial partitioning to work
@@ -306,7 +624,7 @@ void FsmAp::minimizePartition2()
 		statePtrs[s] = state;
 		
 	/* Sort the states using the array of states. */
-	mergeSort.sort( statePtrs, numStates );
+	sortStates<InitPartitionCompare>( statePtrs, numStates );
 
 	/* An array of lists of states is used to partition the states. */
 	MinPartition *parts = new MinPartition[numStates];
@@ -407,6 +725,9 @@ bool FsmAp::markRound( MarkIndex &markIndex )
  */
 void FsmAp::minimizeStable()
 {
+	/* Share equal transition tables so most table compares are cheap. */
+	internTables();
+
 	/* Set the state numbers. */
 	setStateNumbers( 0 );
 
@@ -470,6 +791,80 @@ bool FsmAp::minimizeRound()
 	return modified;
 }
 
+/* A state with a hash of its finality and out transitions. */
+struct StateHashEl
+{
+	unsigned long hash;
+	StateAp *state;
+};
+
+struct CmpStateHash
+{
+	static int compare( const StateHashEl &el1, const StateHashEl &el2 )
+	{
+		if ( el1.hash < el2.hash )
+			return -1;
+		else if ( el1.hash > el2.hash )
+			return 1;
+		return 0;
+	}
+};
+
+static unsigned long hashState( StateAp *state )
+{
+	unsigned long hash = state->stateBits & STB_ISFINAL ? 1 : 0;
+	for ( TransList::Iter trans = state->outList; trans.lte(); trans++ ) {
+		hash = hash * 31 + trans->lowKey.getVal();
+		hash = hash * 31 + trans->highKey.getVal();
+		for ( CondTransList::Iter cond = trans->ctList; cond.lte(); cond++ ) {
+			hash = hash * 31 + cond->lowKey.getVal();
+			hash = hash * 31 + (unsigned long)cond->toState;
+		}
+	}
+	return hash;
+}
+
+/* Merges states with identical out transitions, like minimizeRound, without
+ * sorting on the full compare. States are grouped by a hash and only states
+ * in the same group are compared. Does not repeat until nothing merges, so
+ * it is a cheap reduction for the operands of expensive operations rather
+ * than a minimization. */
+bool FsmAp::mergeDuplicateStates()
+{
+	if ( stateList.length() == 0 )
+		return false;
+
+	long numStates = stateList.length();
+	StateHashEl *els = new StateHashEl[numStates];
+	StateList::Iter state = stateList;
+	for ( long s = 0; state.lte(); state++, s++ ) {
+		els[s].hash = hashState( state );
+		els[s].state = state;
+	}
+
+	MergeSort<StateHashEl, CmpStateHash> mergeSort;
+	mergeSort.sort( els, numStates );
+
+	/* Fuse runs of equal states within each group. */
+	ApproxCompare approxCompare;
+	bool modified = false;
+	long last = 0;
+	for ( long s = 1; s < numStates; s++ ) {
+		if ( els[s].hash == els[last].hash &&
+				approxCompare.compare( els[last].state, els[s].state ) == 0 )
+		{
+			fuseEquivStates( els[last].state, els[s].state );
+			modified = true;
+		}
+		else {
+			last = s;
+		}
+	}
+
+	delete[] els;
+	return modified;
+}
+
 /**
  * \brief Minmimize by an approximation.
  *
@@ -479,6 +874,9 @@ bool FsmAp::minimizeRound()
  */
 void FsmAp::minimizeApproximate()
 {
+	/* Share equal transition tables so most table compares are cheap. */
+	internTables();
+
 	/* While the last minimization round succeeded in compacting states,
 	 * continue to try to compact states. */
 	while ( true ) {
@@ -95,6 +95,7 @@ StateAp::StateAp()
 
 	/* No state identification bits. */
 	stateBits(0),
+	finIndex(-1),
 
 	/* No Priority data. */
 	outPriorTable(),
@@ -139,6 +140,7 @@ StateAp::StateAp(const StateAp &other)
 
 	/* Fsm state data. */
 	stateBits(other.stateBits),
+	finIndex(-1),
 
 	/* Copy in priority data. */
 	outPriorTable(other.outPriorTable),
@@ -136,12 +136,15 @@ CodeGenData::CodeGenData( const CodeGenArgs &args )
 	tokstartExpr(0),
 	tokendExpr(0),
 	dataExpr(0),
+	countersExpr(0),
 	hasLongestMatch(false),
+	numRepCounters(0),
 	noEnd(false),
 	noPrefix(false),
 	noFinal(false),
 	noError(false),
-	noCS(false)
+	noCS(false),
+	noShift(false)
 {
 	ReducedGen::cgd = this;
 }
@@ -807,6 +810,30 @@ void CodeGenData::writeStatement( InputLoc &loc, int nargs, char **args )
 			write_option_error( loc, args[i] );
 		writeError();
 	}
+	else if ( strcmp( args[0], "refill" ) == 0 ) {
+		for ( int i = 1; i < nargs; i++ ) {
+			if ( strcmp( args[i], "noshift" ) == 0 )
+				noShift = true;
+			else
+				write_option_error( loc, args[i] );
+		}
+
+		/* Only scanners keep a token prefix that needs preserving. */
+		if ( !hasLongestMatch ) {
+			source_error(loc) << "write refill requires a "
+					"longest-match construction" << endl;
+		}
+		else if ( hostLang->lang != HostLang::C && 
+				hostLang->lang != HostLang::D &&
+				hostLang->lang != HostLang::D2 )
+		{
+			source_error(loc) << "write refill is not supported by "
+					"the selected host language" << endl;
+		}
+		else {
+			writeRefill();
+		}
+	}
 	else {
 		/* EMIT An error here. */
 		source_error(loc) << "unrecognized write command \"" << 
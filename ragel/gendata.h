@@ -80,11 +80,35 @@ struct NextRedTrans
 	}
 };
 
+/* A transition range in the key space of a condition space. There is one for
+ * each value of the conditions that leads somewhere. */
+struct WideTransEl
+{
+	Key lowKey, highKey;
+	CondAp *cond;
+};
+
+struct CmpWideTransEl
+{
+	static int compare( const WideTransEl &t1, const WideTransEl &t2 )
+	{
+		if ( t1.lowKey < t2.lowKey )
+			return -1;
+		else if ( t1.lowKey > t2.lowKey )
+			return 1;
+		else
+			return 0;
+	}
+};
+
+typedef Vector<WideTransEl> WideTransList;
+
 struct GenBase
 {
 	GenBase( char *fsmName, ParseData *pd, FsmAp *fsm );
 
 	void appendTrans( TransListVect &outList, Key lowKey, Key highKey, TransAp *trans );
+	void appendWideTrans( WideTransList &wideList, TransAp *trans );
 	void reduceActionTables();
 
 	char *fsmName;
@@ -114,6 +138,11 @@ struct FsmAp;
 typedef AvlMap<char *, CodeGenData*, CmpStr> CodeGenMap;
 typedef AvlMapEl<char *, CodeGenData*> CodeGenMapEl;
 
+/* Arrays written to an output file, keyed by their element type and items.
+ * The value is the name the array was written under. */
+typedef AvlMap<std::string, std::string> SharedArrayMap;
+typedef AvlMapEl<std::string, std::string> SharedArrayMapEl;
+
 void cdLineDirective( ostream &out, const char *fileName, int line );
 void javaLineDirective( ostream &out, const char *fileName, int line );
 void gothicLineDirective( ostream &out, const char *fileName, int line );
@@ -145,6 +174,8 @@ private:
 	void makeLmSwitch( GenInlineList *outList, InlineItem *item );
 	void makeSetTokend( GenInlineList *outList, long offset );
 	void makeSetAct( GenInlineList *outList, long lmId );
+	void makeRepItem( GenInlineList *outList, InlineItem *item, 
+			GenInlineItem::Type type );
 	void makeSubList( GenInlineList *outList, InlineList *inlineList, 
 			GenInlineItem::Type type );
 	void makeTargetItem( GenInlineList *outList, NameInst *nameTarg, GenInlineItem::Type type );
@@ -163,7 +194,7 @@ private:
 	void makeEofTrans( StateAp *state );
 	void makeStateConditions( StateAp *state );
 	void makeTransList( StateAp *state );
-	void makeTrans( Key lowKey, Key highKey, TransAp *trans );
+	void makeTrans( Key lowKey, Key highKey, CondAp *cond );
 
 	void finishGen();
 
@@ -219,6 +250,7 @@ struct CodeGenData : public ReducedGen
 	virtual void writeStart() {};
 	virtual void writeFirstFinal() {};
 	virtual void writeError() {};
+	virtual void writeRefill() {};
 
 	/* This can also be overwridden to modify the processing of write
 	 * statements. */
@@ -265,11 +297,16 @@ struct CodeGenData : public ReducedGen
 	GenInlineList *tokstartExpr;
 	GenInlineList *tokendExpr;
 	GenInlineList *dataExpr;
+	GenInlineList *countersExpr;
 
 	KeyOps thisKeyOps;
 	EntryIdVect entryPointIds;
 	EntryNameVect entryPointNames;
 	bool hasLongestMatch;
+
+	/* Number of counters used by counted repetitions. */
+	int numRepCounters;
+
 	ExportList exportList;
 
 	/* Write options. */
@@ -278,6 +315,7 @@ struct CodeGenData : public ReducedGen
 	bool noFinal;
 	bool noError;
 	bool noCS;
+	bool noShift;
 
 	void createMachine();
 	void initActionList( unsigned long length );
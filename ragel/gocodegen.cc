@@ -0,0 +1,246 @@
+/*
+ *  Copyright 2026 agent <agent@local>
+ */
+
+/*  This file is part of Ragel.
+ *
+ *  Ragel is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Ragel is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Ragel; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ragel.h"
+#include "gocodegen.h"
+#include "redfsm.h"
+#include "gendata.h"
+#include <sstream>
+
+using std::ostringstream;
+using std::streambuf;
+
+/* Defined in goipgoto.cc. */
+void gothicLineDirective( ostream &out, const char *fileName, int line );
+
+string GoCodeGen::NULL_ITEM()
+{
+	return "0";
+}
+
+string GoCodeGen::POINTER()
+{
+	return "";
+}
+
+std::ostream &GoCodeGen::SWITCH_DEFAULT()
+{
+	return out;
+}
+
+/* Items are written to a side buffer until the array is closed. */
+std::ostream &GoCodeGen::OPEN_ARRAY( string type, string name )
+{
+	arrayType = type;
+	arrayName = name;
+	arrayBuf.str( "" );
+	arraySaved = out.rdbuf( arrayBuf.rdbuf() );
+	return out;
+}
+
+std::ostream &GoCodeGen::CLOSE_ARRAY()
+{
+	out.rdbuf( arraySaved );
+	arraySaved = 0;
+
+	/* The item writers do not leave a separator after the last item, which
+	 * Go requires when the closing brace is on its own line. */
+	string items = arrayBuf.str();
+	string::size_type end = items.find_last_not_of( " \t\n," );
+	items = end == string::npos ? "" : items.substr( 0, end + 1 );
+
+	long length = items.size() > 0 ? 1 : 0;
+	for ( string::size_type i = 0; i < items.size(); i++ ) {
+		if ( items[i] == ',' )
+			length += 1;
+	}
+
+	if ( maskIndices ) {
+		/* Pad to a power of two so that an index masked with the length
+		 * minus one is provably in bounds. */
+		long size = 1;
+		while ( size < length )
+			size <<= 1;
+
+		out << "var " << arrayName << " [" << size << "]" << arrayType <<
+				" = [" << size << "]" << arrayType << "{\n";
+		if ( items.size() > 0 )
+			out << items << ",\n";
+		out <<
+			"}\n"
+			"const " << arrayName << "_mask = " << size - 1 << "\n";
+	}
+	else {
+		out << "var " << arrayName << " = [...]" << arrayType << "{\n";
+		if ( items.size() > 0 )
+			out << items << ",\n";
+		out << "}\n";
+	}
+	return out;
+}
+
+std::ostream &GoCodeGen::STATIC_VAR( string type, string name )
+{
+	out << "var " << name << " " << type;
+	return out;
+}
+
+string GoCodeGen::ARR_OFF( string ptr, string offset )
+{
+	return ptr + "[" + offset + ":]";
+}
+
+string GoCodeGen::CAST( string type )
+{
+	return type;
+}
+
+string GoCodeGen::UINT()
+{
+	return "uint";
+}
+
+string GoCodeGen::PTR_CONST()
+{
+	return "";
+}
+
+string GoCodeGen::PTR_CONST_END()
+{
+	return "";
+}
+
+string GoCodeGen::CTRL_FLOW()
+{
+	return "";
+}
+
+string GoCodeGen::ARR_REF( string name, string index )
+{
+	if ( maskIndices )
+		return name + "[(" + index + ") & " + name + "_mask]";
+	return name + "[" + index + "]";
+}
+
+string GoCodeGen::GET_KEY()
+{
+	ostringstream ret;
+	if ( getKeyExpr != 0 ) {
+		/* Emit the user supplied method of retrieving the key. */
+		ret << "(";
+		INLINE_LIST( ret, getKeyExpr, 0, false, false );
+		ret << ")";
+	}
+	else {
+		/* Expression for retrieving the key, use simple dereference. */
+		ret << DATA() << "[" << P() << "]";
+	}
+	return ret.str();
+}
+
+void GoCodeGen::ACTION( ostream &ret, GenAction *action, int targState,
+		bool inFinish, bool csForced )
+{
+	/* Write the line info for going into the source file. */
+	gothicLineDirective( ret, action->loc.fileName, action->loc.line );
+
+	/* Write the block and close it off. */
+	ret << "\t{";
+	INLINE_LIST( ret, action->inlineList, targState, inFinish, csForced );
+	ret << "}\n";
+}
+
+void GoCodeGen::CONDITION( ostream &ret, GenAction *condition )
+{
+	ret << "\n";
+	gothicLineDirective( ret, condition->loc.fileName, condition->loc.line );
+	INLINE_LIST( ret, condition->inlineList, 0, false, false );
+}
+
+void GoCodeGen::genLineDirective( ostream &out )
+{
+	streambuf *sbuf = out.rdbuf();
+	output_filter *filter = static_cast<output_filter*>(sbuf);
+	gothicLineDirective( out, filter->fileName, filter->line + 1 );
+}
+
+void GoCodeGen::writeExports()
+{
+	if ( exportList.length() > 0 ) {
+		for ( ExportList::Iter ex = exportList; ex.lte(); ex++ ) {
+			out << "const " << DATA_PREFIX() << "ex_" << ex->name << " = " <<
+					KEY(ex->key) << "\n";
+		}
+		out << "\n";
+	}
+}
+
+/* The dump function needs the fmt and io packages. */
+void GoCodeGen::COUNTERS_DATA()
+{
+	long numStates = redFsm->stateList.length();
+	long numTrans = redFsm->transSet.length();
+
+	out <<
+		"var " << COUNTERS() << " struct {\n"
+		"	state_entries [" << numStates << "]uint64\n"
+		"	state_bytes [" << numStates << "]uint64\n"
+		"	trans [" << numTrans << "]uint64\n"
+		"}\n"
+		"\n";
+
+	OPEN_ARRAY( "string", TL() );
+	TRANS_LOCS();
+	CLOSE_ARRAY() <<
+		"\n"
+		"func " << DUMP_COUNTERS() << "(out io.Writer) {\n"
+		"	for i := 0; i < " << numStates << "; i++ {\n"
+		"		if " << COUNTERS() << ".state_entries[i] != 0 || " <<
+				COUNTERS() << ".state_bytes[i] != 0 {\n"
+		"			fmt.Fprintf(out, \"" << fsmName << " state %d entries %d bytes %d\\n\", i,\n"
+		"				" << COUNTERS() << ".state_entries[i], " <<
+				COUNTERS() << ".state_bytes[i])\n"
+		"		}\n"
+		"	}\n"
+		"	for i := 0; i < " << numTrans << "; i++ {\n"
+		"		if " << COUNTERS() << ".trans[i] != 0 {\n"
+		"			fmt.Fprintf(out, \"" << fsmName << " trans %d count %d target %d actions %s\\n\", i,\n"
+		"				" << COUNTERS() << ".trans[i], " << ARR_REF( TT(), "i" ) << ", " <<
+				ARR_REF( TL(), "i" ) << ")\n"
+		"		}\n"
+		"	}\n"
+		"}\n"
+		"\n";
+}
+
+void GoCodeGen::COUNT_STATE()
+{
+	out << "	" << COUNTERS() << ".state_bytes[" << vCS() << "]++\n";
+}
+
+void GoCodeGen::COUNT_TRANS()
+{
+	out <<
+		"	" << COUNTERS() << ".trans[_trans]++\n"
+		"	if int(" << ARR_REF( TT(), "_trans" ) << ") != " << vCS() << " {\n"
+		"		" << COUNTERS() << ".state_entries[" << ARR_REF( TT(), "_trans" ) << "]++\n"
+		"	}\n";
+}
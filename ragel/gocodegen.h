@@ -0,0 +1,76 @@
+/*
+ *  Copyright 2026 agent <agent@local>
+ */
+
+/*  This file is part of Ragel.
+ *
+ *  Ragel is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Ragel is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Ragel; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _GOCODEGEN_H
+#define _GOCODEGEN_H
+
+#include <iostream>
+#include <sstream>
+#include "cdcodegen.h"
+
+/*
+ * GoCodeGen
+ *
+ * Language mixin for the table driven Go code generators. Tables are written
+ * as package level arrays so the executor does not allocate.
+ */
+class GoCodeGen : virtual public FsmCodeGen
+{
+public:
+	GoCodeGen( const CodeGenArgs &args ) : FsmCodeGen(args), arraySaved(0) {}
+
+	virtual string NULL_ITEM();
+	virtual string POINTER();
+	virtual ostream &SWITCH_DEFAULT();
+	virtual ostream &OPEN_ARRAY( string type, string name );
+	virtual ostream &CLOSE_ARRAY();
+	virtual ostream &STATIC_VAR( string type, string name );
+	virtual string ARR_OFF( string ptr, string offset );
+	virtual string CAST( string type );
+	virtual string UINT();
+	virtual string PTR_CONST();
+	virtual string PTR_CONST_END();
+	virtual string CTRL_FLOW();
+	virtual string GET_KEY();
+
+	virtual void ACTION( ostream &ret, GenAction *action, int targState,
+			bool inFinish, bool csForced );
+	void CONDITION( ostream &ret, GenAction *condition );
+	virtual void genLineDirective( ostream &out );
+
+	virtual void writeExports();
+
+	virtual void COUNTERS_DATA();
+	virtual void COUNT_STATE();
+	virtual void COUNT_TRANS();
+
+protected:
+	/* Index into a table, masking the index when requested. */
+	string ARR_REF( string name, string index );
+
+	/* Arrays are collected so the element count is known when the
+	 * declaration is closed. */
+	string arrayType, arrayName;
+	std::ostringstream arrayBuf;
+	std::streambuf *arraySaved;
+};
+
+#endif
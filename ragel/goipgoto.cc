@@ -45,7 +45,7 @@ void GoIpGotoCodeGen::writeExec()
 	if ( redFsm->anyRegCurStateRef() )
 		out << "	_ps := 0\n";
 	if ( redFsm->anyConditions() )
-		out << "	" << WIDE_ALPH_TYPE() << " _widec\n";
+		out << "	var _widec " << WIDE_ALPH_TYPE() << "\n";
 	if ( !noEnd ) {
 		testEofUsed = true;
 		out << 
@@ -111,6 +111,8 @@ void GoIpGotoCodeGen::STATE_IDS()
 		out << "var " << FIRST_FINAL() << " int = " << FIRST_FINAL_STATE() << "\n";
 	if ( !noError )
 		out << "var " << ERROR() << " int = " << ERROR_STATE() << "\n";
+	if ( numRepCounters > 0 )
+		out << "var " << DATA_PREFIX() << "num_counters int = " << numRepCounters << "\n";
 	out << "\n";
 	if ( entryPointNames.length() > 0 ) {
 		for ( EntryNameVect::Iter en = entryPointNames; en.lte(); en++ ) {
@@ -380,9 +382,9 @@ void GoIpGotoCodeGen::emitRangeBSearch( RedStateAp *state, int level, int low, i
 void GoIpGotoCodeGen::COND_TRANSLATE( GenStateCond *stateCond, int level )
 {
 	GenCondSpace *condSpace = stateCond->condSpace;
-	out << TABS(level) << "_widec = " << CAST(WIDE_ALPH_TYPE()) << "(" <<
-		KEY(condSpace->baseKey) << " + (" << GET_KEY() << 
-		" - " << KEY(keyOps->minKey) << "))\n";
+	out << TABS(level) << "_widec = " << KEY(condSpace->baseKey) << " + (" <<
+		CAST(WIDE_ALPH_TYPE()) << "(" << GET_KEY() << ") - " <<
+		KEY(keyOps->minKey) << ")\n";
 	for ( GenCondSet::Iter csi = condSpace->condSet; csi.lte(); csi++ ) {
 		out << TABS(level) << "if ";
 		CONDITION( out, *csi );
@@ -391,6 +393,96 @@ void GoIpGotoCodeGen::COND_TRANSLATE( GenStateCond *stateCond, int level )
 	}
 }
 
+void GoIpGotoCodeGen::emitCondBSearch( RedStateAp *state, int level, int low, int high )
+{
+	/* Get the mid position, staying on the lower end of the range. */
+	int mid = (low + high) >> 1;
+	GenStateCond **data = state->stateCondVect.data;
+	/* Determine if we need to look higher or lower. */
+	bool anyLower = mid > low;
+	bool anyHigher = mid < high;
+	/* Determine if the keys at mid are the limits of the alphabet. */
+	bool limitLow = data[mid]->lowKey == keyOps->minKey;
+	bool limitHigh = data[mid]->highKey == keyOps->maxKey;
+	if ( anyLower && anyHigher ) {
+		/* Can go lower and higher than mid. */
+		out << TABS(level) << "if " << GET_KEY() << " < " << 
+			KEY(data[mid]->lowKey) << " {\n";
+		emitCondBSearch( state, level+1, low, mid-1 );
+		out << TABS(level) << "} else if " << GET_KEY() << " > " << 
+			KEY(data[mid]->highKey) << " {\n";
+		emitCondBSearch( state, level+1, mid+1, high );
+		out << TABS(level) << "} else {\n";
+		COND_TRANSLATE(data[mid], level+1);
+		out << TABS(level) << "}\n";
+	}
+	else if ( anyLower && !anyHigher ) {
+		/* Can go lower than mid but not higher. */
+		out << TABS(level) << "if " << GET_KEY() << " < " << 
+			KEY(data[mid]->lowKey) << " {\n";
+		emitCondBSearch( state, level+1, low, mid-1 );
+		/* if the higher is the highest in the alphabet then there is no
+		 * sense testing it. */
+		if ( limitHigh ) {
+			out << TABS(level) << "} else {\n";
+			COND_TRANSLATE(data[mid], level+1);
+			out << TABS(level) << "}\n";
+		}
+		else {
+			out << TABS(level) << "} else if " << GET_KEY() << " <= " << 
+				KEY(data[mid]->highKey) << " {\n";
+			COND_TRANSLATE(data[mid], level+1);
+			out << TABS(level) << "}\n";
+		}
+	}
+	else if ( !anyLower && anyHigher ) {
+		/* Can go higher than mid but not lower. */
+		out << TABS(level) << "if " << GET_KEY() << " > " << 
+			KEY(data[mid]->highKey) << " {\n";
+		emitCondBSearch( state, level+1, mid+1, high );
+		/* If the lower end is the lowest in the alphabet then there is no
+		 * sense testing it. */
+		if ( limitLow ) {
+			out << TABS(level) << "} else {\n";
+			COND_TRANSLATE(data[mid], level+1);
+			out << TABS(level) << "}\n";
+		}
+		else {
+			out << TABS(level) << "} else if " << GET_KEY() << " >= " << 
+				KEY(data[mid]->lowKey) << " {\n";
+			COND_TRANSLATE(data[mid], level+1);
+			out << TABS(level) << "}\n";
+		}
+	}
+	else {
+		/* Cannot go higher or lower than mid. It's mid or bust. What
+		 * tests to do depends on limits of alphabet. */
+		if ( !limitLow && !limitHigh ) {
+			out << TABS(level) << "if " << KEY(data[mid]->lowKey) << " <= " << 
+				GET_KEY() << " && " << GET_KEY() << " <= " << 
+				KEY(data[mid]->highKey) << " {\n";
+			COND_TRANSLATE(data[mid], level+1);
+			out << TABS(level) << "}\n";
+		}
+		else if ( limitLow && !limitHigh ) {
+			out << TABS(level) << "if " << GET_KEY() << " <= " << 
+				KEY(data[mid]->highKey) << " {\n";
+			COND_TRANSLATE(data[mid], level+1);
+			out << TABS(level) << "}\n";
+		}
+		else if ( !limitLow && limitHigh ) {
+			out << TABS(level) << "if " << KEY(data[mid]->lowKey) << " <= " << 
+				GET_KEY() << " {\n";
+			COND_TRANSLATE(data[mid], level+1);
+			out << TABS(level) << "}\n";
+		}
+		else {
+			/* Both high and low are at the limit. No tests to do. */
+			COND_TRANSLATE(data[mid], level);
+		}
+	}
+}
+
 ostream &GoIpGotoCodeGen::STATE_GOTOS()
 {
 	for ( RedStateList::Iter st = redFsm->stateList; st.lte(); st++ ) {
@@ -400,7 +492,7 @@ ostream &GoIpGotoCodeGen::STATE_GOTOS()
 			/* Writing code above state gotos. */
 			GOTO_HEADER( st );
 			if ( st->stateCondVect.length() > 0 ) {
-				out << "	_widec = " << GET_KEY() << "\n";
+				out << "	_widec = " << CAST(WIDE_ALPH_TYPE()) << "(" << GET_KEY() << ")\n";
 				emitCondBSearch( st, 1, 0, st->stateCondVect.length() - 1 );
 			}
 			/* Try singles. */
@@ -53,6 +53,7 @@ public:
 	void emitSingleSwitch( RedStateAp *state );
 	void emitRangeBSearch( RedStateAp *state, int level, int low, int high );
 	void COND_TRANSLATE( GenStateCond *stateCond, int level );
+	void emitCondBSearch( RedStateAp *state, int level, int low, int high );
 	ostream &STATE_GOTOS();
 	ostream &STATIC_VAR( string type, string name );
 	ostream &TRANS_GOTO( RedTransAp *trans, int level );
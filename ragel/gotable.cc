@@ -0,0 +1,346 @@
+/*
+ *  Copyright 2026 agent <agent@local>
+ */
+
+/*  This file is part of Ragel.
+ *
+ *  Ragel is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Ragel is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Ragel; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ragel.h"
+#include "gotable.h"
+#include "redfsm.h"
+#include "gendata.h"
+
+void GoTabCodeGen::CALL( ostream &ret, int callDest, int targState, bool inFinish )
+{
+	if ( prePushExpr != 0 ) {
+		ret << "{";
+		INLINE_LIST( ret, prePushExpr, 0, false, false );
+	}
+
+	ret << "{" << STACK() << "[" << TOP() << "] = " << vCS() << "; " <<
+			TOP() << "++; " << vCS() << " = " << callDest << "; " <<
+			CTRL_FLOW() << "goto _again;}";
+
+	if ( prePushExpr != 0 )
+		ret << "}";
+}
+
+void GoTabCodeGen::CALL_EXPR( ostream &ret, GenInlineItem *ilItem, int targState, bool inFinish )
+{
+	if ( prePushExpr != 0 ) {
+		ret << "{";
+		INLINE_LIST( ret, prePushExpr, 0, false, false );
+	}
+
+	ret << "{" << STACK() << "[" << TOP() << "] = " << vCS() << "; " <<
+			TOP() << "++; " << vCS() << " = (";
+	INLINE_LIST( ret, ilItem->children, targState, inFinish, false );
+	ret << "); " << CTRL_FLOW() << "goto _again;}";
+
+	if ( prePushExpr != 0 )
+		ret << "}";
+}
+
+void GoTabCodeGen::RET( ostream &ret, bool inFinish )
+{
+	ret << "{" << TOP() << "--; " << vCS() << " = " << STACK() << "[" <<
+			TOP() << "]; ";
+
+	if ( postPopExpr != 0 ) {
+		ret << "{";
+		INLINE_LIST( ret, postPopExpr, 0, false, false );
+		ret << "}";
+	}
+
+	ret << CTRL_FLOW() <<  "goto _again;}";
+}
+
+void GoTabCodeGen::LOCATE_TRANS()
+{
+	out <<
+		"	_keys = int(" << ARR_REF( KO(), vCS() ) << ")\n"
+		"	_trans = int(" << ARR_REF( IO(), vCS() ) << ")\n"
+		"\n"
+		"	_klen = int(" << ARR_REF( SL(), vCS() ) << ")\n"
+		"	if _klen > 0 {\n"
+		"		_lower := _keys\n"
+		"		var _mid int\n"
+		"		_upper := _keys + _klen - 1\n"
+		"		for {\n"
+		"			if _upper < _lower {\n"
+		"				break\n"
+		"			}\n"
+		"\n"
+		"			_mid = _lower + ((_upper - _lower) >> 1)\n"
+		"			if " << GET_WIDE_KEY() << " < " << ARR_REF( K(), "_mid" ) << " {\n"
+		"				_upper = _mid - 1\n"
+		"			} else if " << GET_WIDE_KEY() << " > " << ARR_REF( K(), "_mid" ) << " {\n"
+		"				_lower = _mid + 1\n"
+		"			} else {\n"
+		"				_trans += _mid - _keys\n"
+		"				goto _match\n"
+		"			}\n"
+		"		}\n"
+		"		_keys += _klen\n"
+		"		_trans += _klen\n"
+		"	}\n"
+		"\n"
+		"	_klen = int(" << ARR_REF( RL(), vCS() ) << ")\n"
+		"	if _klen > 0 {\n"
+		"		_lower := _keys\n"
+		"		var _mid int\n"
+		"		_upper := _keys + (_klen << 1) - 2\n"
+		"		for {\n"
+		"			if _upper < _lower {\n"
+		"				break\n"
+		"			}\n"
+		"\n"
+		"			_mid = _lower + (((_upper - _lower) >> 1) &^ 1)\n"
+		"			if " << GET_WIDE_KEY() << " < " << ARR_REF( K(), "_mid" ) << " {\n"
+		"				_upper = _mid - 2\n"
+		"			} else if " << GET_WIDE_KEY() << " > " << ARR_REF( K(), "_mid + 1" ) << " {\n"
+		"				_lower = _mid + 2\n"
+		"			} else {\n"
+		"				_trans += (_mid - _keys) >> 1\n"
+		"				goto _match\n"
+		"			}\n"
+		"		}\n"
+		"		_trans += _klen\n"
+		"	}\n"
+		"\n";
+}
+
+void GoTabCodeGen::COND_TRANSLATE()
+{
+	out <<
+		"	_widec = " << WIDE_ALPH_TYPE() << "(" << GET_KEY() << ")\n"
+		"	_klen = int(" << ARR_REF( CL(), vCS() ) << ")\n"
+		"	_keys = int(" << ARR_REF( CO(), vCS() ) << ") * 2\n"
+		"	if _klen > 0 {\n"
+		"		_lower := _keys\n"
+		"		var _mid int\n"
+		"		_upper := _keys + (_klen << 1) - 2\n"
+		"		for {\n"
+		"			if _upper < _lower {\n"
+		"				break\n"
+		"			}\n"
+		"\n"
+		"			_mid = _lower + (((_upper - _lower) >> 1) &^ 1)\n"
+		"			if " << GET_WIDE_KEY() << " < " << ARR_REF( CK(), "_mid" ) << " {\n"
+		"				_upper = _mid - 2\n"
+		"			} else if " << GET_WIDE_KEY() << " > " << ARR_REF( CK(), "_mid + 1" ) << " {\n"
+		"				_lower = _mid + 2\n"
+		"			} else {\n"
+		"				switch " << ARR_REF( C(), "int(" + ARR_REF( CO(), vCS() ) +
+								") + ((_mid - _keys) >> 1)" ) << " {\n";
+
+	for ( CondSpaceList::Iter csi = condSpaceList; csi.lte(); csi++ ) {
+		GenCondSpace *condSpace = csi;
+		out << "	case " << condSpace->condSpaceId << ":\n";
+		out << TABS(2) << "_widec = " << WIDE_ALPH_TYPE() << "(" <<
+				KEY(condSpace->baseKey) << " + (int(" << GET_KEY() <<
+				") - " << KEY(keyOps->minKey) << "))\n";
+
+		for ( GenCondSet::Iter csi = condSpace->condSet; csi.lte(); csi++ ) {
+			out << TABS(2) << "if ";
+			CONDITION( out, *csi );
+			Size condValOffset = ((1 << csi.pos()) * keyOps->alphSize());
+			out << " {\n" << TABS(3) << "_widec += " << condValOffset <<
+					"\n" << TABS(2) << "}\n";
+		}
+	}
+
+	out <<
+		"				}\n"
+		"				break\n"
+		"			}\n"
+		"		}\n"
+		"	}\n"
+		"\n";
+}
+
+void GoTabCodeGen::writeExec()
+{
+	testEofUsed = false;
+	outLabelUsed = false;
+
+	out <<
+		"	{\n"
+		"	var _klen int\n"
+		"	var _trans int\n";
+
+	if ( redFsm->anyRegCurStateRef() )
+		out << "	var _ps int\n";
+
+	if ( redFsm->anyConditions() )
+		out << "	var _widec " << WIDE_ALPH_TYPE() << "\n";
+
+	if ( redFsm->anyToStateActions() || redFsm->anyRegActions()
+			|| redFsm->anyFromStateActions() )
+	{
+		out <<
+			"	var _acts int\n";
+	}
+
+	out <<
+		"	var _keys int\n";
+
+	if ( !noEnd ) {
+		testEofUsed = true;
+		out <<
+			"	if " << P() << " == " << PE() << " {\n"
+			"		goto _test_eof\n"
+			"	}\n";
+	}
+
+	if ( redFsm->errState != 0 ) {
+		outLabelUsed = true;
+		out <<
+			"	if " << vCS() << " == " << redFsm->errState->id << " {\n"
+			"		goto _out\n"
+			"	}\n";
+	}
+
+	out << "_resume:\n";
+
+	if ( instrument )
+		COUNT_STATE();
+
+	if ( redFsm->anyFromStateActions() ) {
+		out <<
+			"	_acts = int(" << ARR_REF( FSA(), vCS() ) << ")\n"
+			"	for ; " << ARR_REF( A(), "_acts" ) << " != " << ACTS_END() << "; _acts++ {\n"
+			"		switch " << ARR_REF( A(), "_acts" ) << " {\n";
+			FROM_STATE_ACTION_SWITCH();
+			SWITCH_DEFAULT() <<
+			"		}\n"
+			"	}\n"
+			"\n";
+	}
+
+	if ( redFsm->anyConditions() )
+		COND_TRANSLATE();
+
+	LOCATE_TRANS();
+
+	out << "_match:\n";
+
+	if ( useIndicies )
+		out << "	_trans = int(" << ARR_REF( I(), "_trans" ) << ")\n";
+
+	if ( redFsm->anyEofTrans() )
+		out << "_eof_trans:\n";
+
+	if ( redFsm->anyRegCurStateRef() )
+		out << "	_ps = " << vCS() << "\n";
+
+	if ( instrument )
+		COUNT_TRANS();
+
+	out <<
+		"	" << vCS() << " = int(" << ARR_REF( TT(), "_trans" ) << ")\n"
+		"\n";
+
+	if ( redFsm->anyRegActions() ) {
+		out <<
+			"	if " << ARR_REF( TA(), "_trans" ) << " == 0 {\n"
+			"		goto _again\n"
+			"	}\n"
+			"\n"
+			"	_acts = int(" << ARR_REF( TA(), "_trans" ) << ")\n"
+			"	for ; " << ARR_REF( A(), "_acts" ) << " != " << ACTS_END() << "; _acts++ {\n"
+			"		switch " << ARR_REF( A(), "_acts" ) << " {\n";
+			ACTION_SWITCH();
+			SWITCH_DEFAULT() <<
+			"		}\n"
+			"	}\n"
+			"\n";
+	}
+
+	if ( redFsm->anyRegActions() || redFsm->anyActionGotos() ||
+			redFsm->anyActionCalls() || redFsm->anyActionRets() )
+		out << "_again:\n";
+
+	if ( redFsm->anyToStateActions() ) {
+		out <<
+			"	_acts = int(" << ARR_REF( TSA(), vCS() ) << ")\n"
+			"	for ; " << ARR_REF( A(), "_acts" ) << " != " << ACTS_END() << "; _acts++ {\n"
+			"		switch " << ARR_REF( A(), "_acts" ) << " {\n";
+			TO_STATE_ACTION_SWITCH();
+			SWITCH_DEFAULT() <<
+			"		}\n"
+			"	}\n"
+			"\n";
+	}
+
+	if ( redFsm->errState != 0 ) {
+		outLabelUsed = true;
+		out <<
+			"	if " << vCS() << " == " << redFsm->errState->id << " {\n"
+			"		goto _out\n"
+			"	}\n";
+	}
+
+	if ( !noEnd ) {
+		out <<
+			"	" << P() << "++\n"
+			"	if " << P() << " != " << PE() << " {\n"
+			"		goto _resume\n"
+			"	}\n";
+	}
+	else {
+		out <<
+			"	" << P() << "++\n"
+			"	goto _resume\n";
+	}
+
+	if ( testEofUsed )
+		out << "	_test_eof: {}\n";
+
+	if ( redFsm->anyEofTrans() || redFsm->anyEofActions() ) {
+		out <<
+			"	if " << P() << " == " << vEOF() << " {\n";
+
+		if ( redFsm->anyEofTrans() ) {
+			out <<
+				"	if " << ARR_REF( ET(), vCS() ) << " > 0 {\n"
+				"		_trans = int(" << ARR_REF( ET(), vCS() ) << ") - 1\n"
+				"		goto _eof_trans\n"
+				"	}\n";
+		}
+
+		if ( redFsm->anyEofActions() ) {
+			out <<
+				"	__acts := int(" << ARR_REF( EA(), vCS() ) << ")\n"
+				"	for ; " << ARR_REF( A(), "__acts" ) << " != " << ACTS_END() << "; __acts++ {\n"
+				"		switch " << ARR_REF( A(), "__acts" ) << " {\n";
+				EOF_ACTION_SWITCH();
+				SWITCH_DEFAULT() <<
+				"		}\n"
+				"	}\n";
+		}
+
+		out <<
+			"	}\n"
+			"\n";
+	}
+
+	if ( outLabelUsed )
+		out << "	_out: {}\n";
+
+	out << "	}\n";
+}
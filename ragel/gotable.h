@@ -0,0 +1,48 @@
+/*
+ *  Copyright 2026 agent <agent@local>
+ */
+
+/*  This file is part of Ragel.
+ *
+ *  Ragel is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Ragel is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Ragel; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _GOTABLE_H
+#define _GOTABLE_H
+
+#include "cdtable.h"
+#include "gocodegen.h"
+
+/*
+ * GoTabCodeGen
+ */
+struct GoTabCodeGen
+	: public TabCodeGen, public GoCodeGen
+{
+	GoTabCodeGen( const CodeGenArgs &args ) :
+		FsmCodeGen(args), TabCodeGen(args), GoCodeGen(args) {}
+
+	void writeExec();
+
+protected:
+	void LOCATE_TRANS();
+	void COND_TRANSLATE();
+
+	void CALL( ostream &ret, int callDest, int targState, bool inFinish );
+	void CALL_EXPR( ostream &ret, GenInlineItem *ilItem, int targState, bool inFinish );
+	void RET( ostream &ret, bool inFinish );
+};
+
+#endif
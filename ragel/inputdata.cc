@@ -26,6 +26,7 @@
 #include "rlparse.h"
 #include "rlscan.h"
 #include "dotcodegen.h"
+#include "profile.h"
 #include <iostream>
 
 using std::istream;
@@ -144,24 +145,42 @@ void InputData::makeOutputStream()
 		}
 
 		/* Create the filter on the output and open it. */
-		outFilter = new output_filter( outputFileName );
+		outFilter = new output_filter( outputFileName, outString );
 
 		/* Open the output stream, attaching it to the filter. */
 		outStream = new ostream( outFilter );
 	}
+	else if ( outString != 0 ) {
+		/* Writing to a string, there is no file name to use. */
+		outFilter = new output_filter( "<stdout>", outString );
+		outStream = new ostream( outFilter );
+	}
 	else {
 		/* Writing out ot std out. */
 		outStream = &cout;
 	}
 }
 
-void InputData::openOutput()
+/* If writing to a file or a string, delete the ostream, causing it to flush.
+ * Standard out is flushed automatically. Can be called again after an early
+ * exit. */
+void InputData::closeOutput()
 {
 	if ( outFilter != 0 ) {
+		delete outStream;
+		delete outFilter;
+		outStream = 0;
+		outFilter = 0;
+	}
+}
+
+void InputData::openOutput()
+{
+	if ( outFilter != 0 && outFilter->buffer == 0 ) {
 		outFilter->open( outputFileName, ios::out|ios::trunc );
 		if ( !outFilter->is_open() ) {
 			error() << "error opening " << outputFileName << " for writing" << endl;
-			exit(1);
+			exitCompile(1);
 		}
 	}
 }
@@ -252,6 +271,8 @@ void InputData::writeOutput()
 			CodeGenData *cgd = ii->pd->cgd;
 			::keyOps = &cgd->thisKeyOps;
 
+			ProfileMachine profileMachine( ii->pd->sectionName, &ii->loc );
+			ProfilePhase phase( "write", ii->writeArgs[0] );
 			cgd->writeStatement( ii->loc, ii->writeArgs.length()-1, ii->writeArgs.data );
 		}
 		else {
@@ -268,12 +289,12 @@ void InputData::processXML()
 	prepareAllMachines();
 
 	if ( gblErrorCount > 0 )
-		exit(1);
+		exitCompile(1);
 
 	makeOutputStream();
 
 	if ( gblErrorCount > 0 )
-		exit(1);
+		exitCompile(1);
 
 	/*
 	 * From this point on we should not be reporting any errors.
@@ -289,12 +310,12 @@ void InputData::processDot()
 	prepareSingleMachine();
 
 	if ( gblErrorCount > 0 )
-		exit(1);
+		exitCompile(1);
 
 	makeOutputStream();
 
 	if ( gblErrorCount > 0 )
-		exit(1);
+		exitCompile(1);
 
 	/*
 	 * From this point on we should not be reporting any errors.
@@ -310,21 +331,23 @@ void InputData::processCode()
 	prepareAllMachines();
 
 	if ( gblErrorCount > 0 )
-		exit(1);
+		exitCompile(1);
 
-	makeDefaultFileName();
+	/* Output going to a string has no file to name. */
+	if ( outString == 0 )
+		makeDefaultFileName();
 	makeOutputStream();
 
 	/* Generates the reduced machine, which we use to write output. */
 	generateReduced();
 
 	if ( gblErrorCount > 0 )
-		exit(1);
+		exitCompile(1);
 
 	verifyWritesHaveData();
 
 	if ( gblErrorCount > 0 )
-		exit(1);
+		exitCompile(1);
 
 	/*
 	 * From this point on we should not be reporting any errors.
@@ -336,11 +359,15 @@ void InputData::processCode()
 
 void InputData::process()
 {
-	/* Open the input file for reading. */
+	/* Open the input file for reading, unless an input stream was given. */
 	assert( inputFileName != 0 );
-	ifstream *inFile = new ifstream( inputFileName );
-	if ( ! inFile->is_open() )
-		error() << "could not open " << inputFileName << " for reading" << endp;
+	std::istream *inFile = inStream;
+	if ( inFile == 0 ) {
+		ifstream *inFileStream = new ifstream( inputFileName );
+		if ( ! inFileStream->is_open() )
+			error() << "could not open " << inputFileName << " for reading" << endp;
+		inFile = inFileStream;
+	}
 
 	/* Used for just a few things. */
 	std::ostringstream hostData;
@@ -353,19 +380,21 @@ void InputData::process()
 	firstInputItem->loc.col = 1;
 	inputItems.append( firstInputItem );
 
+	ProfilePhase parsePhase( "parse", firstInputItem->loc );
 	Scanner scanner( *this, inputFileName, *inFile, 0, 0, 0, false );
 	scanner.do_scan();
 
 	/* Finished, final check for errors.. */
 	if ( gblErrorCount > 0 )
-		exit(1);
+		exitCompile(1);
 
 	/* Now send EOF to all parsers. */
 	terminateAllParsers();
+	parsePhase.finish();
 
 	/* Bail on above error. */
 	if ( gblErrorCount > 0 )
-		exit(1);
+		exitCompile(1);
 
 	if ( generateXML )
 		processXML();
@@ -374,15 +403,10 @@ void InputData::process()
 	else 
 		processCode();
 
-	/* Close the input and the intermediate file. */
-	delete inFile;
-
-	/* If writing to a file, delete the ostream, causing it to flush.
-	 * Standard out is flushed automatically. */
-	if ( outputFileName != 0 ) {
-		delete outStream;
-		delete outFilter;
-	}
+	/* Close the input, unless it belongs to the caller, and the output. */
+	if ( inFile != inStream )
+		delete inFile;
+	closeOutput();
 
 	assert( gblErrorCount == 0 );
 }
@@ -66,6 +66,7 @@ struct InputData
 		inStream(0),
 		outStream(0),
 		outFilter(0),
+		outString(0),
 		dotGenParser(0)
 	{}
 
@@ -73,17 +74,24 @@ struct InputData
 	const char *inputFileName;
 	const char *outputFileName;
 
-	/* Io globals. */
+	/* Io globals. If inStream is set before processing it is read instead
+	 * of the input file. */
 	std::istream *inStream;
 	std::ostream *outStream;
 	output_filter *outFilter;
 
+	/* If set, the output is written to this string instead of a file. */
+	std::string *outString;
+
 	Parser *dotGenParser;
 
 	ParserDict parserDict;
 	ParserList parserList;
 	InputItemList inputItems;
 
+	/* Arrays the machines have written, for --share-tables. */
+	SharedArrayMap sharedArrays;
+
 	ArgsVector includePaths;
 
 	void verifyWritesHaveData();
@@ -92,6 +100,7 @@ struct InputData
 	void makeDefaultFileName();
 	void makeOutputStream();
 	void openOutput();
+	void closeOutput();
 	void generateReduced();
 	void prepareSingleMachine();
 	void prepareAllMachines();
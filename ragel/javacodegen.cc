@@ -34,11 +34,10 @@
  * (should be multiple of IALL). */
 #define SAIIC 8184
 
-#define _resume    1
-#define _again     2
-#define _eof_trans 3
-#define _test_eof  4
-#define _out       5
+/* Packed string tables: characters per source line and per string constant.
+ * A constant is limited to 65535 bytes of modified UTF-8. */
+#define PSLL 64
+#define PSCL 32768
 
 using std::setw;
 using std::ios;
@@ -237,6 +236,11 @@ void JavaTabCodeGen::INLINE_LIST( ostream &ret, GenInlineList *inlineList,
 		case GenInlineItem::Break:
 			BREAK( ret, targState );
 			break;
+		case GenInlineItem::RepInit:
+		case GenInlineItem::RepIncr:
+		case GenInlineItem::RepTest:
+			/* Counted repetition is not supported for this language. */
+			break;
 		}
 	}
 }
@@ -1174,6 +1178,12 @@ std::ostream &JavaTabCodeGen::OPEN_ARRAY( string type, string name )
 	item_count = 0;
 	div_count = 1;
 
+	/* Items are collected and written when the array is closed. */
+	if ( packedTables ) {
+		packed_items.empty();
+		return out;
+	}
+
 	out <<  "private static " << type << "[] init_" << name << "_0()\n"
 		"{\n\t"
 		"return new " << type << " [] {\n\t";
@@ -1184,6 +1194,11 @@ std::ostream &JavaTabCodeGen::ARRAY_ITEM( string item, bool last )
 {
 	item_count++;
 
+	if ( packedTables ) {
+		packed_items.append( strtoll( item.c_str(), 0, 10 ) );
+		return out;
+	}
+
 	out << setw(5) << setiosflags(ios::right) << item;
 	
 	if ( !last ) {
@@ -1205,6 +1220,11 @@ std::ostream &JavaTabCodeGen::ARRAY_ITEM( string item, bool last )
 
 std::ostream &JavaTabCodeGen::CLOSE_ARRAY()
 {
+	if ( packedTables ) {
+		PACKED_ARRAY();
+		return out;
+	}
+
 	out << "\n\t};\n}\n\n";
 
 	if (item_count < SAIIC) {
@@ -1234,6 +1254,84 @@ std::ostream &JavaTabCodeGen::CLOSE_ARRAY()
 }
 
 
+/* Writes the collected array items as string constants that are decoded when
+ * the class is initialized. Loading strings from the constant pool is much
+ * cheaper than running the bytecode of an array initializer, and the class
+ * file is several times smaller.
+ *
+ * Each item is zigzag encoded, so small negative values stay small, then
+ * written low bits first. Characters 64 to 127 carry six bits and are
+ * followed by more. A character from 32 to 63 carries the last five bits.
+ * All characters are one byte in the class file. */
+void JavaTabCodeGen::PACKED_ARRAY()
+{
+	out << "private static " << array_type << "[] init_" << array_name << "_0()\n"
+		"{\n"
+		"\tString s[] = {\n"
+		"\t\t\"";
+
+	long chars = 0;
+	for ( int i = 0; i < packed_items.length(); i++ ) {
+		long long val = packed_items[i];
+		unsigned long long u = val >= 0 ? 
+				(unsigned long long) val << 1 : 
+				( (unsigned long long) (-(val+1)) << 1 ) | 1;
+
+		while ( true ) {
+			int c;
+			if ( u >= 32 ) {
+				c = 64 + (int)( u & 63 );
+				u >>= 6;
+			}
+			else {
+				c = 32 + (int)u;
+			}
+
+			if ( c == '"' || c == '\\' )
+				out << '\\' << (char)c;
+			else if ( c == 127 )
+				out << "\\177";
+			else
+				out << (char)c;
+
+			/* Break the line, and the constant, between characters. */
+			chars += 1;
+			if ( chars % PSCL == 0 )
+				out << "\",\n\t\t\"";
+			else if ( chars % PSLL == 0 )
+				out << "\" +\n\t\t\"";
+
+			if ( c < 64 )
+				break;
+		}
+	}
+
+	out << "\"\n"
+		"\t};\n"
+		"\t" << array_type << " a[] = new " << array_type << "[" << item_count << "];\n"
+		"\tint i = 0, v = 0, shift = 0;\n"
+		"\tfor ( int j = 0; j < s.length; j++ ) {\n"
+		"\t\tfor ( int k = 0; k < s[j].length(); k++ ) {\n"
+		"\t\t\tint c = s[j].charAt( k );\n"
+		"\t\t\tif ( c >= 64 ) {\n"
+		"\t\t\t\tv |= ( c - 64 ) << shift;\n"
+		"\t\t\t\tshift += 6;\n"
+		"\t\t\t}\n"
+		"\t\t\telse {\n"
+		"\t\t\t\tv |= ( c - 32 ) << shift;\n"
+		"\t\t\t\ta[i++] = (" << array_type << ") ( ( v >>> 1 ) ^ -( v & 1 ) );\n"
+		"\t\t\t\tv = 0;\n"
+		"\t\t\t\tshift = 0;\n"
+		"\t\t\t}\n"
+		"\t\t}\n"
+		"\t}\n"
+		"\treturn a;\n"
+		"}\n"
+		"\n"
+		"private static final " << array_type << " " << array_name << 
+		"[] = init_" << array_name << "_0();\n\n";
+}
+
 std::ostream &JavaTabCodeGen::STATIC_VAR( string type, string name )
 {
 	out << "static final " << type << " " << name;
@@ -1651,7 +1749,10 @@ void JavaTabCodeGen::finishRagelDef()
 	redFsm->chooseDefaultSpan();
 		
 	/* Maybe do flat expand, otherwise choose single. */
-	redFsm->chooseSingle();
+	if ( codeStyle == GenFlat || codeStyle == GenFFlat )
+		redFsm->makeFlat();
+	else
+		redFsm->chooseSingle();
 
 	/* If any errors have occured in the input file then don't write anything. */
 	if ( gblErrorCount > 0 )
@@ -40,6 +40,15 @@ struct JavaTabCodeGen : public CodeGenData
 	JavaTabCodeGen( const CodeGenArgs &args ) :
 		CodeGenData(args) {}
 
+	/* Targets of the goto loop in the exec block. */
+	enum GotoTarg {
+		_resume = 1,
+		_again,
+		_eof_trans,
+		_test_eof,
+		_out
+	};
+
 	std::ostream &TO_STATE_ACTION_SWITCH();
 	std::ostream &FROM_STATE_ACTION_SWITCH();
 	std::ostream &EOF_ACTION_SWITCH();
@@ -86,13 +95,13 @@ struct JavaTabCodeGen : public CodeGenData
 	void NEXT( ostream &ret, int nextDest, bool inFinish );
 	void NEXT_EXPR( ostream &ret, GenInlineItem *ilItem, bool inFinish );
 
-	int TO_STATE_ACTION( RedStateAp *state );
-	int FROM_STATE_ACTION( RedStateAp *state );
-	int EOF_ACTION( RedStateAp *state );
-	int TRANS_ACTION( RedTransAp *trans );
+	virtual int TO_STATE_ACTION( RedStateAp *state );
+	virtual int FROM_STATE_ACTION( RedStateAp *state );
+	virtual int EOF_ACTION( RedStateAp *state );
+	virtual int TRANS_ACTION( RedTransAp *trans );
 
 	/* Determine if we should use indicies. */
-	void calcIndexSize();
+	virtual void calcIndexSize();
 
 private:
 	string array_type;
@@ -100,6 +109,10 @@ private:
 	int item_count;
 	int div_count;
 
+	/* Items of the current array when tables are packed into strings. */
+	Vector<long long> packed_items;
+	void PACKED_ARRAY();
+
 public:
 
 	virtual string NULL_ITEM();
@@ -0,0 +1,525 @@
+/*
+ *  Copyright 2026 agent <agent@local>
+ */
+
+/*  This file is part of Ragel.
+ *
+ *  Ragel is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  Ragel is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with Ragel; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#include "ragel.h"
+#include "javaflat.h"
+#include "redfsm.h"
+#include "gendata.h"
+
+std::ostream &JavaFlatCodeGen::KEYS()
+{
+	for ( RedStateList::Iter st = redFsm->stateList; st.lte(); st++ ) {
+		/* Emit just low key and high key. */
+		ARRAY_ITEM( KEY( st->lowKey ), false );
+		ARRAY_ITEM( KEY( st->highKey ), false );
+	}
+
+	/* Output one last number so we don't have to figure out when the last
+	 * entry is and avoid writing a comma. */
+	ARRAY_ITEM( INT(0), true );
+	return out;
+}
+
+std::ostream &JavaFlatCodeGen::INDICIES()
+{
+	for ( RedStateList::Iter st = redFsm->stateList; st.lte(); st++ ) {
+		if ( st->transList != 0 ) {
+			/* Walk the singles. */
+			unsigned long long span = keyOps->span( st->lowKey, st->highKey );
+			for ( unsigned long long pos = 0; pos < span; pos++ )
+				ARRAY_ITEM( INT( st->transList[pos]->id ), false );
+		}
+
+		/* The state's default index goes next. */
+		if ( st->defTrans != 0 )
+			ARRAY_ITEM( INT( st->defTrans->id ), false );
+	}
+
+	/* Output one last number so we don't have to figure out when the last
+	 * entry is and avoid writing a comma. */
+	ARRAY_ITEM( INT(0), true );
+	return out;
+}
+
+std::ostream &JavaFlatCodeGen::FLAT_INDEX_OFFSET()
+{
+	int curIndOffset = 0;
+	for ( RedStateList::Iter st = redFsm->stateList; st.lte(); st++ ) {
+		/* Write the index offset. */
+		ARRAY_ITEM( INT(curIndOffset), st.last() );
+
+		/* Move the index offset ahead. */
+		if ( st->transList != 0 )
+			curIndOffset += keyOps->span( st->lowKey, st->highKey );
+
+		if ( st->defTrans != 0 )
+			curIndOffset += 1;
+	}
+	return out;
+}
+
+std::ostream &JavaFlatCodeGen::KEY_SPANS()
+{
+	for ( RedStateList::Iter st = redFsm->stateList; st.lte(); st++ ) {
+		/* Write singles length. */
+		unsigned long long span = 0;
+		if ( st->transList != 0 )
+			span = keyOps->span( st->lowKey, st->highKey );
+		ARRAY_ITEM( INT(span), st.last() );
+	}
+	return out;
+}
+
+std::ostream &JavaFlatCodeGen::TRANS_TARGS()
+{
+	/* Transitions must be written ordered by their id. */
+	RedTransAp **transPtrs = new RedTransAp*[redFsm->transSet.length()];
+	for ( TransApSet::Iter trans = redFsm->transSet; trans.lte(); trans++ )
+		transPtrs[trans->id] = trans;
+
+	/* Keep a count of the num of items in the array written. */
+	for ( int t = 0; t < redFsm->transSet.length(); t++ ) {
+		/* Save the position. Needed for eofTargs. */
+		RedTransAp *trans = transPtrs[t];
+		trans->pos = t;
+
+		/* Write out the target state. */
+		ARRAY_ITEM( INT(trans->targ->id), ( t >= redFsm->transSet.length()-1 ) );
+	}
+	delete[] transPtrs;
+	return out;
+}
+
+std::ostream &JavaFlatCodeGen::TRANS_ACTIONS()
+{
+	/* Transitions must be written ordered by their id. */
+	RedTransAp **transPtrs = new RedTransAp*[redFsm->transSet.length()];
+	for ( TransApSet::Iter trans = redFsm->transSet; trans.lte(); trans++ )
+		transPtrs[trans->id] = trans;
+
+	/* Keep a count of the num of items in the array written. */
+	for ( int t = 0; t < redFsm->transSet.length(); t++ ) {
+		/* Write the function for the transition. */
+		RedTransAp *trans = transPtrs[t];
+		ARRAY_ITEM( INT(TRANS_ACTION( trans )), ( t >= redFsm->transSet.length()-1 ) );
+	}
+	delete[] transPtrs;
+	return out;
+}
+
+void JavaFlatCodeGen::LOCATE_TRANS()
+{
+	out <<
+		"	_keys = " << vCS() << "<<1;\n"
+		"	_inds = " << IO() << "[" << vCS() << "];\n"
+		"	_slen = " << SP() << "[" << vCS() << "];\n"
+		"	if ( _slen > 0 && " << K() << "[_keys] <= " << GET_WIDE_KEY() << " &&\n"
+		"			" << GET_WIDE_KEY() << " <= " << K() << "[_keys+1] )\n"
+		"		_trans = " << I() << "[_inds + " << GET_WIDE_KEY() << " - " << K() << "[_keys]];\n"
+		"	else\n"
+		"		_trans = " << I() << "[_inds + _slen];\n"
+		"\n";
+}
+
+std::ostream &JavaFlatCodeGen::COND_INDEX_OFFSET()
+{
+	int curIndOffset = 0;
+	for ( RedStateList::Iter st = redFsm->stateList; st.lte(); st++ ) {
+		/* Write the index offset. */
+		ARRAY_ITEM( INT(curIndOffset), st.last() );
+
+		/* Move the index offset ahead. */
+		if ( st->condList != 0 )
+			curIndOffset += keyOps->span( st->condLowKey, st->condHighKey );
+	}
+	return out;
+}
+
+void JavaFlatCodeGen::COND_TRANSLATE()
+{
+	out << 
+		"	_widec = " << GET_KEY() << ";\n"
+		"	_keys = " << vCS() << "<<1;\n"
+		"	_conds = " << CO() << "[" << vCS() << "];\n"
+		"	_slen = " << CSP() << "[" << vCS() << "];\n"
+		"	if ( _slen > 0 && " << CK() << "[_keys] <= _widec &&\n"
+		"			_widec <= " << CK() << "[_keys+1] )\n"
+		"		_cond = " << C() << "[_conds + _widec - " << CK() << "[_keys]];\n"
+		"	else\n"
+		"		_cond = 0;\n"
+		"\n"
+		"	switch ( _cond ) {\n";
+
+	for ( CondSpaceList::Iter csi = condSpaceList; csi.lte(); csi++ ) {
+		GenCondSpace *condSpace = csi;
+		out << "	case " << condSpace->condSpaceId + 1 << ": {\n";
+		out << TABS(2) << "_widec = " << KEY(condSpace->baseKey) << 
+				" + (" << GET_KEY() << " - " << KEY(keyOps->minKey) << ");\n";
+
+		for ( GenCondSet::Iter csi = condSpace->condSet; csi.lte(); csi++ ) {
+			out << TABS(2) << "if ( ";
+			CONDITION( out, *csi );
+			Size condValOffset = ((1 << csi.pos()) * keyOps->alphSize());
+			out << " ) _widec += " << condValOffset << ";\n";
+		}
+
+		out << 
+			"		break;\n"
+			"	}\n";
+	}
+
+	out << 
+		"	}\n"
+		"\n";
+}
+
+std::ostream &JavaFlatCodeGen::CONDS()
+{
+	for ( RedStateList::Iter st = redFsm->stateList; st.lte(); st++ ) {
+		if ( st->condList != 0 ) {
+			/* Walk the singles. */
+			unsigned long long span = keyOps->span( st->condLowKey, st->condHighKey );
+			for ( unsigned long long pos = 0; pos < span; pos++ ) {
+				if ( st->condList[pos] != 0 )
+					ARRAY_ITEM( INT( st->condList[pos]->condSpaceId + 1 ), false );
+				else
+					ARRAY_ITEM( INT(0), false );
+			}
+		}
+	}
+
+	/* Output one last number so we don't have to figure out when the last
+	 * entry is and avoid writing a comma. */
+	ARRAY_ITEM( INT(0), true );
+	return out;
+}
+
+std::ostream &JavaFlatCodeGen::COND_KEYS()
+{
+	for ( RedStateList::Iter st = redFsm->stateList; st.lte(); st++ ) {
+		/* Emit just cond low key and cond high key. */
+		ARRAY_ITEM( KEY( st->condLowKey ), false );
+		ARRAY_ITEM( KEY( st->condHighKey ), false );
+	}
+
+	/* Output one last number so we don't have to figure out when the last
+	 * entry is and avoid writing a comma. */
+	ARRAY_ITEM( INT(0), true );
+	return out;
+}
+
+std::ostream &JavaFlatCodeGen::COND_KEY_SPANS()
+{
+	for ( RedStateList::Iter st = redFsm->stateList; st.lte(); st++ ) {
+		/* Write singles length. */
+		unsigned long long span = 0;
+		if ( st->condList != 0 )
+			span = keyOps->span( st->condLowKey, st->condHighKey );
+		ARRAY_ITEM( INT(span), st.last() );
+	}
+	return out;
+}
+
+void JavaFlatCodeGen::writeData()
+{
+	/* If there are any transtion functions then output the array. If there
+	 * are none, don't bother emitting an empty array that won't be used. */
+	if ( redFsm->anyActions() ) {
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxActArrItem), A() );
+		ACTIONS_ARRAY();
+		CLOSE_ARRAY() <<
+		"\n";
+	}
+
+	if ( redFsm->anyConditions() ) {
+		OPEN_ARRAY( WIDE_ALPH_TYPE(), CK() );
+		COND_KEYS();
+		CLOSE_ARRAY() <<
+		"\n";
+
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxCondSpan), CSP() );
+		COND_KEY_SPANS();
+		CLOSE_ARRAY() <<
+		"\n";
+
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxCond), C() );
+		CONDS();
+		CLOSE_ARRAY() <<
+		"\n";
+
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxCondIndexOffset), CO() );
+		COND_INDEX_OFFSET();
+		CLOSE_ARRAY() <<
+		"\n";
+	}
+
+	OPEN_ARRAY( WIDE_ALPH_TYPE(), K() );
+	KEYS();
+	CLOSE_ARRAY() <<
+	"\n";
+
+	OPEN_ARRAY( ARRAY_TYPE(redFsm->maxSpan), SP() );
+	KEY_SPANS();
+	CLOSE_ARRAY() <<
+	"\n";
+
+	OPEN_ARRAY( ARRAY_TYPE(redFsm->maxFlatIndexOffset), IO() );
+	FLAT_INDEX_OFFSET();
+	CLOSE_ARRAY() <<
+	"\n";
+
+	OPEN_ARRAY( ARRAY_TYPE(redFsm->maxIndex), I() );
+	INDICIES();
+	CLOSE_ARRAY() <<
+	"\n";
+
+	OPEN_ARRAY( ARRAY_TYPE(redFsm->maxState), TT() );
+	TRANS_TARGS();
+	CLOSE_ARRAY() <<
+	"\n";
+
+	if ( redFsm->anyActions() ) {
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxActionLoc), TA() );
+		TRANS_ACTIONS();
+		CLOSE_ARRAY() <<
+		"\n";
+	}
+
+	if ( redFsm->anyToStateActions() ) {
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxActionLoc), TSA() );
+		TO_STATE_ACTIONS();
+		CLOSE_ARRAY() <<
+		"\n";
+	}
+
+	if ( redFsm->anyFromStateActions() ) {
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxActionLoc), FSA() );
+		FROM_STATE_ACTIONS();
+		CLOSE_ARRAY() <<
+		"\n";
+	}
+
+	if ( redFsm->anyEofActions() ) {
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxActionLoc), EA() );
+		EOF_ACTIONS();
+		CLOSE_ARRAY() <<
+		"\n";
+	}
+
+	if ( redFsm->anyEofTrans() ) {
+		OPEN_ARRAY( ARRAY_TYPE(redFsm->maxIndexOffset+1), ET() );
+		EOF_TRANS();
+		CLOSE_ARRAY() <<
+		"\n";
+	}
+
+	if ( redFsm->startState != 0 )
+		STATIC_VAR( "int", START() ) << " = " << START_STATE_ID() << ";\n";
+
+	if ( !noFinal )
+		STATIC_VAR( "int" , FIRST_FINAL() ) << " = " << FIRST_FINAL_STATE() << ";\n";
+
+	if ( !noError )
+		STATIC_VAR( "int", ERROR() ) << " = " << ERROR_STATE() << ";\n";
+	
+	out << "\n";
+
+	if ( entryPointNames.length() > 0 ) {
+		for ( EntryNameVect::Iter en = entryPointNames; en.lte(); en++ ) {
+			STATIC_VAR( "int", DATA_PREFIX() + "en_" + *en ) << 
+					" = " << entryPointIds[en.pos()] << ";\n";
+		}
+		out << "\n";
+	}
+}
+
+void JavaFlatCodeGen::writeExec()
+{
+	out <<
+		"	{\n"
+		"	int _slen";
+
+	if ( redFsm->anyRegCurStateRef() )
+		out << ", _ps";
+
+	out << 
+		";\n"
+		"	int _trans = 0;\n";
+
+	if ( redFsm->anyConditions() )
+		out << "	int _cond, _conds, _widec;\n";
+
+	if ( redFsm->anyToStateActions() || redFsm->anyRegActions() || 
+			redFsm->anyFromStateActions() )
+	{
+		out << 
+			"	int _acts;\n"
+			"	int _nacts;\n";
+	}
+
+	out <<
+		"	int _keys;\n"
+		"	int _inds;\n"
+		"	int _goto_targ = 0;\n"
+		"\n";
+	
+	out <<
+		"	_goto: while (true) {\n"
+		"	switch ( _goto_targ ) {\n"
+		"	case 0:\n";
+
+	if ( !noEnd ) {
+		out << 
+			"	if ( " << P() << " == " << PE() << " ) {\n"
+			"		_goto_targ = " << _test_eof << ";\n"
+			"		continue _goto;\n"
+			"	}\n";
+	}
+
+	if ( redFsm->errState != 0 ) {
+		out << 
+			"	if ( " << vCS() << " == " << redFsm->errState->id << " ) {\n"
+			"		_goto_targ = " << _out << ";\n"
+			"		continue _goto;\n"
+			"	}\n";
+	}
+
+	out << "case " << _resume << ":\n"; 
+
+	if ( redFsm->anyFromStateActions() ) {
+		out <<
+			"	_acts = " << FSA() << "[" << vCS() << "]" << ";\n"
+			"	_nacts = " << CAST("int") << " " << A() << "[_acts++];\n"
+			"	while ( _nacts-- > 0 ) {\n"
+			"		switch ( " << A() << "[_acts++] ) {\n";
+			FROM_STATE_ACTION_SWITCH() <<
+			"		}\n"
+			"	}\n"
+			"\n";
+	}
+
+	if ( redFsm->anyConditions() )
+		COND_TRANSLATE();
+
+	LOCATE_TRANS();
+
+	if ( redFsm->anyEofTrans() )
+		out << "case " << _eof_trans << ":\n";
+
+	if ( redFsm->anyRegCurStateRef() )
+		out << "	_ps = " << vCS() << ";\n";
+
+	out <<
+		"	" << vCS() << " = " << TT() << "[_trans];\n"
+		"\n";
+
+	if ( redFsm->anyRegActions() ) {
+		out <<
+			"	if ( " << TA() << "[_trans] != 0 ) {\n"
+			"		_acts = " <<  TA() << "[_trans]" << ";\n"
+			"		_nacts = " << CAST("int") << " " <<  A() << "[_acts++];\n"
+			"		while ( _nacts-- > 0 )\n	{\n"
+			"			switch ( " << A() << "[_acts++] )\n"
+			"			{\n";
+			ACTION_SWITCH() <<
+			"			}\n"
+			"		}\n"
+			"	}\n"
+			"\n";
+	}
+
+	out << "case " << _again << ":\n";
+
+	if ( redFsm->anyToStateActions() ) {
+		out <<
+			"	_acts = " << TSA() << "[" << vCS() << "]" << ";\n"
+			"	_nacts = " << CAST("int") << " " << A() << "[_acts++];\n"
+			"	while ( _nacts-- > 0 ) {\n"
+			"		switch ( " << A() << "[_acts++] ) {\n";
+			TO_STATE_ACTION_SWITCH() <<
+			"		}\n"
+			"	}\n"
+			"\n";
+	}
+
+	if ( redFsm->errState != 0 ) {
+		out << 
+			"	if ( " << vCS() << " == " << redFsm->errState->id << " ) {\n"
+			"		_goto_targ = " << _out << ";\n"
+			"		continue _goto;\n"
+			"	}\n";
+	}
+
+	if ( !noEnd ) {
+		out << 
+			"	if ( ++" << P() << " != " << PE() << " ) {\n"
+			"		_goto_targ = " << _resume << ";\n"
+			"		continue _goto;\n"
+			"	}\n";
+	}
+	else {
+		out << 
+			"	" << P() << " += 1;\n"
+			"	_goto_targ = " << _resume << ";\n"
+			"	continue _goto;\n";
+	}
+
+	out << "case " << _test_eof << ":\n"; 
+
+	if ( redFsm->anyEofTrans() || redFsm->anyEofActions() ) {
+		out <<
+			"	if ( " << P() << " == " << vEOF() << " )\n"
+			"	{\n";
+
+		if ( redFsm->anyEofTrans() ) {
+			out <<
+				"	if ( " << ET() << "[" << vCS() << "] > 0 ) {\n"
+				"		_trans = " << ET() << "[" << vCS() << "] - 1;\n"
+				"		_goto_targ = " << _eof_trans << ";\n"
+				"		continue _goto;\n"
+				"	}\n";
+		}
+
+		if ( redFsm->anyEofActions() ) {
+			out <<
+				"	int __acts = " << EA() << "[" << vCS() << "]" << ";\n"
+				"	int __nacts = " << CAST("int") << " " << A() << "[__acts++];\n"
+				"	while ( __nacts-- > 0 ) {\n"
+				"		switch ( " << A() << "[__acts++] ) {\n";
+				EOF_ACTION_SWITCH() <<
+				"		}\n"
+				"	}\n";
+		}
+
+		out <<
+			"	}\n"
+			"\n";
+	}
+
+	out << "case " << _out << ":\n"; 
+
+	/* The switch and goto loop. */
+	out << "	}\n";
+	out << "	break; }\n";
+
+	/* The execute block. */
+	out << "	}\n";
+}
@@ -0,0 +1,51 @@
+/*
+ *  Copyright 2026 agent <agent@local>
+ */
+
+/*  This file is part of Ragel.
+ *
+ *  Ragel is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  Ragel is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with Ragel; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#ifndef _JAVAFTABLE_H
+#define _JAVAFTABLE_H
+
+#include "javacodegen.h"
+
+/*
+ * JavaFTabCodeGen
+ */
+struct JavaFTabCodeGen : public JavaTabCodeGen
+{
+	JavaFTabCodeGen( const CodeGenArgs &args ) :
+		JavaTabCodeGen(args) {}
+
+	std::ostream &TO_STATE_ACTION_SWITCH();
+	std::ostream &FROM_STATE_ACTION_SWITCH();
+	std::ostream &EOF_ACTION_SWITCH();
+	std::ostream &ACTION_SWITCH();
+
+	int TO_STATE_ACTION( RedStateAp *state );
+	int FROM_STATE_ACTION( RedStateAp *state );
+	int EOF_ACTION( RedStateAp *state );
+	int TRANS_ACTION( RedTransAp *trans );
+
+	void calcIndexSize();
+
+	virtual void writeData();
+	virtual void writeExec();
+};
+
+#endif
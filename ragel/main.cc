@@ -55,6 +55,7 @@
 #include "version.h"
 #include "common.h"
 #include "inputdata.h"
+#include "profile.h"
 
 using std::istream;
 using std::ostream;
@@ -71,6 +72,9 @@ using std::streamsize;
 MinimizeLevel minimizeLevel = MinimizePartition2;
 MinimizeOpt minimizeOpt = MinimizeMostOps;
 
+/* Number of threads used to sort the states of large partitions. */
+int minimizeThreads = 1;
+
 /* Graphviz dot file generation. */
 const char *machineSpec = 0, *machineName = 0;
 bool machineSpecFound = false;
@@ -80,12 +84,59 @@ bool generateXML = false;
 bool generateDot = false;
 bool printStatistics = false;
 
+/* Where to write the timing and memory use of each phase. */
+const char *profileFileName = 0;
+ProfileFormat profileFormat = ProfileJSON;
+
 /* Target language and output style. */
 CodeStyle codeStyle = GenTables;
 
 int numSplitPartitions = 0;
 bool noLineDirectives = false;
 
+/* Size of the state cache when the lazy DFA runtime is used. Zero when the
+ * machine is fully determinized. */
+int lazyDfaStates = 0;
+
+/* Encode tables as strings. Java unpacks them when the generated class is
+ * loaded, Ruby reads the items out of the strings directly. */
+bool packedTables = false;
+
+/* Pad tables to a power of two and mask the indicies used to read them. */
+bool maskIndices = false;
+
+/* Write tables as static data blobs that are read without bounds checks. */
+bool spanTables = false;
+
+/* Read OCaml tables with unsafe_get and keep them in bigarrays outside the
+ * collected heap. The input is always read with checks. */
+bool unsafeAccess = false;
+bool bigarrayTables = false;
+
+/* Count the characters consumed in each state and the uses of each
+ * transition at runtime. */
+bool instrument = false;
+
+/* Write the tables of each machine to a binary file that is loaded at
+ * runtime, with an executor that binds actions by name. */
+bool tableBlob = false;
+
+/* Write arrays that are identical to an array of an earlier machine in the
+ * output as a name for that array. */
+bool shareTables = false;
+
+/* Repetitions of a single character with a bound at least this large are
+ * built as a loop that keeps its count in a runtime counter. Zero when
+ * repetitions are always unrolled. */
+int countedRepetition = 0;
+
+/* The number of tests the goto states of a -G3 machine may use, and the
+ * counter dump that ranks the states by the input they consumed. The budget
+ * is only checked against the code style when it was given. */
+long gotoBudget = 512;
+static bool gotoBudgetGiven = false;
+const char *gotoProfileFileName = 0;
+
 bool displayPrintables = false;
 
 /* Target ruby impl */
@@ -101,6 +152,11 @@ void usage()
 "   -v, --version        Print version information and exit\n"
 "   -o <file>            Write output to <file>\n"
 "   -s                   Print some statistics on stderr\n"
+"   --profile=<file>     Write the time, machine size and memory use of each\n"
+"                        compilation phase to <file>\n"
+"   --profile-format=json|chrome\n"
+"                        Write the profile as plain JSON (default) or in the\n"
+"                        Chrome trace event format\n"
 "   -d                   Do not remove duplicates from action lists\n"
 "   -I <dir>             Add <dir> to the list of directories to search\n"
 "                        for included an imported files\n"
@@ -112,6 +168,7 @@ void usage()
 "   -m                   Minimize at the end of the compilation\n"
 "   -l                   Minimize after most operations (default)\n"
 "   -e                   Minimize after every operation\n"
+"   --min-threads=<N>    Sort the states of partitions with N threads\n"
 "visualization:\n"
 "   -x                   Run the frontend only: emit XML intermediate format\n"
 "   -V                   Generate a dot file for Graphviz\n"
@@ -128,21 +185,59 @@ void usage()
 "   -O                   The host language is OCaml\n"
 "line directives: (C/D/Ruby/C#)\n"
 "   -L                   Inhibit writing of #line directives\n"
-"code style: (C/D/Java/Ruby/C#)\n"
+"code style: (C/D/Go/Java/Ruby/C#)\n"
 "   -T0                  Table driven FSM (default)\n"
-"code style: (C/D/Ruby/C#)\n"
-"   -T1                  Faster table driven FSM\n"
 "   -F0                  Flat table driven FSM\n"
+"code style: (C/D/Java/Ruby/C#)\n"
+"   -T1                  Faster table driven FSM\n"
 "   -F1                  Faster flat table-driven FSM\n"
 "code style: (C/D/C#)\n"
 "   -G0                  Goto-driven FSM\n"
 "   -G1                  Faster goto-driven FSM\n"
 "code style: (C/D)\n"
+"   -F2                  Comb vector (row displacement) table driven FSM\n"
 "   -G2                  Really fast goto-driven FSM\n"
 "   -P<N>                N-Way Split really fast goto-driven FSM\n"
+"   -G3                  Goto code for the cheapest or hottest states and flat\n"
+"                        tables for the rest\n"
+"hybrid code style: (C/D)\n"
+"   --goto-budget=<N>    Tests the goto states of -G3 may use (default 512)\n"
+"   --goto-profile=<file>\n"
+"                        Rank the states of -G3 by the bytes they consumed in\n"
+"                        a counter dump written by --instrument\n"
+"table encoding: (Java/Ruby)\n"
+"   --packed-tables      Encode tables as strings unpacked at class load (Java)\n"
+"                        or read as binary strings (Ruby)\n"
+"table access: (Go)\n"
+"   --mask-indices       Pad tables to a power of two and mask every index so\n"
+"                        the compiler can drop bounds checks\n"
+"static data: (C#)\n"
+"   --span-tables        Write tables as static data read through spans,\n"
+"                        without bounds checks\n"
+"table access: (OCaml)\n"
+"   --unsafe-access      Read tables with unsafe_get\n"
+"   --bigarray-tables    Write tables as bigarrays that the GC does not scan\n"
+"runtime counters: (C/D/Go)\n"
+"   --instrument         Count the uses of each state and transition in the\n"
+"                        generated code and write a function to dump them\n"
+"table blob: (C)\n"
+"   --table-blob         Write the tables of each machine to a binary file and\n"
+"                        a loader and executor that bind actions by name\n"
+"shared tables: (C)\n"
+"   --share-tables       Write an array that is identical to one of an earlier\n"
+"                        machine in the output as a name for that array\n"
+"counted repetition: (C/D/Go)\n"
+"   --counted-repetition[=<N>]\n"
+"                        Build repetitions of a single character with a bound\n"
+"                        of at least N as a loop checked by a runtime counter\n"
+"                        (default 16)\n"
+"lazy determinization: (C)\n"
+"   --lazy-dfa[=<N>]     Emit the components of the main machine and a runtime\n"
+"                        that builds DFA states on demand in an N state cache\n"
+"                        (default 256)\n"
 	;	
 
-	exit(0);
+	exitCompile(0);
 }
 
 /* Print version information and exit. */
@@ -150,7 +245,7 @@ void version()
 {
 	cout << "Ragel State Machine Compiler version " VERSION << " " PUBDATE << endl <<
 			"Copyright (c) 2001-2009 by Adrian Thurston" << endl;
-	exit(0);
+	exitCompile(0);
 }
 
 /* Error reporting format. */
@@ -192,6 +287,13 @@ ostream &warning( const InputLoc &loc )
 	return cerr;
 }
 
+/* Print the opening to a program warning, then return the error stream. */
+ostream &warning()
+{
+	cerr << PROGNAME ": warning: ";
+	return cerr;
+}
+
 /* Print the opening to a program error, then return the error stream. */
 ostream &error()
 {
@@ -217,6 +319,50 @@ void escapeLineDirectivePath( std::ostream &out, char *path )
 	}
 }
 
+/* Put the options and the state shared by the compiler back to the way they
+ * are at startup, so a compilation does not see the settings of the last
+ * one. */
+void resetOptions()
+{
+	minimizeLevel = MinimizePartition2;
+	minimizeOpt = MinimizeMostOps;
+	minimizeThreads = 1;
+	machineSpec = machineName = 0;
+	machineSpecFound = false;
+	wantDupsRemoved = true;
+	generateXML = false;
+	generateDot = false;
+	printStatistics = false;
+	profileFileName = 0;
+	profileFormat = ProfileJSON;
+	codeStyle = GenTables;
+	numSplitPartitions = 0;
+	noLineDirectives = false;
+	lazyDfaStates = 0;
+	packedTables = false;
+	maskIndices = false;
+	spanTables = false;
+	unsafeAccess = false;
+	bigarrayTables = false;
+	instrument = false;
+	tableBlob = false;
+	shareTables = false;
+	countedRepetition = 0;
+	gotoBudget = 512;
+	gotoBudgetGiven = false;
+	free( (char*)gotoProfileFileName );
+	gotoProfileFileName = 0;
+	displayPrintables = false;
+	rubyImpl = MRI;
+	errorFormat = ErrorFormatGNU;
+	gblErrorCount = 0;
+
+	hostLang = &hostLangC;
+	keyOps = 0;
+	condData = 0;
+	resetProfile();
+}
+
 void InputData::parseArgs( int argc, const char **argv )
 {
 	ParamCheck pc("xo:dnmleabjkS:M:I:CDEJZRAOvHh?-:sT:F:G:P:LpV", argc, argv);
@@ -367,8 +513,89 @@ void InputData::parseArgs( int argc, const char **argv )
 					else
 						error() << "invalid value for error-format" << endl;
 				}
+				else if ( strcmp( arg, "profile" ) == 0 ) {
+					if ( eq == 0 )
+						error() << "expecting '=file' for profile" << endl;
+					else
+						profileFileName = strdup( eq );
+				}
+				else if ( strcmp( arg, "profile-format" ) == 0 ) {
+					if ( eq == 0 )
+						error() << "expecting '=value' for profile-format" << endl;
+					else if ( strcmp( eq, "json" ) == 0 )
+						profileFormat = ProfileJSON;
+					else if ( strcmp( eq, "chrome" ) == 0 )
+						profileFormat = ProfileChromeTrace;
+					else
+						error() << "invalid value for profile-format" << endl;
+				}
 				else if ( strcmp( arg, "rbx" ) == 0 )
 					rubyImpl = Rubinius;
+				else if ( strcmp( arg, "lazy-dfa" ) == 0 ) {
+					lazyDfaStates = 256;
+					if ( eq != 0 ) {
+						lazyDfaStates = atoi( eq );
+						if ( lazyDfaStates < 2 ) {
+							error() << "the lazy DFA cache must hold "
+									"at least two states" << endl;
+						}
+					}
+				}
+				else if ( strcmp( arg, "packed-tables" ) == 0 )
+					packedTables = true;
+				else if ( strcmp( arg, "mask-indices" ) == 0 )
+					maskIndices = true;
+				else if ( strcmp( arg, "span-tables" ) == 0 )
+					spanTables = true;
+				else if ( strcmp( arg, "unsafe-access" ) == 0 )
+					unsafeAccess = true;
+				else if ( strcmp( arg, "bigarray-tables" ) == 0 )
+					bigarrayTables = true;
+				else if ( strcmp( arg, "instrument" ) == 0 )
+					instrument = true;
+				else if ( strcmp( arg, "table-blob" ) == 0 )
+					tableBlob = true;
+				else if ( strcmp( arg, "share-tables" ) == 0 )
+					shareTables = true;
+				else if ( strcmp( arg, "min-threads" ) == 0 ) {
+					if ( eq == 0 )
+						error() << "expecting '=N' for min-threads" << endl;
+					else {
+						minimizeThreads = atoi( eq );
+						if ( minimizeThreads < 1 ) {
+							error() << "the number of minimization threads "
+									"must be at least one" << endl;
+						}
+					}
+				}
+				else if ( strcmp( arg, "goto-budget" ) == 0 ) {
+					if ( eq == 0 )
+						error() << "expecting '=N' for goto-budget" << endl;
+					else {
+						gotoBudget = atol( eq );
+						gotoBudgetGiven = true;
+						if ( gotoBudget < 0 )
+							error() << "the goto budget cannot be negative" << endl;
+					}
+				}
+				else if ( strcmp( arg, "goto-profile" ) == 0 ) {
+					if ( eq == 0 )
+						error() << "expecting '=file' for goto-profile" << endl;
+					else {
+						free( (char*)gotoProfileFileName );
+						gotoProfileFileName = strdup( eq );
+					}
+				}
+				else if ( strcmp( arg, "counted-repetition" ) == 0 ) {
+					countedRepetition = 16;
+					if ( eq != 0 ) {
+						countedRepetition = atoi( eq );
+						if ( countedRepetition < 2 ) {
+							error() << "the counted repetition bound must "
+									"be at least two" << endl;
+						}
+					}
+				}
 				else {
 					error() << "--" << pc.paramArg << 
 							" is an invalid argument" << endl;
@@ -386,7 +613,7 @@ void InputData::parseArgs( int argc, const char **argv )
 				else {
 					error() << "-T" << pc.paramArg[0] << 
 							" is an invalid argument" << endl;
-					exit(1);
+					exitCompile(1);
 				}
 				break;
 			case 'F': 
@@ -394,10 +621,12 @@ void InputData::parseArgs( int argc, const char **argv )
 					codeStyle = GenFlat;
 				else if ( pc.paramArg[0] == '1' )
 					codeStyle = GenFFlat;
+				else if ( pc.paramArg[0] == '2' )
+					codeStyle = GenComb;
 				else {
 					error() << "-F" << pc.paramArg[0] << 
 							" is an invalid argument" << endl;
-					exit(1);
+					exitCompile(1);
 				}
 				break;
 			case 'G': 
@@ -407,10 +636,12 @@ void InputData::parseArgs( int argc, const char **argv )
 					codeStyle = GenFGoto;
 				else if ( pc.paramArg[0] == '2' )
 					codeStyle = GenIpGoto;
+				else if ( pc.paramArg[0] == '3' )
+					codeStyle = GenHybrid;
 				else {
 					error() << "-G" << pc.paramArg[0] << 
 							" is an invalid argument" << endl;
-					exit(1);
+					exitCompile(1);
 				}
 				break;
 			case 'P':
@@ -454,9 +685,97 @@ void InputData::checkArgs()
 	if ( inputFileName == 0 )
 		error() << "no input file given" << endl;
 
+#ifndef HAVE_LIBPTHREAD
+	if ( minimizeThreads > 1 )
+		warning() << "--min-threads has no effect, ragel was built without pthreads" << endl;
+#endif
+
+	if ( lazyDfaStates > 0 ) {
+		if ( hostLang->lang != HostLang::C )
+			error() << "--lazy-dfa is only supported for C" << endl;
+		if ( generateXML || generateDot )
+			error() << "--lazy-dfa cannot be used with -x or -V" << endl;
+	}
+
+	if ( packedTables && hostLang->lang != HostLang::Java &&
+			hostLang->lang != HostLang::Ruby )
+		error() << "--packed-tables is only supported for Java and Ruby" << endl;
+
+	if ( maskIndices ) {
+		if ( hostLang->lang != HostLang::Go )
+			error() << "--mask-indices is only supported for Go" << endl;
+		else if ( codeStyle != GenTables && codeStyle != GenFlat )
+			error() << "--mask-indices requires -T0 or -F0" << endl;
+	}
+
+	if ( spanTables ) {
+		if ( hostLang->lang != HostLang::CSharp )
+			error() << "--span-tables is only supported for C#" << endl;
+		else if ( codeStyle != GenTables && codeStyle != GenFTables &&
+				codeStyle != GenFlat && codeStyle != GenFFlat )
+			error() << "--span-tables requires -T0, -T1, -F0 or -F1" << endl;
+	}
+
+	if ( unsafeAccess && hostLang->lang != HostLang::OCaml )
+		error() << "--unsafe-access is only supported for OCaml" << endl;
+
+	if ( bigarrayTables && hostLang->lang != HostLang::OCaml )
+		error() << "--bigarray-tables is only supported for OCaml" << endl;
+
+	if ( instrument ) {
+		if ( hostLang->lang != HostLang::C && hostLang->lang != HostLang::D &&
+				hostLang->lang != HostLang::D2 && hostLang->lang != HostLang::Go )
+			error() << "--instrument is only supported for C, D and Go" << endl;
+		else if ( codeStyle != GenTables && codeStyle != GenFTables &&
+				codeStyle != GenFlat && codeStyle != GenFFlat )
+			error() << "--instrument requires -T0, -T1, -F0 or -F1" << endl;
+		else if ( lazyDfaStates > 0 )
+			error() << "--instrument cannot be used with --lazy-dfa" << endl;
+	}
+
+	if ( tableBlob ) {
+		if ( hostLang->lang != HostLang::C )
+			error() << "--table-blob is only supported for C" << endl;
+		else if ( codeStyle != GenTables )
+			error() << "--table-blob requires -T0" << endl;
+		else if ( generateXML || generateDot )
+			error() << "--table-blob cannot be used with -x or -V" << endl;
+		else if ( lazyDfaStates > 0 || instrument )
+			error() << "--table-blob cannot be used with --lazy-dfa or --instrument" << endl;
+	}
+
+	if ( shareTables ) {
+		if ( hostLang->lang != HostLang::C )
+			error() << "--share-tables is only supported for C" << endl;
+		else if ( generateXML || generateDot )
+			error() << "--share-tables cannot be used with -x or -V" << endl;
+		else if ( tableBlob )
+			error() << "--share-tables cannot be used with --table-blob" << endl;
+	}
+
+	if ( countedRepetition > 0 ) {
+		if ( hostLang->lang != HostLang::C && hostLang->lang != HostLang::D &&
+				hostLang->lang != HostLang::D2 && hostLang->lang != HostLang::Go )
+			error() << "--counted-repetition is only supported for C, D and Go" << endl;
+		else if ( lazyDfaStates > 0 || tableBlob )
+			error() << "--counted-repetition cannot be used with --lazy-dfa or --table-blob" << endl;
+	}
+
+	if ( codeStyle == GenHybrid ) {
+		if ( hostLang->lang != HostLang::C && hostLang->lang != HostLang::D &&
+				hostLang->lang != HostLang::D2 )
+			error() << "-G3 is only supported for C and D" << endl;
+	}
+	else {
+		if ( gotoBudgetGiven )
+			error() << "--goto-budget requires -G3" << endl;
+		if ( gotoProfileFileName != 0 )
+			error() << "--goto-profile requires -G3" << endl;
+	}
+
 	/* Bail on argument processing errors. */
 	if ( gblErrorCount > 0 )
-		exit(1);
+		exitCompile(1);
 
 	/* Make sure we are not writing to the same file as the input file. */
 	if ( inputFileName != 0 && outputFileName != 0 && 
@@ -466,16 +785,3 @@ void InputData::checkArgs()
 				"\" is the same as the input file" << endp;
 	}
 }
-
-
-/* Main, process args and call yyparse to start scanning input. */
-int main( int argc, const char **argv )
-{
-	InputData id;
-
-	id.parseArgs( argc, argv );
-	id.checkArgs();
-	id.process();
-
-	return 0;
-}
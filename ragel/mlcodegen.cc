@@ -29,6 +29,7 @@
 #include <iomanip>
 #include <string>
 #include <assert.h>
+#include <stdlib.h>
 
 using std::ostream;
 using std::ostringstream;
@@ -71,7 +72,8 @@ void OCamlCodeGen::genLineDirective( ostream &out )
 /* Init code gen with in parameters. */
 OCamlCodeGen::OCamlCodeGen( const CodeGenArgs &args )
 :
-	CodeGenData(args)
+	CodeGenData(args),
+	arraySaved(0)
 {
 }
 
@@ -406,6 +408,11 @@ void OCamlCodeGen::INLINE_LIST( ostream &ret, GenInlineList *inlineList,
 		case GenInlineItem::Break:
 			BREAK( ret, targState );
 			break;
+		case GenInlineItem::RepInit:
+		case GenInlineItem::RepIncr:
+		case GenInlineItem::RepTest:
+			/* Counted repetition is not supported for this language. */
+			break;
 		}
 	}
 }
@@ -600,7 +607,8 @@ string OCamlCodeGen::GET_KEY()
 		ret << ")";
 	}
 	else {
-		/* Expression for retrieving the key, use simple dereference. */
+		/* Expression for retrieving the key, use simple dereference. The
+		 * input and p come from the host, so the read stays checked. */
 		ret << "data.[" << P() << "]";
 	}
 	return ret.str();
@@ -624,13 +632,59 @@ string OCamlCodeGen::PTR_CONST()
 
 std::ostream &OCamlCodeGen::OPEN_ARRAY( string type, string name )
 {
+	if ( bigarrayTables ) {
+		arrayName = name;
+		arrayBuf.str( "" );
+		arraySaved = out.rdbuf( arrayBuf.rdbuf() );
+		return out;
+	}
+
 	out << "let " << name << " : " << type << " array = [|" << endl;
 	return out;
 }
 
 std::ostream &OCamlCodeGen::CLOSE_ARRAY()
 {
-	return out << "|]" << TOP_SEP();
+	if ( !bigarrayTables )
+		return out << "|]" << TOP_SEP();
+
+	out.rdbuf( arraySaved );
+	arraySaved = 0;
+
+	string items = arrayBuf.str();
+	long long min = 0, max = 0;
+	const char *p = items.c_str();
+	while ( *p != 0 ) {
+		char *end;
+		long long item = strtoll( p, &end, 10 );
+		if ( end == p ) {
+			p += 1;
+			continue;
+		}
+		if ( item < min )
+			min = item;
+		if ( item > max )
+			max = item;
+		p = end;
+	}
+
+	/* Use the narrowest element kind that holds every item. The data lives
+	 * outside the heap, so the collector does not scan it. */
+	const char *kind = "int";
+	if ( min >= 0 && max <= 0xff )
+		kind = "int8_unsigned";
+	else if ( min >= -0x80 && max <= 0x7f )
+		kind = "int8_signed";
+	else if ( min >= 0 && max <= 0xffff )
+		kind = "int16_unsigned";
+	else if ( min >= -0x8000 && max <= 0x7fff )
+		kind = "int16_signed";
+
+	out << "let " << arrayName << " : (int, Bigarray." << kind <<
+			"_elt, Bigarray.c_layout) Bigarray.Array1.t =\n"
+			"  Bigarray.Array1.of_array Bigarray." << kind <<
+			" Bigarray.c_layout [|\n" << items << "|]" << TOP_SEP();
+	return out;
 }
 
 string OCamlCodeGen::TOP_SEP()
@@ -646,7 +700,20 @@ string OCamlCodeGen::ARR_SEP()
 string OCamlCodeGen::AT(const string& array, const string& index)
 {
   ostringstream ret;
-  ret << array << ".(" << index << ")";
+
+	/* Indicies into the tables come from the tables themselves, so with
+	 * --unsafe-access they are read without a bounds check. The stack belongs
+	 * to the host program and is always checked. */
+	if ( array == STACK() )
+		ret << array << ".(" << index << ")";
+	else if ( bigarrayTables && unsafeAccess )
+		ret << "(Bigarray.Array1.unsafe_get " << array << " (" << index << "))";
+	else if ( bigarrayTables )
+		ret << array << ".{" << index << "}";
+	else if ( unsafeAccess )
+		ret << "(Array.unsafe_get " << array << " (" << index << "))";
+	else
+		ret << array << ".(" << index << ")";
   return ret.str();
 }
 
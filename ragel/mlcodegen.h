@@ -25,6 +25,7 @@
 #define _MLCODEGEN_H
 
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <stdio.h>
 #include "common.h"
@@ -181,6 +182,12 @@ protected:
   // access array
   string AT(const string& array, const string& index);
 
+	/* With --bigarray-tables the items are collected so the element kind
+	 * can be chosen when the array is closed. */
+	string arrayName;
+	std::ostringstream arrayBuf;
+	std::streambuf *arraySaved;
+
   string make_access(char const* name, GenInlineList* x, bool prefix);
 
 	ostream &source_warning(const InputLoc &loc);
@@ -22,6 +22,7 @@
 #include <iostream>
 #include <iomanip>
 #include <errno.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <limits.h>
 
@@ -33,6 +34,8 @@
 #include "xmlcodegen.h"
 #include "version.h"
 #include "inputdata.h"
+#include "unicode.h"
+#include "profile.h"
 
 using namespace std;
 
@@ -57,12 +60,34 @@ void Token::append( const Token &other )
 	length = newLength;
 }
 
+/* Cheaply reduce an operand before an operation whose cost grows with the
+ * size of its inputs. With -m nothing is minimized until the end, so one
+ * hashed pass merges the states with identical out transitions, such as the
+ * duplicate final states of a union. With -l and -e the operands have
+ * already been minimized after their last op. */
+void beforeOpMinimize( FsmAp *fsm )
+{
+	if ( minimizeOpt == MinimizeEnd ) {
+		ProfilePhase phase( "pre-minimize" );
+		phase.input( fsm );
+
+		fsm->removeUnreachableStates();
+		fsm->internTables();
+		fsm->mergeDuplicateStates();
+
+		phase.finish( fsm );
+	}
+}
+
 /* Perform minimization after an operation according 
  * to the command line args. */
 void afterOpMinimize( FsmAp *fsm, bool lastInSeq )
 {
 	/* Switch on the prefered minimization algorithm. */
 	if ( minimizeOpt == MinimizeEveryOp || ( minimizeOpt == MinimizeMostOps && lastInSeq ) ) {
+		ProfilePhase phase( "minimize" );
+		phase.input( fsm );
+
 		/* First clean up the graph. FsmAp operations may leave these
 		 * lying around. There should be no dead end states. The subtract
 		 * intersection operators are the only places where they may be
@@ -83,6 +108,8 @@ void afterOpMinimize( FsmAp *fsm, bool lastInSeq )
 				fsm->minimizeStable();
 				break;
 		}
+
+		phase.finish( fsm );
 	}
 }
 
@@ -243,8 +270,9 @@ FsmAp *dotStarFsm( ParseData *pd )
 	return retFsm;
 }
 
-/* Make a builtin type. Depends on the signed nature of the alphabet type. */
-FsmAp *makeBuiltin( BuiltinMachine builtin, ParseData *pd )
+/* Make a builtin type. Depends on the signed nature of the alphabet type. For
+ * the unicode builtins the category indexes unicodeCategories. */
+FsmAp *makeBuiltin( BuiltinMachine builtin, ParseData *pd, int category )
 {
 	/* FsmAp created to return. */
 	FsmAp *retFsm = 0;
@@ -382,6 +410,29 @@ FsmAp *makeBuiltin( BuiltinMachine builtin, ParseData *pd )
 		retFsm = digit;
 		break;
 	}
+	case BT_Utf8: {
+		/* Unicode general category as UTF-8 byte sequences. */
+		UnicodeCategory &uc = unicodeCategories[category];
+		retFsm = new FsmAp();
+		retFsm->utf8RangeFsm( uc.ranges, uc.numRanges );
+		break;
+	}
+	case BT_Utf16: {
+		/* Unicode general category as UTF-16 code units. Needs at least a
+		 * 16 bit alphabet. */
+		UnicodeCategory &uc = unicodeCategories[category];
+		retFsm = new FsmAp();
+		if ( keyOps->alphType->size < 2 ) {
+			InputLoc &loc = pd->alphTypeSet ? pd->alphTypeLoc : pd->sectionLoc;
+			error(loc) << "utf16_" << uc.name << " requires an alphabet "
+					"type of at least 16 bits" << endl;
+			retFsm->emptyFsm();
+		}
+		else {
+			retFsm->utf16RangeFsm( uc.ranges, uc.numRanges );
+		}
+		break;
+	}
 	case BT_Lambda: {
 		retFsm = new FsmAp();
 		retFsm->lambdaFsm();
@@ -411,6 +462,18 @@ bool NameInst::anyRefsRec()
 	return false;
 }
 
+NameInst::~NameInst()
+{
+	for ( NameVect::Iter ch = childVect; ch.lte(); ch++ )
+		delete *ch;
+}
+
+/* The definition and its parse tree belong to the dict element. */
+GraphDictEl::~GraphDictEl()
+{
+	delete value;
+}
+
 /*
  * ParseData
  */
@@ -442,6 +505,7 @@ ParseData::ParseData( const char *fileName, char *sectionName,
 	tokstartExpr(0),
 	tokendExpr(0),
 	dataExpr(0),
+	countersExpr(0),
 	lowerNum(0),
 	upperNum(0),
 	fileName(fileName),
@@ -452,8 +516,10 @@ ParseData::ParseData( const char *fileName, char *sectionName,
 	rootName(0),
 	exportsRootName(0),
 	nextEpsilonResolvedLink(0),
+	nameIndex(0),
 	nextLongestMatchId(1),
 	lmRequiresErrorState(false),
+	numRepCounters(0),
 	cgd(0)
 {
 	/* Initialize the dictionary of graphs. This is our symbol table. The
@@ -467,8 +533,21 @@ ParseData::ParseData( const char *fileName, char *sectionName,
 ParseData::~ParseData()
 {
 	/* Delete all the nodes in the action list. Will cause all the
-	 * string data that represents the actions to be deallocated. */
+	 * string data that represents the actions to be deallocated. The
+	 * dictionary holds the same actions. */
 	actionList.empty();
+	actionDict.abandon();
+
+	/* Instances are also in the graph dict, which deletes the definitions
+	 * and their parse trees. The longest matches are in the parse trees. */
+	instanceList.abandon();
+	lmList.abandon();
+
+	delete rootName;
+	delete exportsRootName;
+	delete[] nameIndex;
+	delete sectionGraph;
+	delete cgd;
 }
 
 /* Make a name id in the current name instantiation scope if it is not
@@ -825,9 +904,9 @@ void ParseData::makeNameTree( GraphDictEl *dictEl )
 }
 
 
-void ParseData::createBuiltin( const char *name, BuiltinMachine builtin )
+void ParseData::createBuiltin( const char *name, BuiltinMachine builtin, int category )
 {
-	Expression *expression = new Expression( builtin );
+	Expression *expression = new Expression( builtin, category );
 	Join *join = new Join( expression );
 	MachineDef *machineDef = new MachineDef( join );
 	VarDef *varDef = new VarDef( name, machineDef );
@@ -855,6 +934,19 @@ void ParseData::initGraphDict( )
 	createBuiltin( "null", BT_Lambda );
 	createBuiltin( "zlen", BT_Lambda );
 	createBuiltin( "empty", BT_Empty );
+
+	/* Unicode general categories, in UTF-8 and UTF-16. */
+	for ( int c = 0; c < numUnicodeCategories; c++ ) {
+		const char *catName = unicodeCategories[c].name;
+
+		char *utf8Name = new char[6 + strlen(catName)];
+		sprintf( utf8Name, "utf8_%s", catName );
+		createBuiltin( utf8Name, BT_Utf8, c );
+
+		char *utf16Name = new char[7 + strlen(catName)];
+		sprintf( utf16Name, "utf16_%s", catName );
+		createBuiltin( utf16Name, BT_Utf16, c );
+	}
 }
 
 /* Set the alphabet type. If the types are not valid returns false. */
@@ -899,6 +991,8 @@ bool ParseData::setVariable( char *var, InlineList *inlineList )
 		tokstartExpr = inlineList;
 	else if ( strcmp( var, "te" ) == 0 )
 		tokendExpr = inlineList;
+	else if ( strcmp( var, "counters" ) == 0 )
+		countersExpr = inlineList;
 	else
 		set = false;
 
@@ -958,8 +1052,10 @@ void ParseData::removeActionDups( FsmAp *graph )
 	/* Loop all states. */
 	for ( StateList::Iter state = graph->stateList; state.lte(); state++ ) {
 		/* Loop all transitions. */
-		for ( TransList::Iter trans = state->outList; trans.lte(); trans++ )
-			removeDups( trans->ctList.head->actionTable );
+		for ( TransList::Iter trans = state->outList; trans.lte(); trans++ ) {
+			for ( CondTransList::Iter cond = trans->ctList; cond.lte(); cond++ )
+				removeDups( cond->actionTable );
+		}
 		removeDups( state->toStateActionTable );
 		removeDups( state->fromStateActionTable );
 		removeDups( state->eofActionTable );
@@ -979,6 +1075,19 @@ Action *ParseData::newAction( const char *name, InlineList *inlineList )
 	return action;
 }
 
+/* Make an action that sets, increments or tests the counter of a counted
+ * repetition. */
+Action *ParseData::newRepAction( const InputLoc &loc, const char *name,
+		InlineItem::Type type, int counterId, long bound )
+{
+	InlineList *inlineList = new InlineList;
+	inlineList->append( new InlineItem( loc, counterId, bound, type ) );
+
+	Action *action = newAction( name, inlineList );
+	action->loc = loc;
+	return action;
+}
+
 void ParseData::initLongestMatchData()
 {
 	if ( lmList.length() > 0 ) {
@@ -1036,9 +1145,11 @@ void ParseData::setLongestMatchData( FsmAp *graph )
 		StateSet states;
 		for ( StateList::Iter state = graph->stateList; state.lte(); state++ ) {
 			for ( TransList::Iter trans = state->outList; trans.lte(); trans++ ) {
-				for ( ActionTable::Iter ati = trans->ctList.head->actionTable; ati.lte(); ati++ ) {
-					if ( ati->value->anyCall && trans->ctList.head->toState != 0 )
-						states.insert( trans->ctList.head->toState );
+				for ( CondTransList::Iter cond = trans->ctList; cond.lte(); cond++ ) {
+					for ( ActionTable::Iter ati = cond->actionTable; ati.lte(); ati++ ) {
+						if ( ati->value->anyCall && cond->toState != 0 )
+							states.insert( cond->toState );
+					}
 				}
 			}
 		}
@@ -1058,9 +1169,21 @@ void ParseData::setLongestMatchData( FsmAp *graph )
 /* Make the graph from a graph dict node. Does minimization and state sorting. */
 FsmAp *ParseData::makeInstance( GraphDictEl *gdNode )
 {
+	ProfileMachine profileMachine( gdNode->key, &gdNode->loc );
+	ProfilePhase phase( "instance", gdNode->loc );
+
 	/* Build the graph from a walk of the parse tree. */
 	FsmAp *graph = gdNode->value->walk( this );
 
+	finishInstance( graph );
+	phase.finish( graph );
+	return graph;
+}
+
+/* Takes a graph built from a walk of the parse tree through to the final
+ * minimization. */
+void ParseData::finishInstance( FsmAp *graph )
+{
 	/* Resolve any labels that point to multiple states. Any labels that are
 	 * still around are referenced only by gotos and calls and they need to be
 	 * made into deterministic entry points. */
@@ -1071,7 +1194,7 @@ FsmAp *ParseData::makeInstance( GraphDictEl *gdNode )
 	 */
 
 	/* Transfer actions from the out action tables to eof action tables. */
-	for ( StateSet::Iter state = graph->finStateSet; state.lte(); state++ )
+	for ( FinStateSet::Iter state = graph->finStateSet; state.lte(); state++ )
 		graph->transferOutActions( *state );
 
 	/* Transfer global error actions. */
@@ -1095,6 +1218,9 @@ FsmAp *ParseData::makeInstance( GraphDictEl *gdNode )
 	graph->clearAllPriorities();
 
 	if ( minimizeOpt != MinimizeNone ) {
+		ProfilePhase phase( "final-minimize" );
+		phase.input( graph );
+
 		/* Minimize here even if we minimized at every op. Now that function
 		 * keys have been cleared we may get a more minimal fsm. */
 		switch ( minimizeLevel ) {
@@ -1111,11 +1237,11 @@ FsmAp *ParseData::makeInstance( GraphDictEl *gdNode )
 				graph->minimizePartition2();
 				break;
 		}
+
+		phase.finish( graph );
 	}
 
 	graph->compressTransitions();
-
-	return graph;
 }
 
 void ParseData::printNameTree()
@@ -1206,6 +1332,147 @@ FsmAp *ParseData::makeAll()
 	return mainGraph;
 }
 
+/* In lazy DFA mode the main machine is not determinized as a whole. The
+ * union, intersection and subtraction operators at the top of its definition
+ * are left for the runtime and each of their operands is built as a separate
+ * machine. Returns a stand-in for the section graph. */
+FsmAp *ParseData::makeLazy()
+{
+	/* Build the name tree and supporting data structures. */
+	makeNameTree( 0 );
+
+	/* Resove name references in the tree. */
+	initNameWalk();
+	for ( GraphList::Iter glel = instanceList; glel.lte(); glel++ )
+		glel->value->resolveNameRefs( this );
+
+	/* Resolve action code name references. */
+	resolveActionNameRefs();
+
+	/* Force name references to the top level instantiations. */
+	for ( NameVect::Iter inst = rootName->childVect; inst.lte(); inst++ )
+		(*inst)->numRefs += 1;
+
+	if ( instanceList.length() > 1 ) {
+		error(sectionLoc) << "lazy DFA mode supports only a single "
+				"instantiation" << endl;
+	}
+	else {
+		VarDef *varDef = instanceList.head->value;
+		MachineDef *machineDef = varDef->machineDef;
+
+		initNameWalk();
+		if ( machineDef->type == MachineDef::JoinType &&
+				machineDef->join->exprList.length() == 1 )
+		{
+			/* Enter the scope of the instance, as VarDef::walk does. */
+			NameFrame nameFrame = enterNameScope( true, 1 );
+			lazyExpression( machineDef->join->exprList.head );
+			popNameScope( nameFrame );
+		}
+		else {
+			lazyComponent( varDef->walk( this ) );
+		}
+	}
+
+	FsmAp *graph = new FsmAp();
+	graph->lambdaFsm();
+	return graph;
+}
+
+/* Split an expression at its operators. This walks the tree in the same order
+ * as Expression::walk so the name walk stays in step. */
+void ParseData::lazyExpression( Expression *expr )
+{
+	switch ( expr->type ) {
+	case Expression::OrType:
+	case Expression::IntersectType:
+	case Expression::SubtractType:
+		lazyExpression( expr->expression );
+		lazyTerm( expr->term );
+		if ( expr->type == Expression::OrType )
+			lazyExpr.append( LazyOr );
+		else if ( expr->type == Expression::IntersectType )
+			lazyExpr.append( LazyAnd );
+		else
+			lazyExpr.append( LazySub );
+		break;
+	case Expression::TermType:
+		lazyTerm( expr->term );
+		break;
+	default:
+		lazyComponent( expr->walk( this ) );
+		break;
+	}
+}
+
+/* A term that is only a reference to another definition or a parenthesized
+ * expression is descended into. Anything else is a component. */
+void ParseData::lazyTerm( Term *term )
+{
+	Factor *factor = 0;
+	if ( term->type == Term::FactorWithAugType ) {
+		FactorWithAug *fwa = term->factorWithAug;
+		FactorWithRep *fwr = fwa->factorWithRep;
+		if ( fwa->actions.length() == 0 && fwa->priorityAugs.length() == 0 &&
+				fwa->labels.length() == 0 && fwa->epsilonLinks.length() == 0 &&
+				fwa->conditions.length() == 0 &&
+				fwr->type == FactorWithRep::FactorWithNegType &&
+				fwr->factorWithNeg->type == FactorWithNeg::FactorType )
+			factor = fwr->factorWithNeg->factor;
+	}
+
+	if ( factor != 0 && factor->type == Factor::ParenType &&
+			factor->join->exprList.length() == 1 )
+	{
+		lazyExpression( factor->join->exprList.head );
+	}
+	else if ( factor != 0 && factor->type == Factor::ReferenceType &&
+			factor->varDef->machineDef->type == MachineDef::JoinType &&
+			factor->varDef->machineDef->join->exprList.length() == 1 &&
+			localErrDict.find( factor->varDef->name ) == 0 )
+	{
+		NameFrame nameFrame = enterNameScope( true, 1 );
+		lazyExpression( factor->varDef->machineDef->join->exprList.head );
+		popNameScope( nameFrame );
+	}
+	else {
+		lazyComponent( term->walk( this ) );
+	}
+}
+
+void ParseData::lazyComponent( FsmAp *graph )
+{
+	/* Epsilon transitions are normally resolved by the enclosing
+	 * definition, which may have been split. */
+	graph->epsilonOp();
+	finishInstance( graph );
+
+	/* The runtime tracks only states. There must be nothing to execute. */
+	bool anyActions = false;
+	for ( StateList::Iter st = graph->stateList; st.lte(); st++ ) {
+		if ( st->toStateActionTable.length() > 0 || 
+				st->fromStateActionTable.length() > 0 ||
+				st->eofActionTable.length() > 0 ||
+				st->stateCondList.length() > 0 )
+			anyActions = true;
+
+		for ( TransList::Iter trans = st->outList; trans.lte(); trans++ ) {
+			if ( trans->condSpace != 0 || 
+					trans->ctList.head->actionTable.length() > 0 )
+				anyActions = true;
+		}
+	}
+
+	if ( anyActions ) {
+		error(sectionLoc) << "lazy DFA mode does not support actions "
+				"or conditions" << endl;
+	}
+
+	lazyExpr.append( lazyComps.length() );
+	lazyComps.append( graph );
+}
+
 void ParseData::analyzeAction( Action *action, InlineList *inlineList )
 {
 	/* FIXME: Actions used as conditions should be very constrained. */
@@ -1288,8 +1555,15 @@ void ParseData::analyzeGraph( FsmAp *graph )
 	for ( StateList::Iter st = graph->stateList; st.lte(); st++ ) {
 		/* The transition list. */
 		for ( TransList::Iter trans = st->outList; trans.lte(); trans++ ) {
-			for ( ActionTable::Iter at = trans->ctList.head->actionTable; at.lte(); at++ )
-				at->value->numTransRefs += 1;
+			for ( CondTransList::Iter cond = trans->ctList; cond.lte(); cond++ ) {
+				for ( ActionTable::Iter at = cond->actionTable; at.lte(); at++ )
+					at->value->numTransRefs += 1;
+			}
+
+			if ( trans->condSpace != 0 ) {
+				for ( CondSet::Iter sci = trans->condSpace->condSet; sci.lte(); sci++ )
+					(*sci)->numCondRefs += 1;
+			}
 		}
 
 		for ( ActionTable::Iter at = st->toStateActionTable; at.lte(); at++ )
@@ -1312,6 +1586,45 @@ void ParseData::analyzeGraph( FsmAp *graph )
 		checkAction( act );
 }
 
+/* A counter holds a single count. If a counted repetition can start over on
+ * a character that also continues it then the count is no longer exact. */
+void ParseData::checkRepCounters( FsmAp *graph )
+{
+	if ( numRepCounters == 0 )
+		return;
+
+	bool *reported = new bool[numRepCounters];
+	memset( reported, 0, sizeof(bool) * numRepCounters );
+
+	for ( StateList::Iter st = graph->stateList; st.lte(); st++ ) {
+		for ( TransList::Iter trans = st->outList; trans.lte(); trans++ ) {
+			for ( CondTransList::Iter cond = trans->ctList; cond.lte(); cond++ ) {
+				for ( ActionTable::Iter init = cond->actionTable; init.lte(); init++ ) {
+					InlineItem *initItem = init->value->inlineList->head;
+					if ( initItem == 0 || initItem->type != InlineItem::RepInit ||
+							reported[initItem->counterId] )
+						continue;
+
+					for ( ActionTable::Iter incr = cond->actionTable; incr.lte(); incr++ ) {
+						InlineItem *incrItem = incr->value->inlineList->head;
+						if ( incrItem != 0 && incrItem->type == InlineItem::RepIncr &&
+								incrItem->counterId == initItem->counterId )
+						{
+							error(init->value->loc) << "counted repetition can start "
+									"again while it is counting, raise the "
+									"--counted-repetition bound" << endl;
+							reported[initItem->counterId] = true;
+							break;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	delete[] reported;
+}
+
 void ParseData::makeExportsNameTree()
 {
 	/* Make a name tree for the exports. */
@@ -1386,24 +1699,37 @@ void ParseData::prepareMachineGen( GraphDictEl *graphDictEl )
 
 void ParseData::prepareMachineGenTBWrapped( GraphDictEl *graphDictEl )
 {
+	ProfileMachine profileMachine( sectionName, &sectionLoc );
+
 	beginProcessing();
 	initKeyOps();
 	makeRootNames();
 	initLongestMatchData();
 
 	/* Make the graph, do minimization. */
-	if ( graphDictEl == 0 )
+	ProfilePhase makePhase( "make" );
+	if ( graphDictEl == 0 && lazyDfaStates > 0 )
+		sectionGraph = makeLazy();
+	else if ( graphDictEl == 0 )
 		sectionGraph = makeAll();
 	else
 		sectionGraph = makeSpecific( graphDictEl );
+	makePhase.finish( sectionGraph );
 	
 	/* Compute exports from the export definitions. */
 	makeExports();
 
+	/* The machines kept for repeated definitions are no longer needed. */
+	for ( GraphDict::Iter gdel = graphDict; gdel.lte(); gdel++ )
+		gdel->value->dropBuilt();
+
+	checkRepCounters( sectionGraph );
+
 	/* If any errors have occured in the input file then don't write anything. */
 	if ( gblErrorCount > 0 )
 		return;
 
+	ProfilePhase analyzePhase( "analyze" );
 	analyzeGraph( sectionGraph );
 
 	/* Depends on the graph analysis. */
@@ -1426,12 +1752,16 @@ void ParseData::prepareMachineGenTBWrapped( GraphDictEl *graphDictEl )
 	sectionGraph->depthFirstOrdering();
 	sectionGraph->sortStatesByFinal();
 	sectionGraph->setStateNumbers( 0 );
+	analyzePhase.finish( sectionGraph );
 }
 
 CodeGenData *makeCodeGen2( const CodeGenArgs &args );
 
 void ParseData::generateReduced( InputData &inputData )
 {
+	ProfileMachine profileMachine( sectionName, &sectionLoc );
+	ProfilePhase phase( "reduce" );
+
 	beginProcessing();
 
 	CodeGenArgs args( inputData, inputData.inputFileName, sectionName, this, sectionGraph, *inputData.outStream );
@@ -1440,8 +1770,19 @@ void ParseData::generateReduced( InputData &inputData )
 	cgd = makeCodeGen2( args );
 
 	cgd->make();
+	phase.finish();
 
-	if ( printStatistics ) {
+	if ( printStatistics && lazyComps.length() > 0 ) {
+		long numStates = 0;
+		for ( int c = 0; c < lazyComps.length(); c++ )
+			numStates += lazyComps[c]->stateList.length();
+
+		cerr << "fsm name  : " << sectionName << endl;
+		cerr << "components: " << lazyComps.length() << endl;
+		cerr << "num states: " << numStates << endl;
+		cerr << endl;
+	}
+	else if ( printStatistics ) {
 		cerr << "fsm name  : " << sectionName << endl;
 		cerr << "num states: " << sectionGraph->stateList.length() << endl;
 		cerr << endl;
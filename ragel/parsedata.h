@@ -69,6 +69,7 @@ struct GraphDictEl
 		: key(k), value(0), isInstance(false) { }
 	GraphDictEl( const char *k, VarDef *value ) 
 		: key(k), value(value), isInstance(false) { }
+	~GraphDictEl();
 
 	const char *getKey() { return key; }
 
@@ -103,6 +104,7 @@ struct NameInst
 	NameInst( const InputLoc &loc, NameInst *parent, const char *name, int id, bool isLabel ) : 
 		loc(loc), parent(parent), name(name), id(id), isLabel(isLabel),
 		isLongestMatch(false), numRefs(0), numUses(0), start(0), final(0) {}
+	~NameInst();
 
 	InputLoc loc;
 
@@ -162,6 +164,14 @@ struct LengthDef
 
 typedef DList<LengthDef> LengthDefList;
 
+/* Operators in the lazy DFA component expression. */
+enum LazyOp
+{
+	LazyOr = -1,
+	LazyAnd = -2,
+	LazySub = -3
+};
+
 /* Class to collect information about the machine during the 
  * parse of input. */
 struct ParseData
@@ -177,7 +187,7 @@ struct ParseData
 
 	/* Initialize a graph dict with the basic fsms. */
 	void initGraphDict();
-	void createBuiltin( const char *name, BuiltinMachine builtin );
+	void createBuiltin( const char *name, BuiltinMachine builtin, int category = 0 );
 
 	/* Make a name id in the current name instantiation scope if it is not
 	 * already there. */
@@ -216,9 +226,16 @@ struct ParseData
 
 	/* Make the graph from a graph dict node. Does minimization. */
 	FsmAp *makeInstance( GraphDictEl *gdNode );
+	void finishInstance( FsmAp *graph );
 	FsmAp *makeSpecific( GraphDictEl *gdNode );
 	FsmAp *makeAll();
 
+	/* Split the main machine into components for the lazy DFA runtime. */
+	FsmAp *makeLazy();
+	void lazyExpression( Expression *expr );
+	void lazyTerm( Term *term );
+	void lazyComponent( FsmAp *graph );
+
 	/* Checking the contents of actions. */
 	void checkAction( Action *action );
 	void checkInlineList( Action *act, InlineList *inlineList );
@@ -234,6 +251,11 @@ struct ParseData
 	FsmAp *sectionGraph;
 	bool generatingSectionSubset;
 
+	/* Components of the main machine in lazy DFA mode and the expression
+	 * combining them, in postfix. Operands are component indicies. */
+	Vector<FsmAp*> lazyComps;
+	Vector<int> lazyExpr;
+
 	void initKeyOps();
 
 	/*
@@ -291,6 +313,7 @@ struct ParseData
 	InlineList *tokstartExpr;
 	InlineList *tokendExpr;
 	InlineList *dataExpr;
+	InlineList *countersExpr;
 
 	/* The alphabet range. */
 	char *lowerNum, *upperNum;
@@ -345,6 +368,12 @@ struct ParseData
 	LmList lmList;
 
 	Action *newAction( const char *name, InlineList *inlineList );
+	Action *newRepAction( const InputLoc &loc, const char *name,
+			InlineItem::Type type, int counterId, long bound );
+
+	/* Counter for assigning ids to counted repetitions. */
+	int numRepCounters;
+	void checkRepCounters( FsmAp *graph );
 
 	Action *initTokStart;
 	int initTokStartOrd;
@@ -373,6 +402,7 @@ struct ParseData
 	CodeGenData *cgd;
 };
 
+void beforeOpMinimize( FsmAp *fsm );
 void afterOpMinimize( FsmAp *fsm, bool lastInSeq = true );
 Key makeFsmKeyHex( char *str, const InputLoc &loc, ParseData *pd );
 Key makeFsmKeyDec( char *str, const InputLoc &loc, ParseData *pd );
@@ -381,7 +411,7 @@ Key makeFsmKeyChar( char c, ParseData *pd );
 void makeFsmKeyArray( Key *result, char *data, int len, ParseData *pd );
 void makeFsmUniqueKeyArray( KeySet &result, char *data, int len, 
 		bool caseInsensitive, ParseData *pd );
-FsmAp *makeBuiltin( BuiltinMachine builtin, ParseData *pd );
+FsmAp *makeBuiltin( BuiltinMachine builtin, ParseData *pd, int category = 0 );
 FsmAp *dotFsm( ParseData *pd );
 FsmAp *dotStarFsm( ParseData *pd );
 
@@ -29,6 +29,7 @@
 #include "ragel.h"
 #include "rlparse.h"
 #include "parsetree.h"
+#include "profile.h"
 
 using namespace std;
 ostream &operator<<( ostream &out, const NameRef &nameRef );
@@ -87,9 +88,35 @@ char *prepareLitString( const InputLoc &loc, const char *data, long length,
 
 FsmAp *VarDef::walk( ParseData *pd )
 {
+	/* Attribute the operators below to this definition. */
+	GraphDictEl *gdEl = pd->graphDict.find( name );
+	ProfileMachine profileMachine( name, gdEl != 0 ? &gdEl->loc : 0 );
+
 	/* We enter into a new name scope. */
 	NameFrame nameFrame = pd->enterNameScope( true, 1 );
 
+	/* If the machine has been built already and nothing in this instance is
+	 * referenced then copy it. */
+	if ( built != 0 && !pd->curNameInst->anyRefsRec() ) {
+		ProfilePhase phase( "copy" );
+		FsmAp *rtnVal = new FsmAp( *built );
+		rtnVal->shiftActionOrdering( builtActionOrd, 
+				builtActionOrd + numActionOrds, pd->curActionOrd - builtActionOrd );
+		rtnVal->shiftPriorOrdering( builtPriorOrd, 
+				builtPriorOrd + numPriorOrds, pd->curPriorOrd - builtPriorOrd );
+		pd->curActionOrd += numActionOrds;
+		pd->curPriorOrd += numPriorOrds;
+		phase.finish( rtnVal );
+
+		pd->popNameScope( nameFrame );
+		return rtnVal;
+	}
+
+	int startActionOrd = pd->curActionOrd;
+	int startPriorOrd = pd->curPriorOrd;
+	int startEpsilonLink = pd->nextEpsilonResolvedLink;
+	int startRepCounter = pd->numRepCounters;
+
 	/* Recurse on the expression. */
 	FsmAp *rtnVal = machineDef->walk( pd );
 	
@@ -114,16 +141,43 @@ FsmAp *VarDef::walk( ParseData *pd )
 	if ( pd->curNameInst->numRefs > 0 )
 		rtnVal->setEntry( pd->curNameInst->id, rtnVal->startState );
 
+	/* Keep the machine for the other instances of the definition. It must not
+	 * carry entry points or epsilon links, since those name the instances, or
+	 * repetition counters, which each instance needs its own of. */
+	if ( built == 0 && numNameInsts > 1 && rtnVal->entryPoints.length() == 0 &&
+			pd->nextEpsilonResolvedLink == startEpsilonLink &&
+			pd->numRepCounters == startRepCounter )
+	{
+		built = new FsmAp( *rtnVal );
+		builtActionOrd = startActionOrd;
+		numActionOrds = pd->curActionOrd - startActionOrd;
+		builtPriorOrd = startPriorOrd;
+		numPriorOrds = pd->curPriorOrd - startPriorOrd;
+	}
+
 	/* Pop the name scope. */
 	pd->popNameScope( nameFrame );
 	return rtnVal;
 }
 
+VarDef::~VarDef()
+{
+	delete machineDef;
+	delete built;
+}
+
+void VarDef::dropBuilt()
+{
+	delete built;
+	built = 0;
+}
+
 void VarDef::makeNameTree( const InputLoc &loc, ParseData *pd )
 {
 	/* The variable definition enters a new scope. */
 	NameInst *prevNameInst = pd->curNameInst;
 	pd->curNameInst = pd->addNameInst( loc, name, false );
+	numNameInsts += 1;
 
 	if ( machineDef->type == MachineDef::LongestMatchType )
 		pd->curNameInst->isLongestMatch = true;
@@ -147,11 +201,22 @@ void VarDef::resolveNameRefs( ParseData *pd )
 	pd->popNameScope( nameFrame );
 }
 
+LongestMatchPart::~LongestMatchPart()
+{
+	delete join;
+}
+
 InputLoc LongestMatchPart::getLoc()
 { 
 	return action != 0 ? action->loc : semiLoc;
 }
 
+/* The actions made for the parts belong to the action list. */
+LongestMatch::~LongestMatch()
+{
+	delete longestMatchList;
+}
+
 /*
  * If there are any LMs then all of the following entry points must reset
  * tokstart:
@@ -527,6 +592,21 @@ FsmAp *LongestMatch::walk( ParseData *pd )
 	return rtnVal;
 }
 
+/* A length definition belongs to the list of them in the parse data. */
+MachineDef::~MachineDef()
+{
+	switch ( type ) {
+		case JoinType:
+			delete join;
+			break;
+		case LongestMatchType:
+			delete longestMatch;
+			break;
+		case LengthDefType:
+			break;
+	}
+}
+
 FsmAp *MachineDef::walk( ParseData *pd )
 {
 	FsmAp *rtnVal = 0;
@@ -734,13 +814,25 @@ FsmAp *Expression::walk( ParseData *pd, bool lastInSeq )
 	FsmAp *rtnVal = 0;
 	switch ( type ) {
 		case OrType: {
+			/* Unions of plain literals are built directly. */
+			if ( !literalUnionChecked )
+				checkLiteralUnion();
+			if ( literalUnion ) {
+				rtnVal = walkLiteralUnion( pd, lastInSeq );
+				break;
+			}
+
 			/* Evaluate the expression. */
 			rtnVal = expression->walk( pd, false );
 			/* Evaluate the term. */
 			FsmAp *rhs = term->walk( pd );
 			/* Perform union. */
+			ProfilePhase phase( "union" );
+			phase.input( rtnVal );
+			phase.input( rhs );
 			rtnVal->unionOp( rhs );
 			afterOpMinimize( rtnVal, lastInSeq );
+			phase.finish( rtnVal );
 			break;
 		}
 		case IntersectType: {
@@ -749,8 +841,14 @@ FsmAp *Expression::walk( ParseData *pd, bool lastInSeq )
 			/* Evaluate the term. */
 			FsmAp *rhs = term->walk( pd );
 			/* Perform intersection. */
+			ProfilePhase phase( "intersect" );
+			phase.input( rtnVal );
+			phase.input( rhs );
+			beforeOpMinimize( rtnVal );
+			beforeOpMinimize( rhs );
 			rtnVal->intersectOp( rhs );
 			afterOpMinimize( rtnVal, lastInSeq );
+			phase.finish( rtnVal );
 			break;
 		}
 		case SubtractType: {
@@ -759,8 +857,14 @@ FsmAp *Expression::walk( ParseData *pd, bool lastInSeq )
 			/* Evaluate the term. */
 			FsmAp *rhs = term->walk( pd );
 			/* Perform subtraction. */
+			ProfilePhase phase( "subtract" );
+			phase.input( rtnVal );
+			phase.input( rhs );
+			beforeOpMinimize( rtnVal );
+			beforeOpMinimize( rhs );
 			rtnVal->subtractOp( rhs );
 			afterOpMinimize( rtnVal, lastInSeq );
+			phase.finish( rtnVal );
 			break;
 		}
 		case StrongSubtractType: {
@@ -771,12 +875,18 @@ FsmAp *Expression::walk( ParseData *pd, bool lastInSeq )
 			FsmAp *rhs = dotStarFsm( pd );
 			FsmAp *termFsm = term->walk( pd );
 			FsmAp *trailAnyStar = dotStarFsm( pd );
+			ProfilePhase phase( "strong-subtract" );
+			phase.input( rtnVal );
+			phase.input( termFsm );
 			rhs->concatOp( termFsm );
 			rhs->concatOp( trailAnyStar );
 
 			/* Perform subtraction. */
+			beforeOpMinimize( rtnVal );
+			beforeOpMinimize( rhs );
 			rtnVal->subtractOp( rhs );
 			afterOpMinimize( rtnVal, lastInSeq );
+			phase.finish( rtnVal );
 			break;
 		}
 		case TermType: {
@@ -786,7 +896,7 @@ FsmAp *Expression::walk( ParseData *pd, bool lastInSeq )
 		}
 		case BuiltinType: {
 			/* Duplicate the builtin. */
-			rtnVal = makeBuiltin( builtin, pd );
+			rtnVal = makeBuiltin( builtin, pd, category );
 			break;
 		}
 	}
@@ -794,6 +904,91 @@ FsmAp *Expression::walk( ParseData *pd, bool lastInSeq )
 	return rtnVal;
 }
 
+/* Decide which unions in the chain below this node consist only of plain
+ * literals. Each node is checked once, so long chains stay linear. */
+void Expression::checkLiteralUnion()
+{
+	Vector<Expression*> chain;
+	Expression *expr = this;
+	while ( expr->type == OrType && !expr->literalUnionChecked ) {
+		chain.append( expr );
+		expr = expr->expression;
+	}
+
+	bool below;
+	if ( expr->type == OrType )
+		below = expr->literalUnion;
+	else
+		below = expr->type == TermType && expr->term->plainLiteral() != 0;
+
+	for ( long i = chain.length() - 1; i >= 0; i-- ) {
+		below = below && chain[i]->term->plainLiteral() != 0;
+		chain[i]->literalUnion = below;
+		chain[i]->literalUnionChecked = true;
+	}
+}
+
+/* Build a union of plain literals with one minimal construction per case
+ * mode instead of a union and minimization per literal. */
+FsmAp *Expression::walkLiteralUnion( ParseData *pd, bool lastInSeq )
+{
+	/* Collect the literals, last one first. */
+	Vector<Literal*> literals;
+	Expression *expr = this;
+	while ( expr->type == OrType ) {
+		literals.append( expr->term->plainLiteral() );
+		expr = expr->expression;
+	}
+	literals.append( expr->term->plainLiteral() );
+
+	ProfilePhase phase( "literal-union" );
+
+	Vector<Key*> strs[2];
+	Vector<long> lens[2];
+	for ( long i = literals.length() - 1; i >= 0; i-- ) {
+		/* Same name scope traversal as walking the factor. */
+		NameFrame nameFrame = pd->enterNameScope( false, 0 );
+
+		long length;
+		bool caseInsensitive;
+		Key *arr = literals[i]->makeKeys( pd, length, caseInsensitive );
+		if ( caseInsensitive ) {
+			for ( long k = 0; k < length; k++ ) {
+				if ( arr[k].isUpper() )
+					arr[k] = arr[k].toLower();
+			}
+		}
+		strs[caseInsensitive].append( arr );
+		lens[caseInsensitive].append( length );
+
+		pd->popNameScope( nameFrame );
+	}
+
+	FsmAp *rtnVal = 0;
+	for ( int ci = 0; ci < 2; ci++ ) {
+		if ( strs[ci].length() == 0 )
+			continue;
+
+		FsmAp *fsm = new FsmAp();
+		fsm->unionLiteralsFsm( strs[ci].data, lens[ci].data,
+				strs[ci].length(), ci );
+
+		if ( rtnVal == 0 )
+			rtnVal = fsm;
+		else {
+			/* Mixed case modes. */
+			rtnVal->unionOp( fsm );
+			afterOpMinimize( rtnVal, lastInSeq );
+		}
+
+		for ( long i = 0; i < strs[ci].length(); i++ )
+			delete[] strs[ci][i];
+	}
+
+	phase.finish( rtnVal );
+	return rtnVal;
+}
+
 void Expression::makeNameTree( ParseData *pd )
 {
 	switch ( type ) {
@@ -857,9 +1052,14 @@ FsmAp *Term::walk( ParseData *pd, bool lastInSeq )
 			rtnVal = term->walk( pd, false );
 			/* Evaluate the FactorWithRep. */
 			FsmAp *rhs = factorWithAug->walk( pd );
+			ProfilePhase phase( "concat" );
+			phase.input( rtnVal );
+			phase.input( rhs );
 			/* Perform concatenation. */
+			beforeOpMinimize( rhs );
 			rtnVal->concatOp( rhs );
 			afterOpMinimize( rtnVal, lastInSeq );
+			phase.finish( rtnVal );
 			break;
 		}
 		case RightStartType: {
@@ -868,6 +1068,9 @@ FsmAp *Term::walk( ParseData *pd, bool lastInSeq )
 
 			/* Evaluate the FactorWithRep. */
 			FsmAp *rhs = factorWithAug->walk( pd );
+			ProfilePhase phase( "right-start" );
+			phase.input( rtnVal );
+			phase.input( rhs );
 
 			/* Set up the priority descriptors. The left machine gets the
 			 * lower priority where as the right get the higher start priority. */
@@ -882,8 +1085,10 @@ FsmAp *Term::walk( ParseData *pd, bool lastInSeq )
 			rhs->startFsmPrior( pd->curPriorOrd++, &priorDescs[1] );
 
 			/* Perform concatenation. */
+			beforeOpMinimize( rhs );
 			rtnVal->concatOp( rhs );
 			afterOpMinimize( rtnVal, lastInSeq );
+			phase.finish( rtnVal );
 			break;
 		}
 		case RightFinishType: {
@@ -892,6 +1097,9 @@ FsmAp *Term::walk( ParseData *pd, bool lastInSeq )
 
 			/* Evaluate the FactorWithRep. */
 			FsmAp *rhs = factorWithAug->walk( pd );
+			ProfilePhase phase( "right-finish" );
+			phase.input( rtnVal );
+			phase.input( rhs );
 
 			/* Set up the priority descriptors. The left machine gets the
 			 * lower priority where as the finishing transitions to the right
@@ -915,8 +1123,10 @@ FsmAp *Term::walk( ParseData *pd, bool lastInSeq )
 			}
 
 			/* Perform concatenation. */
+			beforeOpMinimize( rhs );
 			rtnVal->concatOp( rhs );
 			afterOpMinimize( rtnVal, lastInSeq );
+			phase.finish( rtnVal );
 			break;
 		}
 		case LeftType: {
@@ -925,6 +1135,9 @@ FsmAp *Term::walk( ParseData *pd, bool lastInSeq )
 
 			/* Evaluate the FactorWithRep. */
 			FsmAp *rhs = factorWithAug->walk( pd );
+			ProfilePhase phase( "left-guard" );
+			phase.input( rtnVal );
+			phase.input( rhs );
 
 			/* Set up the priority descriptors. The left machine gets the
 			 * higher priority. */
@@ -942,8 +1155,10 @@ FsmAp *Term::walk( ParseData *pd, bool lastInSeq )
 			rhs->startFsmPrior( pd->curPriorOrd++, &priorDescs[1] );
 
 			/* Perform concatenation. */
+			beforeOpMinimize( rhs );
 			rtnVal->concatOp( rhs );
 			afterOpMinimize( rtnVal, lastInSeq );
+			phase.finish( rtnVal );
 			break;
 		}
 		case FactorWithAugType: {
@@ -954,6 +1169,31 @@ FsmAp *Term::walk( ParseData *pd, bool lastInSeq )
 	return rtnVal;
 }
 
+Literal *Term::plainLiteral()
+{
+	if ( type != FactorWithAugType )
+		return 0;
+
+	FactorWithAug *fwa = factorWithAug;
+	if ( fwa->actions.length() > 0 || fwa->priorityAugs.length() > 0 ||
+			fwa->labels.length() > 0 || fwa->epsilonLinks.length() > 0 ||
+			fwa->conditions.length() > 0 )
+		return 0;
+
+	FactorWithRep *fwr = fwa->factorWithRep;
+	if ( fwr->type != FactorWithRep::FactorWithNegType )
+		return 0;
+
+	FactorWithNeg *fwn = fwr->factorWithNeg;
+	if ( fwn->type != FactorWithNeg::FactorType )
+		return 0;
+
+	if ( fwn->factor->type != Factor::LiteralType )
+		return 0;
+
+	return fwn->factor->literal;
+}
+
 void Term::makeNameTree( ParseData *pd )
 {
 	switch ( type ) {
@@ -1167,6 +1407,13 @@ void FactorWithAug::assignPriorities( FsmAp *graph, int *priorOrd )
 
 void FactorWithAug::assignConditions( FsmAp *graph )
 {
+	if ( conditions.length() == 0 )
+		return;
+
+	/* Embedding conditions expands the transitions into condition spaces. */
+	ProfilePhase phase( "conditions" );
+	phase.input( graph );
+
 	for ( int i = 0; i < conditions.length(); i++ )  {
 		switch ( conditions[i].type ) {
 		/* Transition actions. */
@@ -1184,6 +1431,8 @@ void FactorWithAug::assignConditions( FsmAp *graph )
 			break;
 		}
 	}
+
+	phase.finish( graph );
 }
 
 
@@ -1395,6 +1644,8 @@ FsmAp *FactorWithRep::walk( ParseData *pd )
 	case StarType: {
 		/* Evaluate the FactorWithRep. */
 		retFsm = factorWithRep->walk( pd );
+		ProfilePhase phase( "star", loc );
+		phase.input( retFsm );
 		if ( retFsm->startState->isFinState() ) {
 			warning(loc) << "applying kleene star to a machine that "
 					"accepts zero length word" << endl;
@@ -1403,13 +1654,17 @@ FsmAp *FactorWithRep::walk( ParseData *pd )
 
 		/* Shift over the start action orders then do the kleene star. */
 		pd->curActionOrd += retFsm->shiftStartActionOrder( pd->curActionOrd );
+		beforeOpMinimize( retFsm );
 		retFsm->starOp( );
 		afterOpMinimize( retFsm );
+		phase.finish( retFsm );
 		break;
 	}
 	case StarStarType: {
 		/* Evaluate the FactorWithRep. */
 		retFsm = factorWithRep->walk( pd );
+		ProfilePhase phase( "star-star", loc );
+		phase.input( retFsm );
 		if ( retFsm->startState->isFinState() ) {
 			warning(loc) << "applying kleene star to a machine that "
 					"accepts zero length word" << endl;
@@ -1429,8 +1684,10 @@ FsmAp *FactorWithRep::walk( ParseData *pd )
 
 		/* Shift over the start action orders then do the kleene star. */
 		pd->curActionOrd += retFsm->shiftStartActionOrder( pd->curActionOrd );
+		beforeOpMinimize( retFsm );
 		retFsm->starOp( );
 		afterOpMinimize( retFsm );
+		phase.finish( retFsm );
 		break;
 	}
 	case OptionalType: {
@@ -1440,21 +1697,27 @@ FsmAp *FactorWithRep::walk( ParseData *pd )
 
 		/* Evaluate the FactorWithRep. */
 		retFsm = factorWithRep->walk( pd );
+		ProfilePhase phase( "optional", loc );
+		phase.input( retFsm );
 
 		/* Perform the question operator. */
 		retFsm->unionOp( nu );
 		afterOpMinimize( retFsm );
+		phase.finish( retFsm );
 		break;
 	}
 	case PlusType: {
 		/* Evaluate the FactorWithRep. */
 		retFsm = factorWithRep->walk( pd );
+		ProfilePhase phase( "plus", loc );
+		phase.input( retFsm );
 		if ( retFsm->startState->isFinState() ) {
 			warning(loc) << "applying plus operator to a machine that "
 					"accepts zero length word" << endl;
 		}
 
 		/* Need a duplicated for the star end. */
+		beforeOpMinimize( retFsm );
 		FsmAp *dup = new FsmAp( *retFsm );
 
 		/* The start func orders need to be shifted before doing the star. */
@@ -1466,6 +1729,7 @@ FsmAp *FactorWithRep::walk( ParseData *pd )
 
 		retFsm->concatOp( dup );
 		afterOpMinimize( retFsm );
+		phase.finish( retFsm );
 		break;
 	}
 	case ExactType: {
@@ -1482,6 +1746,8 @@ FsmAp *FactorWithRep::walk( ParseData *pd )
 		else {
 			/* Evaluate the first FactorWithRep. */
 			retFsm = factorWithRep->walk( pd );
+			ProfilePhase phase( "exact-repeat", loc );
+			phase.input( retFsm );
 			if ( retFsm->startState->isFinState() ) {
 				warning(loc) << "applying repetition to a machine that "
 						"accepts zero length word" << endl;
@@ -1490,10 +1756,16 @@ FsmAp *FactorWithRep::walk( ParseData *pd )
 			/* The start func orders need to be shifted before doing the
 			 * repetition. */
 			pd->curActionOrd += retFsm->shiftStartActionOrder( pd->curActionOrd );
+			beforeOpMinimize( retFsm );
 
 			/* Do the repetition on the machine. Already guarded against n == 0 */
-			retFsm->repeatOp( lowerRep );
-			afterOpMinimize( retFsm );
+			if ( useCounter( retFsm, lowerRep ) )
+				retFsm = countedRepeat( pd, retFsm, lowerRep, lowerRep );
+			else {
+				retFsm->repeatOp( lowerRep );
+				afterOpMinimize( retFsm );
+			}
+			phase.finish( retFsm );
 		}
 		break;
 	}
@@ -1511,6 +1783,8 @@ FsmAp *FactorWithRep::walk( ParseData *pd )
 		else {
 			/* Evaluate the first FactorWithRep. */
 			retFsm = factorWithRep->walk( pd );
+			ProfilePhase phase( "max-repeat", loc );
+			phase.input( retFsm );
 			if ( retFsm->startState->isFinState() ) {
 				warning(loc) << "applying max repetition to a machine that "
 						"accepts zero length word" << endl;
@@ -1519,16 +1793,24 @@ FsmAp *FactorWithRep::walk( ParseData *pd )
 			/* The start func orders need to be shifted before doing the 
 			 * repetition. */
 			pd->curActionOrd += retFsm->shiftStartActionOrder( pd->curActionOrd );
+			beforeOpMinimize( retFsm );
 
 			/* Do the repetition on the machine. Already guarded against n == 0 */
-			retFsm->optionalRepeatOp( upperRep );
-			afterOpMinimize( retFsm );
+			if ( useCounter( retFsm, upperRep ) )
+				retFsm = countedRepeat( pd, retFsm, 0, upperRep );
+			else {
+				retFsm->optionalRepeatOp( upperRep );
+				afterOpMinimize( retFsm );
+			}
+			phase.finish( retFsm );
 		}
 		break;
 	}
 	case MinType: {
 		/* Evaluate the repeated machine. */
 		retFsm = factorWithRep->walk( pd );
+		ProfilePhase phase( "min-repeat", loc );
+		phase.input( retFsm );
 		if ( retFsm->startState->isFinState() ) {
 			warning(loc) << "applying min repetition to a machine that "
 					"accepts zero length word" << endl;
@@ -1537,12 +1819,17 @@ FsmAp *FactorWithRep::walk( ParseData *pd )
 		/* The start func orders need to be shifted before doing the repetition
 		 * and the kleene star. */
 		pd->curActionOrd += retFsm->shiftStartActionOrder( pd->curActionOrd );
+		beforeOpMinimize( retFsm );
 	
 		if ( lowerRep == 0 ) {
 			/* Acts just like a star op on the machine to return. */
 			retFsm->starOp( );
 			afterOpMinimize( retFsm );
 		}
+		else if ( useCounter( retFsm, lowerRep ) ) {
+			/* Count up to the minimum, then loop freely. */
+			retFsm = countedRepeat( pd, retFsm, lowerRep, -1 );
+		}
 		else {
 			/* Take a duplicate for the plus. */
 			FsmAp *dup = new FsmAp( *retFsm );
@@ -1559,6 +1846,7 @@ FsmAp *FactorWithRep::walk( ParseData *pd )
 			retFsm->concatOp( dup );
 			afterOpMinimize( retFsm );
 		}
+		phase.finish( retFsm );
 		break;
 	}
 	case RangeType: {
@@ -1582,6 +1870,8 @@ FsmAp *FactorWithRep::walk( ParseData *pd )
 		else {
 			/* Now need to evaluate the repeated machine. */
 			retFsm = factorWithRep->walk( pd );
+			ProfilePhase phase( "range-repeat", loc );
+			phase.input( retFsm );
 			if ( retFsm->startState->isFinState() ) {
 				warning(loc) << "applying range repetition to a machine that "
 						"accepts zero length word" << endl;
@@ -1590,8 +1880,13 @@ FsmAp *FactorWithRep::walk( ParseData *pd )
 			/* The start func orders need to be shifted before doing both kinds
 			 * of repetition. */
 			pd->curActionOrd += retFsm->shiftStartActionOrder( pd->curActionOrd );
+			beforeOpMinimize( retFsm );
 
-			if ( lowerRep == 0 ) {
+			if ( useCounter( retFsm, upperRep ) ) {
+				/* A single loop covers both kinds of repetition. */
+				retFsm = countedRepeat( pd, retFsm, lowerRep, upperRep );
+			}
+			else if ( lowerRep == 0 ) {
 				/* Just doing max repetition. Already guarded against n == 0. */
 				retFsm->optionalRepeatOp( upperRep );
 				afterOpMinimize( retFsm );
@@ -1618,6 +1913,7 @@ FsmAp *FactorWithRep::walk( ParseData *pd )
 				retFsm->concatOp( dup );
 				afterOpMinimize( retFsm );
 			}
+			phase.finish( retFsm );
 		}
 		break;
 	}
@@ -1629,6 +1925,94 @@ FsmAp *FactorWithRep::walk( ParseData *pd )
 	return retFsm;
 }
 
+/* Decide if a repetition is built with a runtime counter instead of copies
+ * of the machine. Requires --counted-repetition and a machine that accepts
+ * only single characters. */
+bool FactorWithRep::useCounter( FsmAp *fsm, int bound )
+{
+	return countedRepetition > 0 && bound >= countedRepetition &&
+			fsm->checkSingleCharClass();
+}
+
+/* Repeat a single character machine between lower and upper times, keeping
+ * the number of characters seen in a runtime counter. An upper bound of -1
+ * means there is none. The result has the same few states for any bounds:
+ *
+ *   first . (x when c < lower-1)* . (x when !(c < lower-1)) . (x when c < upper)*
+ *
+ * The count is exact as long as the repetition is not re-entered while it is
+ * still running. */
+FsmAp *FactorWithRep::countedRepeat( ParseData *pd, FsmAp *fsm, int lower, int upper )
+{
+	int counterId = pd->numRepCounters++;
+
+	/* Take the copies before the machine gets the first action. */
+	FsmAp *mid = lower > 2 ? new FsmAp( *fsm ) : 0;
+	FsmAp *last = lower > 1 ? new FsmAp( *fsm ) : 0;
+	FsmAp *tail = upper != lower ? new FsmAp( *fsm ) : 0;
+
+	/* The first character starts the count. */
+	Action *init = pd->newRepAction( loc, "rep_init", 
+			InlineItem::RepInit, counterId, 0 );
+	fsm->allTransAction( pd->curActionOrd++, init );
+
+	/* Every counted character after the first increments it. */
+	int incrOrd = pd->curActionOrd++;
+	Action *incr = 0;
+	if ( last != 0 || ( tail != 0 && upper >= 0 ) ) {
+		incr = pd->newRepAction( loc, "rep_incr", 
+				InlineItem::RepIncr, counterId, 0 );
+	}
+
+	if ( last != 0 ) {
+		if ( mid != 0 ) {
+			/* Loop until the next character is the last required one. With
+			 * a lower bound of two the loop would never be taken. */
+			Action *test = pd->newRepAction( loc, "rep_test", 
+					InlineItem::RepTest, counterId, lower - 1 );
+			mid->allTransCondition( test, true );
+			mid->allTransAction( incrOrd, incr );
+			mid->starOp( );
+			afterOpMinimize( mid );
+
+			fsm->concatOp( mid );
+			afterOpMinimize( fsm );
+
+			last->allTransCondition( test, false );
+		}
+
+		last->allTransAction( incrOrd, incr );
+		fsm->concatOp( last );
+		afterOpMinimize( fsm );
+	}
+
+	if ( tail != 0 ) {
+		if ( upper >= 0 ) {
+			/* Optional characters loop until the upper bound. */
+			Action *test = pd->newRepAction( loc, "rep_test", 
+					InlineItem::RepTest, counterId, upper );
+			tail->allTransCondition( test, true );
+			tail->allTransAction( incrOrd, incr );
+		}
+
+		tail->starOp( );
+		afterOpMinimize( tail );
+
+		fsm->concatOp( tail );
+		afterOpMinimize( fsm );
+	}
+
+	if ( lower == 0 ) {
+		/* Zero characters are allowed too. */
+		FsmAp *nu = new FsmAp();
+		nu->lambdaFsm( );
+		fsm->unionOp( nu );
+		afterOpMinimize( fsm );
+	}
+
+	return fsm;
+}
+
 void FactorWithRep::makeNameTree( ParseData *pd )
 {
 	switch ( type ) {
@@ -1692,6 +2076,7 @@ FsmAp *FactorWithNeg::walk( ParseData *pd )
 		FsmAp *toNegate = factorWithNeg->walk( pd );
 
 		/* Negation is subtract from dot-star. */
+		beforeOpMinimize( toNegate );
 		retFsm = dotStarFsm( pd );
 		retFsm->subtractOp( toNegate );
 		afterOpMinimize( retFsm );
@@ -1883,39 +2268,44 @@ FsmAp *Range::walk( ParseData *pd )
 }
 
 /* Evaluate a literal object. */
-FsmAp *Literal::walk( ParseData *pd )
+/* Make the keys of a literal. The caller deletes the array. */
+Key *Literal::makeKeys( ParseData *pd, long &length, bool &caseInsensitive )
 {
-	/* FsmAp to return, is the alphabet signed. */
-	FsmAp *rtnVal = 0;
-
+	Key *arr = 0;
 	switch ( type ) {
 	case Number: {
 		/* Make the fsm key in int format. */
-		Key fsmKey = makeFsmKeyNum( token.data, token.loc, pd );
-		/* Make the new machine. */
-		rtnVal = new FsmAp();
-		rtnVal->concatFsm( fsmKey );
+		arr = new Key[1];
+		arr[0] = makeFsmKeyNum( token.data, token.loc, pd );
+		length = 1;
+		caseInsensitive = false;
 		break;
 	}
 	case LitString: {
 		/* Make the array of keys in int format. */
-		long length;
-		bool caseInsensitive;
 		char *data = prepareLitString( token.loc, token.data, token.length, 
 				length, caseInsensitive );
-		Key *arr = new Key[length];
+		arr = new Key[length];
 		makeFsmKeyArray( arr, data, length, pd );
-
-		/* Make the new machine. */
-		rtnVal = new FsmAp();
-		if ( caseInsensitive )
-			rtnVal->concatFsmCI( arr, length );
-		else
-			rtnVal->concatFsm( arr, length );
 		delete[] data;
-		delete[] arr;
 		break;
 	}}
+	return arr;
+}
+
+FsmAp *Literal::walk( ParseData *pd )
+{
+	long length;
+	bool caseInsensitive;
+	Key *arr = makeKeys( pd, length, caseInsensitive );
+
+	/* Make the new machine. */
+	FsmAp *rtnVal = new FsmAp();
+	if ( caseInsensitive )
+		rtnVal->concatFsmCI( arr, length );
+	else
+		rtnVal->concatFsm( arr, length );
+	delete[] arr;
 	return rtnVal;
 }
 
@@ -47,6 +47,8 @@ enum BuiltinMachine
 	BT_Punct,
 	BT_Space,
 	BT_Xdigit,
+	BT_Utf8,
+	BT_Utf16,
 	BT_Lambda,
 	BT_Empty
 };
@@ -223,16 +225,32 @@ struct PriorityAug
 struct VarDef
 {
 	VarDef( const char *name, MachineDef *machineDef )
-		: name(name), machineDef(machineDef), isExport(false) { }
+		: name(name), machineDef(machineDef), isExport(false),
+		numNameInsts(0), built(0), builtActionOrd(0), numActionOrds(0),
+		builtPriorOrd(0), numPriorOrds(0) { }
+	~VarDef();
 	
 	/* Parse tree traversal. */
 	FsmAp *walk( ParseData *pd );
 	void makeNameTree( const InputLoc &loc, ParseData *pd );
 	void resolveNameRefs( ParseData *pd );
+	void dropBuilt();
 
 	const char *name;
 	MachineDef *machineDef;
 	bool isExport;
+
+	/* Number of times the definition is instantiated in the name tree, which
+	 * is the number of times it is walked. */
+	int numNameInsts;
+
+	/* The machine from the first walk, kept when the definition is walked
+	 * again and the machine does not depend on the name instance it was built
+	 * in. Later walks copy it and move the orderings it took up to the
+	 * current ones. */
+	FsmAp *built;
+	int builtActionOrd, numActionOrds;
+	int builtPriorOrd, numPriorOrds;
 };
 
 
@@ -269,6 +287,7 @@ struct LongestMatchPart
 	: 
 		join(join), action(action), semiLoc(semiLoc), 
 		longestMatchId(longestMatchId), inLmSelect(false) { }
+	~LongestMatchPart();
 
 	InputLoc getLoc();
 	
@@ -296,6 +315,7 @@ struct LongestMatch
 	LongestMatch( const InputLoc &loc, LmPartList *longestMatchList ) : 
 		loc(loc), longestMatchList(longestMatchList), name(0), 
 		lmSwitchHandlesError(false) { }
+	~LongestMatch();
 
 	/* Tree traversal. */
 	FsmAp *walk( ParseData *pd );
@@ -337,6 +357,7 @@ struct MachineDef
 		: join(0), longestMatch(longestMatch), lengthDef(0), type(LongestMatchType) {}
 	MachineDef( LengthDef *lengthDef )
 		: join(0), longestMatch(0), lengthDef(lengthDef), type(LengthDefType) {}
+	~MachineDef();
 
 	FsmAp *walk( ParseData *pd );
 	void makeNameTree( ParseData *pd );
@@ -385,17 +406,24 @@ struct Expression
 	/* Construct with an expression on the left and a term on the right. */
 	Expression( Expression *expression, Term *term, Type type ) : 
 		expression(expression), term(term), 
-		builtin(builtin), type(type), prev(this), next(this) { }
+		builtin(builtin), category(0), type(type),
+		literalUnion(false), literalUnionChecked(false),
+		prev(this), next(this) { }
 
 	/* Construct with only a term. */
 	Expression( Term *term ) : 
 		expression(0), term(term), builtin(builtin), 
-		type(TermType) , prev(this), next(this) { }
+		category(0), type(TermType),
+		literalUnion(false), literalUnionChecked(false),
+		prev(this), next(this) { }
 	
-	/* Construct with a builtin type. */
-	Expression( BuiltinMachine builtin ) : 
+	/* Construct with a builtin type. The category selects the unicode
+	 * general category for the unicode builtins. */
+	Expression( BuiltinMachine builtin, int category = 0 ) : 
 		expression(0), term(0), builtin(builtin), 
-		type(BuiltinType), prev(this), next(this) { }
+		category(category), type(BuiltinType),
+		literalUnion(false), literalUnionChecked(false),
+		prev(this), next(this) { }
 
 	~Expression();
 
@@ -404,12 +432,22 @@ struct Expression
 	void makeNameTree( ParseData *pd );
 	void resolveNameRefs( ParseData *pd );
 
+	/* Unions of plain literals. */
+	void checkLiteralUnion();
+	FsmAp *walkLiteralUnion( ParseData *pd, bool lastInSeq );
+
 	/* Node data. */
 	Expression *expression;
 	Term *term;
 	BuiltinMachine builtin;
+	int category;
 	Type type;
 
+	/* Set when this node and every node below it is a union of plain
+	 * literals. Computed for the whole chain on the first walk. */
+	bool literalUnion;
+	bool literalUnionChecked;
+
 	Expression *prev, *next;
 };
 
@@ -441,6 +479,9 @@ struct Term
 	void makeNameTree( ParseData *pd );
 	void resolveNameRefs( ParseData *pd );
 
+	/* The literal if the term is nothing else. */
+	Literal *plainLiteral();
+
 	Term *term;
 	FactorWithAug *factorWithAug;
 	Type type;
@@ -510,6 +551,10 @@ struct FactorWithRep
 	void makeNameTree( ParseData *pd );
 	void resolveNameRefs( ParseData *pd );
 
+	/* Repetition with a runtime counter. */
+	bool useCounter( FsmAp *fsm, int bound );
+	FsmAp *countedRepeat( ParseData *pd, FsmAp *fsm, int lower, int upper );
+
 	InputLoc loc;
 	FactorWithRep *factorWithRep;
 	FactorWithNeg *factorWithNeg;
@@ -634,6 +679,7 @@ struct Literal
 		: token(token), type(type) { }
 
 	FsmAp *walk( ParseData *pd );
+	Key *makeKeys( ParseData *pd, long &length, bool &caseInsensitive );
 	
 	Token token;
 	LiteralType type;
@@ -732,7 +778,7 @@ struct InlineItem
 		Text, Goto, Call, Next, GotoExpr, CallExpr, NextExpr, Ret, PChar,
 		Char, Hold, Curs, Targs, Entry, Exec, LmSwitch, LmSetActId,
 		LmSetTokEnd, LmOnLast, LmOnNext, LmOnLagBehind, LmInitAct,
-		LmInitTokStart, LmSetTokStart, Break
+		LmInitTokStart, LmSetTokStart, Break, RepInit, RepIncr, RepTest
 	};
 
 	InlineItem( const InputLoc &loc, char *data, Type type ) : 
@@ -752,6 +798,10 @@ struct InlineItem
 
 	InlineItem( const InputLoc &loc, Type type ) : 
 		loc(loc), data(0), nameRef(0), children(0), type(type) { }
+
+	InlineItem( const InputLoc &loc, int counterId, long bound, Type type ) : 
+		loc(loc), data(0), nameRef(0), children(0), counterId(counterId),
+		bound(bound), type(type) { }
 	
 	InputLoc loc;
 	char *data;
@@ -760,6 +810,10 @@ struct InlineItem
 	InlineList *children;
 	LongestMatch *longestMatch;
 	LongestMatchPart *longestMatchPart;
+
+	/* Counter and bound of the counted repetition items. */
+	int counterId;
+	long bound;
 	Type type;
 
 	InlineItem *prev, *next;
@@ -0,0 +1,292 @@
+/*
+ *  Copyright 2026 agent <agent@local>
+ */
+
+/*  This file is part of Ragel.
+ *
+ *  Ragel is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Ragel is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Ragel; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <stdio.h>
+#include <iostream>
+#include <fstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#include <sys/time.h>
+#endif
+
+#include "ragel.h"
+#include "profile.h"
+#include "fsmgraph.h"
+#include "vector.h"
+
+using std::ostream;
+using std::ofstream;
+
+int countTransitions( FsmAp *fsm );
+
+/* Phases in the order they were started, so a phase comes before the phases
+ * nested in it. */
+static Vector<ProfileRecord> profileRecords;
+
+/* Machine definition the current phases are attributed to. */
+static const char *profileMachine = 0;
+static const InputLoc *profileLoc = 0;
+
+static int profileDepth = 0;
+static double profileEpoch = -1;
+
+/* Wall clock in microseconds. */
+static double profileClock()
+{
+#ifdef _WIN32
+	return (double)GetTickCount() * 1000.0;
+#else
+	struct timeval tv;
+	gettimeofday( &tv, 0 );
+	return (double)tv.tv_sec * 1000000.0 + (double)tv.tv_usec;
+#endif
+}
+
+/* Current resident set size in kilobytes. */
+static long profileRss()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS pmc;
+	if ( GetProcessMemoryInfo( GetCurrentProcess(), &pmc, sizeof(pmc) ) )
+		return (long)(pmc.WorkingSetSize / 1024);
+	return 0;
+#else
+	long size, resident = 0;
+	FILE *statm = fopen( "/proc/self/statm", "r" );
+	if ( statm == 0 )
+		return 0;
+	if ( fscanf( statm, "%ld %ld", &size, &resident ) != 2 )
+		resident = 0;
+	fclose( statm );
+	return resident * ( sysconf( _SC_PAGESIZE ) / 1024 );
+#endif
+}
+
+ProfilePhase::ProfilePhase( const char *name, const char *detail )
+:
+	record(-1)
+{
+	if ( profileFileName != 0 )
+		begin( name, detail, 0 );
+}
+
+ProfilePhase::ProfilePhase( const char *name, const InputLoc &loc )
+:
+	record(-1)
+{
+	if ( profileFileName != 0 )
+		begin( name, 0, &loc );
+}
+
+ProfilePhase::~ProfilePhase()
+{
+	finish();
+}
+
+void ProfilePhase::begin( const char *name, const char *detail, const InputLoc *loc )
+{
+	if ( loc == 0 )
+		loc = profileLoc;
+
+	ProfileRecord pr;
+	pr.name = name;
+	pr.detail = detail;
+	pr.machine = profileMachine;
+	pr.fileName = loc != 0 ? loc->fileName : 0;
+	pr.line = loc != 0 ? loc->line : 0;
+	pr.depth = profileDepth++;
+	pr.duration = 0;
+	pr.statesIn = pr.transIn = -1;
+	pr.statesOut = pr.transOut = -1;
+	pr.rssBefore = profileRss();
+	pr.rssAfter = 0;
+
+	/* Take the time last so the measuring is not charged to the phase. */
+	pr.start = profileClock();
+	if ( profileEpoch < 0 )
+		profileEpoch = pr.start;
+	pr.start -= profileEpoch;
+
+	record = profileRecords.length();
+	profileRecords.append( pr );
+}
+
+void ProfilePhase::input( FsmAp *fsm )
+{
+	if ( record < 0 )
+		return;
+
+	/* Counting is not part of the phase. Move the start forward by the time
+	 * it takes. */
+	double before = profileClock();
+	ProfileRecord &pr = profileRecords[record];
+	if ( pr.statesIn < 0 )
+		pr.statesIn = pr.transIn = 0;
+	pr.statesIn += fsm->stateList.length();
+	pr.transIn += countTransitions( fsm );
+	pr.start += profileClock() - before;
+}
+
+void ProfilePhase::finish( FsmAp *fsm )
+{
+	if ( record < 0 )
+		return;
+
+	ProfileRecord &pr = profileRecords[record];
+	pr.duration = profileClock() - profileEpoch - pr.start;
+	pr.rssAfter = profileRss();
+	if ( fsm != 0 ) {
+		pr.statesOut = fsm->stateList.length();
+		pr.transOut = countTransitions( fsm );
+	}
+
+	profileDepth -= 1;
+	record = -1;
+}
+
+ProfileMachine::ProfileMachine( const char *name, const InputLoc *loc )
+:
+	saveName(profileMachine),
+	saveLoc(profileLoc)
+{
+	profileMachine = name;
+	profileLoc = loc;
+}
+
+ProfileMachine::~ProfileMachine()
+{
+	profileMachine = saveName;
+	profileLoc = saveLoc;
+}
+
+static void writeString( ostream &out, const char *s )
+{
+	out << '"';
+	for ( ; *s != 0; s++ ) {
+		switch ( *s ) {
+			case '"': out << "\\\""; break;
+			case '\\': out << "\\\\"; break;
+			case '\n': out << "\\n"; break;
+			case '\t': out << "\\t"; break;
+			default:
+				if ( (unsigned char)*s < 0x20 ) {
+					char buf[8];
+					sprintf( buf, "\\u%04x", (unsigned char)*s );
+					out << buf;
+				}
+				else {
+					out << *s;
+				}
+				break;
+		}
+	}
+	out << '"';
+}
+
+/* The fields other than the name and times. Shared by both formats. */
+static void writeFields( ostream &out, const ProfileRecord &pr )
+{
+	out << "\"depth\": " << pr.depth;
+	if ( pr.detail != 0 ) {
+		out << ", \"detail\": ";
+		writeString( out, pr.detail );
+	}
+	if ( pr.machine != 0 ) {
+		out << ", \"machine\": ";
+		writeString( out, pr.machine );
+	}
+	if ( pr.fileName != 0 ) {
+		out << ", \"file\": ";
+		writeString( out, pr.fileName );
+		out << ", \"line\": " << pr.line;
+	}
+	if ( pr.statesIn >= 0 ) {
+		out << ", \"states_in\": " << pr.statesIn <<
+				", \"trans_in\": " << pr.transIn;
+	}
+	if ( pr.statesOut >= 0 ) {
+		out << ", \"states_out\": " << pr.statesOut <<
+				", \"trans_out\": " << pr.transOut;
+	}
+	out << ", \"rss_before_kb\": " << pr.rssBefore <<
+			", \"rss_after_kb\": " << pr.rssAfter;
+}
+
+static void writeJSON( ostream &out )
+{
+	out << "{\n\"phases\": [\n";
+	for ( int r = 0; r < profileRecords.length(); r++ ) {
+		const ProfileRecord &pr = profileRecords[r];
+		out << "  { \"name\": ";
+		writeString( out, pr.name );
+		out << ", \"start_us\": " << (long)pr.start <<
+				", \"duration_us\": " << (long)pr.duration << ", ";
+		writeFields( out, pr );
+		out << " }" << ( r < profileRecords.length() - 1 ? ",\n" : "\n" );
+	}
+	out << "]\n}\n";
+}
+
+/* Complete events of the Chrome trace event format. They nest by time, which
+ * the viewers draw as a flame graph. */
+static void writeChromeTrace( ostream &out )
+{
+	out << "{\n\"displayTimeUnit\": \"ms\",\n\"traceEvents\": [\n";
+	for ( int r = 0; r < profileRecords.length(); r++ ) {
+		const ProfileRecord &pr = profileRecords[r];
+		out << "  { \"name\": ";
+		writeString( out, pr.name );
+		out << ", \"cat\": \"ragel\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1"
+				", \"ts\": " << (long)pr.start <<
+				", \"dur\": " << (long)pr.duration << ", \"args\": { ";
+		writeFields( out, pr );
+		out << " } }" << ( r < profileRecords.length() - 1 ? ",\n" : "\n" );
+	}
+	out << "]\n}\n";
+}
+
+void writeProfile()
+{
+	if ( profileFileName == 0 )
+		return;
+
+	ofstream out( profileFileName );
+	if ( !out.is_open() )
+		error() << "could not open " << profileFileName << " for writing" << endp;
+
+	if ( profileFormat == ProfileChromeTrace )
+		writeChromeTrace( out );
+	else
+		writeJSON( out );
+}
+
+void resetProfile()
+{
+	profileRecords.empty();
+	profileMachine = 0;
+	profileLoc = 0;
+	profileDepth = 0;
+	profileEpoch = -1;
+}
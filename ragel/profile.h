@@ -0,0 +1,89 @@
+/*
+ *  Copyright 2026 agent <agent@local>
+ */
+
+/*  This file is part of Ragel.
+ *
+ *  Ragel is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Ragel is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Ragel; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _PROFILE_H
+#define _PROFILE_H
+
+struct FsmAp;
+struct InputLoc;
+
+/* One timed phase of the compilation. Names point to static strings or to
+ * parse data that lives until the program exits. The state and transition
+ * counts are -1 when the phase did not measure a machine. */
+struct ProfileRecord
+{
+	const char *name;
+	const char *detail;
+	const char *machine;
+	const char *fileName;
+	int line;
+	int depth;
+
+	/* Microseconds since the first phase started. */
+	double start;
+	double duration;
+
+	long statesIn, transIn;
+	long statesOut, transOut;
+
+	/* Resident set size in kilobytes, zero when it cannot be read. */
+	long rssBefore, rssAfter;
+};
+
+/* Times a phase from construction until finish() or destruction. When
+ * --profile is not given it does nothing. */
+struct ProfilePhase
+{
+	ProfilePhase( const char *name, const char *detail = 0 );
+	ProfilePhase( const char *name, const InputLoc &loc );
+	~ProfilePhase();
+
+	/* Add the size of an operand to the input counts. */
+	void input( FsmAp *fsm );
+
+	/* Close the phase, recording the size of the result. */
+	void finish( FsmAp *fsm = 0 );
+
+private:
+	void begin( const char *name, const char *detail, const InputLoc *loc );
+
+	long record;
+};
+
+/* Attributes the phases started within its lifetime to a machine
+ * definition. */
+struct ProfileMachine
+{
+	ProfileMachine( const char *name, const InputLoc *loc );
+	~ProfileMachine();
+
+private:
+	const char *saveName;
+	const InputLoc *saveLoc;
+};
+
+/* Write the recorded phases to the --profile file. */
+void writeProfile();
+
+/* Drop the recorded phases so the next compilation starts a new profile. */
+void resetProfile();
+
+#endif
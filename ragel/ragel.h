@@ -39,10 +39,12 @@ enum CodeStyle
 	GenFTables,
 	GenFlat,
 	GenFFlat,
+	GenComb,
 	GenGoto,
 	GenFGoto,
 	GenIpGoto,
-	GenSplit
+	GenSplit,
+	GenHybrid
 };
 
 /* To what degree are machine minimized. */
@@ -70,6 +72,7 @@ enum RubyImplEnum
 /* Options. */
 extern MinimizeLevel minimizeLevel;
 extern MinimizeOpt minimizeOpt;
+extern int minimizeThreads;
 extern const char *machineSpec, *machineName;
 extern bool printStatistics;
 extern bool wantDupsRemoved;
@@ -85,6 +88,15 @@ enum ErrorFormat {
 };
 
 extern ErrorFormat errorFormat;
+
+/* Format of the --profile output. */
+enum ProfileFormat {
+	ProfileJSON,
+	ProfileChromeTrace
+};
+
+extern const char *profileFileName;
+extern ProfileFormat profileFormat;
 extern int gblErrorCount;
 extern char mainMachine[];
 
@@ -94,6 +106,7 @@ std::ostream &operator<<( std::ostream &out, const InputLoc &loc );
 /* Error reporting. */
 std::ostream &error();
 std::ostream &error( const InputLoc &loc ); 
+std::ostream &warning();
 std::ostream &warning( const InputLoc &loc ); 
 
 struct XmlParser;
@@ -109,6 +122,20 @@ extern int gblErrorCount;
 /* Options. */
 extern int numSplitPartitions;
 extern bool noLineDirectives;
+extern int lazyDfaStates;
+extern bool packedTables;
+extern bool maskIndices;
+extern bool spanTables;
+extern bool unsafeAccess;
+extern bool bigarrayTables;
+extern bool instrument;
+extern bool tableBlob;
+extern bool shareTables;
+extern int countedRepetition;
+extern long gotoBudget;
+extern const char *gotoProfileFileName;
+
+void resetOptions();
 
 std::ostream &error();
 
@@ -61,7 +61,10 @@ RedFsmAp::RedFsmAp()
 	bAnyRegNextStmt(false),
 	bAnyRegCurStateRef(false),
 	bAnyRegBreak(false),
-	bAnyConditions(false)
+	bAnyConditions(false),
+	maxCombBase(0),
+	numGotoStates(0),
+	gotoTests(0)
 {
 }
 
@@ -214,6 +217,80 @@ void RedFsmAp::assignActionLocs()
 	}
 }
 
+/* Orders action tables by their action ids, read from the end. A table that
+ * is a tail of another sorts immediately before it or before another table
+ * with the same tail. */
+struct CmpActionTail
+{
+	static int compare( RedAction *a1, RedAction *a2 )
+	{
+		int i1 = a1->key.length() - 1, i2 = a2->key.length() - 1;
+		for ( ; i1 >= 0 && i2 >= 0; i1--, i2-- ) {
+			int id1 = a1->key.data[i1].value->actionId;
+			int id2 = a2->key.data[i2].value->actionId;
+			if ( id1 < id2 )
+				return -1;
+			else if ( id1 > id2 )
+				return 1;
+		}
+		if ( i1 < 0 && i2 < 0 )
+			return 0;
+		else if ( i1 < 0 )
+			return -1;
+		return 1;
+	}
+};
+
+/* Is the action table a1 a tail of a2? */
+static bool isActionTail( RedAction *a1, RedAction *a2 )
+{
+	int len1 = a1->key.length(), len2 = a2->key.length();
+	if ( len1 > len2 )
+		return false;
+	for ( int i = 1; i <= len1; i++ ) {
+		if ( a1->key.data[len1-i].value->actionId != 
+				a2->key.data[len2-i].value->actionId )
+			return false;
+	}
+	return true;
+}
+
+/* Assign locations for an action array with terminated lists in which a table
+ * that is the tail of another is not written out, but points into the other.
+ * The tables written out in full are collected in actionHeads. */
+void RedFsmAp::assignSharedActionLocs()
+{
+	int numTables = actionMap.length();
+	RedAction **tables = new RedAction*[numTables];
+	int t = 0;
+	for ( GenActionTableMap::Iter act = actionMap; act.lte(); act++ )
+		tables[t++] = act;
+
+	MergeSort<RedAction*, CmpActionTail> sort;
+	sort.sort( tables, numTables );
+
+	/* Walk backwards so the table each one can share with is already
+	 * placed. */
+	actionHeads.empty();
+	int nextLocation = 0;
+	for ( t = numTables - 1; t >= 0; t-- ) {
+		RedAction *act = tables[t];
+		RedAction *next = t < numTables - 1 ? tables[t+1] : 0;
+		if ( next != 0 && isActionTail( act, next ) ) {
+			act->location = next->location + 
+					next->key.length() - act->key.length();
+		}
+		else {
+			/* Store the loc, skip over the array and the terminator. */
+			act->location = nextLocation;
+			nextLocation += act->key.length() + 1;
+			actionHeads.append( act );
+		}
+	}
+
+	delete[] tables;
+}
+
 /* Check if we can extend the current range by displacing any ranges
  * ahead to the singles. */
 bool RedFsmAp::canExtend( const RedTransList &list, int pos )
@@ -336,6 +413,129 @@ void RedFsmAp::makeFlat()
 	}
 }
 
+/* Pack the flat transition lists into a comb vector. Entries that go to the
+ * state's default transition are left out and each state's row is placed at
+ * the first offset where its remaining entries land on unused slots. Rows
+ * are placed densest first so the sparse ones can fill in the gaps. Requires
+ * makeFlat. */
+void RedFsmAp::makeComb()
+{
+	/* Order the states by decreasing number of entries. */
+	int numStates = stateList.length();
+	RedSpanMapEl *rows = new RedSpanMapEl[numStates];
+	int numRows = 0;
+	for ( RedStateList::Iter st = stateList; st.lte(); st++ ) {
+		st->combBase = 0;
+		if ( st->transList != 0 ) {
+			unsigned long long span = keyOps->span( st->lowKey, st->highKey );
+			unsigned long long entries = 0;
+			for ( unsigned long long pos = 0; pos < span; pos++ ) {
+				if ( st->transList[pos] != st->defTrans )
+					entries += 1;
+			}
+			rows[numRows++] = RedSpanMapEl( st, entries );
+		}
+	}
+
+	RedSpanMapSort sort;
+	sort.sort( rows, numRows );
+
+	combCheck.empty();
+	combNext.empty();
+	maxCombBase = 0;
+
+	/* The first entry of a row is never a default, so no row can start
+	 * before the first free slot. */
+	long firstFree = 0;
+	for ( int r = 0; r < numRows; r++ ) {
+		RedStateAp *st = rows[r].key;
+		long span = keyOps->span( st->lowKey, st->highKey );
+
+		long base = firstFree;
+		while ( true ) {
+			long pos = 0;
+			for ( ; pos < span; pos++ ) {
+				if ( st->transList[pos] != st->defTrans && 
+						base + pos < combCheck.length() &&
+						combCheck[base + pos] != 0 )
+					break;
+			}
+			if ( pos == span )
+				break;
+			base += 1;
+		}
+
+		/* Grow the vector to take the row and fill it in. */
+		while ( combCheck.length() < base + span ) {
+			combCheck.append( (RedStateAp*)0 );
+			combNext.append( (RedTransAp*)0 );
+		}
+
+		for ( long pos = 0; pos < span; pos++ ) {
+			if ( st->transList[pos] != st->defTrans ) {
+				combCheck[base + pos] = st;
+				combNext[base + pos] = st->transList[pos];
+			}
+		}
+
+		st->combBase = base;
+		if ( base > maxCombBase )
+			maxCombBase = base;
+
+		while ( firstFree < combCheck.length() && combCheck[firstFree] != 0 )
+			firstFree += 1;
+	}
+
+	delete[] rows;
+}
+
+int CmpGotoRank::compare( RedStateAp *st1, RedStateAp *st2 )
+{
+	if ( st1->profileBytes > st2->profileBytes )
+		return -1;
+	else if ( st1->profileBytes < st2->profileBytes )
+		return 1;
+	else if ( st1->gotoCost < st2->gotoCost )
+		return -1;
+	else if ( st1->gotoCost > st2->gotoCost )
+		return 1;
+	return 0;
+}
+
+/* Pick the states the hybrid style writes as goto code. A state costs one
+ * test for each single, two for each range and one for the default. States
+ * are taken in rank order while their tests fit in the budget, the rest
+ * stay in the flat tables. Requires chooseSingle. */
+void RedFsmAp::chooseGotoStates( long budget )
+{
+	int numStates = stateList.length();
+	RedStateAp **ranks = new RedStateAp*[numStates];
+	int numRanks = 0;
+	for ( RedStateList::Iter st = stateList; st.lte(); st++ ) {
+		st->hybridGoto = false;
+		st->gotoCost = st->outSingle.length() + 2 * st->outRange.length() + 1;
+
+		/* The error state is never dispatched on. */
+		if ( st != errState )
+			ranks[numRanks++] = st;
+	}
+
+	GotoRankSort sort;
+	sort.sort( ranks, numRanks );
+
+	numGotoStates = 0;
+	gotoTests = 0;
+	for ( int r = 0; r < numRanks; r++ ) {
+		RedStateAp *st = ranks[r];
+		if ( gotoTests + st->gotoCost <= budget ) {
+			st->hybridGoto = true;
+			numGotoStates += 1;
+			gotoTests += st->gotoCost;
+		}
+	}
+
+	delete[] ranks;
+}
 
 /* A default transition has been picked, move it from the outRange to the
  * default pointer. */
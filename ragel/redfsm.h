@@ -61,13 +61,13 @@ struct GenInlineItem
 		Text, Goto, Call, Next, GotoExpr, CallExpr, NextExpr, Ret, 
 		PChar, Char, Hold, Exec, Curs, Targs, Entry,
 		LmSwitch, LmSetActId, LmSetTokEnd, LmGetTokEnd, LmInitTokStart,
-		LmInitAct, LmSetTokStart, SubAction, Break
+		LmInitAct, LmSetTokStart, SubAction, Break, RepInit, RepIncr, RepTest
 	};
 
 	GenInlineItem( const InputLoc &loc, Type type ) : 
 		loc(loc), data(0), targId(0), targState(0), 
 		lmId(0), children(0), offset(0),
-		type(type) { }
+		counterId(0), bound(0), type(type) { }
 	
 	InputLoc loc;
 	char *data;
@@ -76,6 +76,8 @@ struct GenInlineItem
 	int lmId;
 	GenInlineList *children;
 	int offset;
+	int counterId;
+	long bound;
 	Type type;
 
 	GenInlineItem *prev, *next;
@@ -204,6 +206,7 @@ struct RedAction
 	bool bAnyBreakStmt;
 };
 typedef AvlTree<RedAction, GenActionTable, CmpGenActionTable> GenActionTableMap;
+typedef Vector<RedAction*> RedActionVect;
 
 /* Reduced transition. */
 struct RedTransAp
@@ -256,6 +259,7 @@ struct RedTransEl
 
 typedef Vector<RedTransEl> RedTransList;
 typedef Vector<RedStateAp*> RedStateVect;
+typedef Vector<RedTransAp*> RedTransVect;
 
 typedef BstMapEl<RedStateAp*, unsigned long long> RedSpanMapEl;
 typedef BstMap<RedStateAp*, unsigned long long> RedSpanMap;
@@ -277,6 +281,15 @@ struct CmpRedSpanMapEl
 /* Sorting state-span map entries by span. */
 typedef MergeSort<RedSpanMapEl, CmpRedSpanMapEl> RedSpanMapSort;
 
+/* Order in which the hybrid style offers states the goto budget. The states
+ * that consumed the most input come first, then the cheapest to write. */
+struct CmpGotoRank
+{
+	static int compare( RedStateAp *st1, RedStateAp *st2 );
+};
+
+typedef MergeSort<RedStateAp*, CmpGotoRank> GotoRankSort;
+
 /* Set of entry ids that go into this state. */
 typedef Vector<int> EntryIdVect;
 typedef Vector<char*> EntryNameVect;
@@ -338,7 +351,11 @@ struct RedStateAp
 		bAnyRegCurStateRef(false),
 		partitionBoundary(false),
 		inTrans(0),
-		numInTrans(0)
+		numInTrans(0),
+		combBase(0),
+		hybridGoto(false),
+		gotoCost(0),
+		profileBytes(0)
 	{ }
 
 	/* Transitions out. */
@@ -380,6 +397,16 @@ struct RedStateAp
 
 	RedTransAp **inTrans;
 	int numInTrans;
+
+	/* Offset of the state's row in the comb vector. */
+	long combBase;
+
+	/* For the hybrid style. Whether the state is written as goto code, the
+	 * number of tests that code needs and the bytes the state consumed in
+	 * a profiled run. */
+	bool hybridGoto;
+	long gotoCost;
+	unsigned long long profileBytes;
 };
 
 /* List of states. */
@@ -446,6 +473,21 @@ struct RedFsmAp
 	int maxCondSpaceId;
 	int maxCondIndexOffset;
 	int maxCond;
+	long maxCombBase;
+
+	/* Goto states chosen for the hybrid style and the tests they use. */
+	int numGotoStates;
+	long gotoTests;
+
+	/* Comb vector. The check array holds the state owning each slot and
+	 * the next array holds the transition. Unused slots are null. */
+	RedStateVect combCheck;
+	RedTransVect combNext;
+
+	/* Action tables that are written out in full when tails of the action
+	 * array are shared, in order of location. The others point into the end
+	 * of one of these. */
+	RedActionVect actionHeads;
 
 	bool anyActions();
 	bool anyToStateActions()        { return bAnyToStateActions; }
@@ -473,6 +515,8 @@ struct RedFsmAp
 	void chooseSingle();
 
 	void makeFlat();
+	void makeComb();
+	void chooseGotoStates( long budget );
 
 	/* Move a selected transition from ranges to default. */
 	void moveToDefault( RedTransAp *defTrans, RedStateAp *state );
@@ -512,6 +556,7 @@ struct RedFsmAp
 	void findFirstFinState();
 
 	void assignActionLocs();
+	void assignSharedActionLocs();
 
 	RedTransAp *getErrorTrans();
 	RedStateAp *getErrorState();
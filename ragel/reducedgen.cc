@@ -29,6 +29,8 @@
 #include <string.h>
 #include "rlparse.h"
 #include "version.h"
+#include "profile.h"
+#include "mergesort.h"
 
 /*
  * Code generators.
@@ -47,6 +49,10 @@
 #include "cdftable.h"
 #include "cdflat.h"
 #include "cdfflat.h"
+#include "cdcomb.h"
+#include "cdhybrid.h"
+#include "cdlazy.h"
+#include "cdblob.h"
 #include "cdgoto.h"
 #include "cdfgoto.h"
 #include "cdipgoto.h"
@@ -55,8 +61,13 @@
 #include "dotcodegen.h"
 
 #include "javacodegen.h"
+#include "javaftable.h"
+#include "javaflat.h"
+#include "javafflat.h"
 
 #include "goipgoto.h"
+#include "gotable.h"
+#include "goflat.h"
 
 #include "mltable.h"
 #include "mlftable.h"
@@ -89,8 +100,36 @@ void GenBase::appendTrans( TransListVect &outList, Key lowKey,
 		outList.append( TransEl( lowKey, highKey, trans ) );
 }
 
+/* A transition with conditions is written as one range for each condition
+ * value, placed where the generated code looks after adding the value of the
+ * conditions to the key. */
+void GenBase::appendWideTrans( WideTransList &wideList, TransAp *trans )
+{
+	long baseKey = trans->condSpace->baseKey.getVal();
+	long lowOffset = trans->lowKey.getVal() - keyOps->minKey.getVal();
+	long highOffset = trans->highKey.getVal() - keyOps->minKey.getVal();
+
+	for ( CondTransList::Iter cond = trans->ctList; cond.lte(); cond++ ) {
+		if ( cond->toState == 0 && cond->actionTable.length() == 0 )
+			continue;
+
+		for ( long val = cond->lowKey.getVal(); val <= cond->highKey.getVal(); val++ ) {
+			long valKey = baseKey + val * keyOps->alphSize();
+
+			WideTransEl wideTrans;
+			wideTrans.lowKey = valKey + lowOffset;
+			wideTrans.highKey = valKey + highOffset;
+			wideTrans.cond = cond;
+			wideList.append( wideTrans );
+		}
+	}
+}
+
 void GenBase::reduceActionTables()
 {
+	ProfilePhase phase( "reduce-action-tables" );
+	phase.input( fsm );
+
 	/* Reduce the actions tables to a set. */
 	for ( StateList::Iter st = fsm->stateList; st.lte(); st++ ) {
 		RedActionTable *actionTable = 0;
@@ -115,9 +154,11 @@ void GenBase::reduceActionTables()
 
 		/* Loop the transitions and reduce their actions. */
 		for ( TransList::Iter trans = st->outList; trans.lte(); trans++ ) {
-			if ( trans->ctList.head->actionTable.length() > 0 ) {
-				if ( actionTableMap.insert( trans->ctList.head->actionTable, &actionTable ) )
-					actionTable->id = nextActionTableId++;
+			for ( CondTransList::Iter cond = trans->ctList; cond.lte(); cond++ ) {
+				if ( cond->actionTable.length() > 0 ) {
+					if ( actionTableMap.insert( cond->actionTable, &actionTable ) )
+						actionTable->id = nextActionTableId++;
+				}
 			}
 		}
 	}
@@ -142,6 +183,17 @@ CodeGenData *cdMakeCodeGen( const CodeGenArgs &args )
 	CodeGenData *codeGen = 0;
 	switch ( hostLang->lang ) {
 	case HostLang::C:
+		/* Only the main machine is split into components. */
+		if ( args.pd->lazyComps.length() > 0 ) {
+			codeGen = new CLazyCodeGen(args);
+			break;
+		}
+
+		if ( tableBlob ) {
+			codeGen = new CBlobCodeGen(args);
+			break;
+		}
+
 		switch ( codeStyle ) {
 		case GenTables:
 			codeGen = new CTabCodeGen(args);
@@ -155,6 +207,9 @@ CodeGenData *cdMakeCodeGen( const CodeGenArgs &args )
 		case GenFFlat:
 			codeGen = new CFFlatCodeGen(args);
 			break;
+		case GenComb:
+			codeGen = new CCombCodeGen(args);
+			break;
 		case GenGoto:
 			codeGen = new CGotoCodeGen(args);
 			break;
@@ -167,6 +222,9 @@ CodeGenData *cdMakeCodeGen( const CodeGenArgs &args )
 		case GenSplit:
 			codeGen = new CSplitCodeGen(args);
 			break;
+		case GenHybrid:
+			codeGen = new CHybridCodeGen(args);
+			break;
 		}
 		break;
 
@@ -184,6 +242,9 @@ CodeGenData *cdMakeCodeGen( const CodeGenArgs &args )
 		case GenFFlat:
 			codeGen = new DFFlatCodeGen(args);
 			break;
+		case GenComb:
+			codeGen = new DCombCodeGen(args);
+			break;
 		case GenGoto:
 			codeGen = new DGotoCodeGen(args);
 			break;
@@ -196,6 +257,9 @@ CodeGenData *cdMakeCodeGen( const CodeGenArgs &args )
 		case GenSplit:
 			codeGen = new DSplitCodeGen(args);
 			break;
+		case GenHybrid:
+			codeGen = new DHybridCodeGen(args);
+			break;
 		}
 		break;
 
@@ -213,6 +277,9 @@ CodeGenData *cdMakeCodeGen( const CodeGenArgs &args )
 		case GenFFlat:
 			codeGen = new D2FFlatCodeGen(args);
 			break;
+		case GenComb:
+			codeGen = new D2CombCodeGen(args);
+			break;
 		case GenGoto:
 			codeGen = new D2GotoCodeGen(args);
 			break;
@@ -225,6 +292,9 @@ CodeGenData *cdMakeCodeGen( const CodeGenArgs &args )
 		case GenSplit:
 			codeGen = new D2SplitCodeGen(args);
 			break;
+		case GenHybrid:
+			codeGen = new D2HybridCodeGen(args);
+			break;
 		}
 		break;
 
@@ -237,7 +307,22 @@ CodeGenData *cdMakeCodeGen( const CodeGenArgs &args )
 /* Invoked by the parser when a ragel definition is opened. */
 CodeGenData *javaMakeCodeGen( const CodeGenArgs &args )
 {
-	CodeGenData *codeGen = new JavaTabCodeGen(args);
+	CodeGenData *codeGen = 0;
+	switch ( codeStyle ) {
+		case GenFTables:
+			codeGen = new JavaFTabCodeGen(args);
+			break;
+		case GenFlat:
+			codeGen = new JavaFlatCodeGen(args);
+			break;
+		case GenFFlat:
+			codeGen = new JavaFFlatCodeGen(args);
+			break;
+		default:
+			/* The other styles have always fallen back to tables. */
+			codeGen = new JavaTabCodeGen(args);
+			break;
+	}
 
 	return codeGen;
 }
@@ -245,16 +330,22 @@ CodeGenData *javaMakeCodeGen( const CodeGenArgs &args )
 /* Invoked by the parser when a ragel definition is opened. */
 CodeGenData *goMakeCodeGen( const CodeGenArgs &args )
 {
-	CodeGenData *codeGen;
+	CodeGenData *codeGen = 0;
 
 	switch ( codeStyle ) {
+	case GenTables:
+		codeGen = new GoTabCodeGen(args);
+		break;
+	case GenFlat:
+		codeGen = new GoFlatCodeGen(args);
+		break;
 	case GenIpGoto:
 		codeGen = new GoIpGotoCodeGen(args);
 		break;
 	default:
-		cerr << "I only support the -G2 output style for Go.  Please "
-			"rerun ragel including this flag.\n";
-		exit(1);
+		cerr << "I only support the -T0, -F0 and -G2 output styles for Go.  "
+			"Please rerun ragel including one of these flags.\n";
+		exitCompile(1);
 	}
 
 	return codeGen;
@@ -285,12 +376,12 @@ CodeGenData *rubyMakeCodeGen( const CodeGenArgs &args )
 					"and only supported using Rubinius.\n"
 					"You may want to enable the --rbx flag "
 					" to give it a try.\n";
-				exit(1);
+				exitCompile(1);
 			}
 			break;
 		default:
 			cerr << "Invalid code style\n";
-			exit(1);
+			exitCompile(1);
 			break;
 	}
 
@@ -327,6 +418,10 @@ CodeGenData *csharpMakeCodeGen( const CodeGenArgs &args )
 	case GenSplit:
 		codeGen = new CSharpSplitCodeGen(args);
 		break;
+	default:
+		cerr << "Invalid code style\n";
+		exitCompile(1);
+		break;
 	}
 
 	return codeGen;
@@ -355,7 +450,7 @@ CodeGenData *ocamlMakeCodeGen( const CodeGenArgs &args )
 		break;
 	default:
 		cerr << "I only support the -T0 -T1 -F0 -F1 and -G0 output styles for OCaml.\n";
-		exit(1);
+		exitCompile(1);
 	}
 
 	return codeGen;
@@ -549,6 +644,15 @@ void ReducedGen::makeSetAct( GenInlineList *outList, long lmId )
 	outList->append( inlineItem );
 }
 
+void ReducedGen::makeRepItem( GenInlineList *outList, InlineItem *item, 
+		GenInlineItem::Type type )
+{
+	GenInlineItem *inlineItem = new GenInlineItem( InputLoc(), type );
+	inlineItem->counterId = item->counterId;
+	inlineItem->bound = item->bound;
+	outList->append( inlineItem );
+}
+
 void ReducedGen::makeGenInlineList( GenInlineList *outList, InlineList *inList )
 {
 	for ( InlineList::Iter item = *inList; item.lte(); item++ ) {
@@ -633,6 +737,16 @@ void ReducedGen::makeGenInlineList( GenInlineList *outList, InlineList *inList )
 			outList->append( new GenInlineItem( InputLoc(), GenInlineItem::LmSetTokStart ) );
 			cgd->hasLongestMatch = true;
 			break;
+
+		case InlineItem::RepInit:
+			makeRepItem( outList, item, GenInlineItem::RepInit );
+			break;
+		case InlineItem::RepIncr:
+			makeRepItem( outList, item, GenInlineItem::RepIncr );
+			break;
+		case InlineItem::RepTest:
+			makeRepItem( outList, item, GenInlineItem::RepTest );
+			break;
 		}
 	}
 }
@@ -696,8 +810,12 @@ void ReducedGen::makeActionTableList()
 					atel->value->actionId;
 		}
 
-		/* Insert into the action table map. */
-		cgd->redFsm->actionMap.insert( redAct );
+		/* Insert into the action table map. Tables that differ only in the
+		 * ordering of the actions reduce to the same list. References to a
+		 * later one must use the first, the one code is written for. */
+		RedAction *existing = 0;
+		if ( cgd->redFsm->actionMap.insert( redAct, &existing ) == 0 )
+			tables[t]->id = existing->actListId;
 
 		curActionTable += 1;
 	}
@@ -813,28 +931,37 @@ void ReducedGen::makeEofTrans( StateAp *state )
 
 void ReducedGen::makeStateConditions( StateAp *state )
 {
-	if ( state->stateCondList.length() > 0 ) {
-		long length = state->stateCondList.length();
+	/* The conditions are tested on the ranges of the transitions that have a
+	 * condition space. */
+	long length = 0;
+	for ( TransList::Iter trans = state->outList; trans.lte(); trans++ ) {
+		if ( trans->condSpace != 0 )
+			length += 1;
+	}
+
+	if ( length > 0 ) {
 		cgd->initStateCondList( curState, length );
 		curStateCond = 0;
 
-		for ( StateCondList::Iter scdi = state->stateCondList; scdi.lte(); scdi++ ) {
-			cgd->addStateCond( curState, scdi->lowKey, scdi->highKey, 
-					scdi->condSpace->condSpaceId );
+		for ( TransList::Iter trans = state->outList; trans.lte(); trans++ ) {
+			if ( trans->condSpace != 0 ) {
+				cgd->addStateCond( curState, trans->lowKey, trans->highKey, 
+						trans->condSpace->condSpaceId );
+			}
 		}
 	}
 }
 
-void ReducedGen::makeTrans( Key lowKey, Key highKey, TransAp *trans )
+void ReducedGen::makeTrans( Key lowKey, Key highKey, CondAp *cond )
 {
 	/* First reduce the action. */
 	RedActionTable *actionTable = 0;
-	if ( trans->ctList.head->actionTable.length() > 0 )
-		actionTable = actionTableMap.find( trans->ctList.head->actionTable );
+	if ( cond->actionTable.length() > 0 )
+		actionTable = actionTableMap.find( cond->actionTable );
 
 	long targ = -1;
-	if ( trans->ctList.head->toState != 0 )
-		targ = trans->ctList.head->toState->alg.stateNum;
+	if ( cond->toState != 0 )
+		targ = cond->toState->alg.stateNum;
 
 	long action = -1;
 	if ( actionTable != 0 )
@@ -846,21 +973,35 @@ void ReducedGen::makeTrans( Key lowKey, Key highKey, TransAp *trans )
 void ReducedGen::makeTransList( StateAp *state )
 {
 	TransListVect outList;
+	WideTransList wideList;
 
 	/* If there is only are no ranges the task is simple. */
 	if ( state->outList.length() > 0 ) {
 		/* Loop each source range. */
 		for ( TransList::Iter trans = state->outList; trans.lte(); trans++ ) {
 			/* Reduce the transition. If it reduced to anything then add it. */
-			appendTrans( outList, trans->lowKey, trans->highKey, trans );
+			if ( trans->condSpace == 0 )
+				appendTrans( outList, trans->lowKey, trans->highKey, trans );
+			else
+				appendWideTrans( wideList, trans );
 		}
 	}
 
-	cgd->initTransList( curState, outList.length() );
+	/* The wide ranges all lie above the alphabet, but the ranges of one
+	 * transition are spread out by condition value. */
+	if ( wideList.length() > 1 ) {
+		MergeSort<WideTransEl, CmpWideTransEl> mergeSort;
+		mergeSort.sort( wideList.data, wideList.length() );
+	}
+
+	cgd->initTransList( curState, outList.length() + wideList.length() );
 	curTrans = 0;
 
 	for ( TransListVect::Iter tvi = outList; tvi.lte(); tvi++ )
-		makeTrans( tvi->lowKey, tvi->highKey, tvi->value );
+		makeTrans( tvi->lowKey, tvi->highKey, tvi->value->ctList.head );
+
+	for ( WideTransList::Iter wti = wideList; wti.lte(); wti++ )
+		makeTrans( wti->lowKey, wti->highKey, wti->cond );
 
 	cgd->finishTransList( curState );
 }
@@ -925,6 +1066,7 @@ void ReducedGen::finishGen()
 	cgd->redFsm->findFirstFinState();
 
 	/* Call the user's callback. */
+	ProfilePhase phase( "finish-redfsm" );
 	cgd->finishRagelDef();
 }
 
@@ -1011,6 +1153,13 @@ CodeGenData *ReducedGen::make()
 		cgd->dataExpr = new GenInlineList;
 		makeGenInlineList( cgd->dataExpr, pd->dataExpr );
 	}
+
+	if ( pd->countersExpr != 0 ) {
+		cgd->countersExpr = new GenInlineList;
+		makeGenInlineList( cgd->countersExpr, pd->countersExpr );
+	}
+
+	cgd->numRepCounters = pd->numRepCounters;
 	
 	makeExports();
 	makeMachine();
@@ -1244,7 +1244,7 @@ void Scanner::do_scan()
 			/* Machine failed before finding a token. I'm not yet sure if this
 			 * is reachable. */
 			scan_error() << "scanner error" << endl;
-			exit(1);
+			exitCompile(1);
 		}
 
 		/* Decide if we need to preserve anything. */
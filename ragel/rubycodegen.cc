@@ -106,23 +106,148 @@ std::ostream &RubyCodeGen::STATIC_VAR( string type, string name )
 }
 
 
+RubyTable *RubyCodeGen::findTable( const string &name )
+{
+	for ( Vector<RubyTable>::Iter table = tables; table.lte(); table++ ) {
+		if ( table->name == name )
+			return table;
+	}
+	return 0;
+}
+
 std::ostream &RubyCodeGen::OPEN_ARRAY( string type, string name )
 {
 	out << 
 		"class << self\n"
 		"	attr_accessor :" << name << "\n"
 		"	private :" << name << ", :" << name << "=\n"
-		"end\n"
-		"self." << name << " = [\n";
+		"end\n";
+
+	if ( packedTables ) {
+		/* Items are collected so the width can be chosen from them. */
+		arrayName = name;
+		arrayBuf.str( "" );
+		arraySaved = out.rdbuf( arrayBuf.rdbuf() );
+	}
+	else {
+		if ( findTable( name ) == 0 )
+			tables.append( RubyTable( name, 0, false ) );
+		out << "self." << name << " = [\n";
+	}
 	return out;
 }
 
 std::ostream &RubyCodeGen::CLOSE_ARRAY()
 {
-	out << "]\n";
+	if ( !packedTables ) {
+		out << "]\n";
+		return out;
+	}
+
+	out.rdbuf( arraySaved );
+	arraySaved = 0;
+
+	Vector<long long> items;
+	string text = arrayBuf.str();
+	const char *p = text.c_str();
+	while ( true ) {
+		while ( *p != 0 && ( *p == ',' || isspace( *p ) ) )
+			p += 1;
+		if ( *p == 0 )
+			break;
+		char *end;
+		items.append( strtoll( p, &end, 10 ) );
+		p = end;
+	}
+
+	long long min = 0, max = 0;
+	for ( int i = 0; i < items.length(); i++ ) {
+		if ( items[i] < min )
+			min = items[i];
+		if ( items[i] > max )
+			max = items[i];
+	}
+
+	/* The narrowest little-endian width that holds every item. */
+	bool isSigned = min < 0;
+	int width = 4;
+	if ( isSigned ? ( min >= -0x80 && max <= 0x7f ) : max <= 0xff )
+		width = 1;
+	else if ( isSigned ? ( min >= -0x8000 && max <= 0x7fff ) : max <= 0xffff )
+		width = 2;
+
+	RubyTable *table = findTable( arrayName );
+	if ( table == 0 )
+		tables.append( RubyTable( arrayName, width, isSigned ) );
+	else
+		*table = RubyTable( arrayName, width, isSigned );
+
+	/* Printable characters are written as is, everything else as a hex
+	 * escape. */
+	out << "self." << arrayName << " = (\n\t\"";
+	char saveFill = out.fill();
+	int lineLen = 0;
+	for ( int i = 0; i < items.length(); i++ ) {
+		unsigned long long item = (unsigned long long) items[i];
+		for ( int b = 0; b < width; b++ ) {
+			unsigned char c = ( item >> ( b * 8 ) ) & 0xff;
+			if ( lineLen >= 64 ) {
+				out << "\" \\\n\t\"";
+				lineLen = 0;
+			}
+			if ( c >= 0x20 && c < 0x7f && c != '"' && c != '\\' && c != '#' ) {
+				out << c;
+				lineLen += 1;
+			}
+			else {
+				out << "\\x" << std::hex << std::setw(2) <<
+						std::setfill('0') << (unsigned int)c << std::dec;
+				lineLen += 4;
+			}
+		}
+	}
+	out.fill( saveFill );
+	out << "\"\n).b.freeze\n";
 	return out;
 }
 
+string RubyCodeGen::ARR_REF( string name, string index )
+{
+	string local = "_" + name;
+	RubyTable *table = findTable( name );
+	if ( table == 0 || table->width == 0 )
+		return local + "[" + index + "]";
+
+	if ( table->width == 1 ) {
+		if ( table->isSigned )
+			return "((" + local + ".getbyte(" + index + ") ^ 0x80) - 0x80)";
+		return local + ".getbyte(" + index + ")";
+	}
+
+	const char *format = table->width == 2 ?
+			( table->isSigned ? "s<" : "S<" ) :
+			( table->isSigned ? "l<" : "L<" );
+	const char *shift = table->width == 2 ? "1" : "2";
+	return local + ".unpack1(\"" + format + "\", offset: (" + index +
+			") << " + shift + ")";
+}
+
+/* Copy the table references into locals before the main loop so each read is
+ * not a method call. The tables are found by writing the data to a scratch
+ * buffer if it has not been written yet. */
+void RubyCodeGen::CACHE_TABLES()
+{
+	if ( tables.length() == 0 ) {
+		ostringstream scratch;
+		std::streambuf *saved = out.rdbuf( scratch.rdbuf() );
+		writeData();
+		out.rdbuf( saved );
+	}
+
+	for ( Vector<RubyTable>::Iter table = tables; table.lte(); table++ )
+		out << "	_" << table->name << " = " << table->name << "\n";
+}
+
 
 string RubyCodeGen::ARR_OFF( string ptr, string offset )
 {
@@ -581,6 +706,11 @@ void RubyCodeGen::INLINE_LIST( ostream &ret, GenInlineList *inlineList,
 		case GenInlineItem::Break:
 			BREAK( ret, targState );
 			break;
+		case GenInlineItem::RepInit:
+		case GenInlineItem::RepIncr:
+		case GenInlineItem::RepTest:
+			/* Counted repetition is not supported for this language. */
+			break;
 		}
 	}
 }
@@ -23,17 +23,32 @@
 #ifndef _RUBY_CODEGEN_H
 #define _RUBY_CODEGEN_H
 
+#include <sstream>
 #include "common.h"
 #include "gendata.h"
+#include "vector.h"
 
 /* Integer array line length. */
 #define IALL 8
 
+/* A table written out by writeData. With --packed-tables the items are
+ * stored in a binary string of width bytes each. A zero width means the table
+ * is a plain array. */
+struct RubyTable
+{
+	RubyTable() : width(0), isSigned(false) {}
+	RubyTable( const string &name, int width, bool isSigned )
+		: name(name), width(width), isSigned(isSigned) {}
+
+	string name;
+	int width;
+	bool isSigned;
+};
 
 class RubyCodeGen : public CodeGenData
 {
 public:
-   RubyCodeGen( const CodeGenArgs &args ) : CodeGenData(args) { }
+   RubyCodeGen( const CodeGenArgs &args ) : CodeGenData(args), arraySaved(0) { }
    virtual ~RubyCodeGen() {}
 protected:
 	ostream &START_ARRAY_LINE();
@@ -97,6 +112,10 @@ public:
 	ostream &STATIC_VAR( string type, string name );
 	string ARR_OFF( string ptr, string offset );
 
+	/* Read an item of a table through its local copy. */
+	string ARR_REF( string name, string index );
+	void CACHE_TABLES();
+
 	string P();
 	string PE();
 	string vEOF();
@@ -161,6 +180,14 @@ protected:
 	bool useIndicies;
 
 	void genLineDirective( ostream &out );
+
+	/* Tables that have been written, and the side buffer packed tables are
+	 * collected in. */
+	Vector<RubyTable> tables;
+	RubyTable *findTable( const string &name );
+	string arrayName;
+	std::ostringstream arrayBuf;
+	std::streambuf *arraySaved;
 };
 
 /*
@@ -334,6 +334,7 @@ void RubyFFlatCodeGen::writeExec()
 		out << ", _acts, _nacts";
 	
 	out << " = nil\n";
+	CACHE_TABLES();
 
 	out << 
 		"	_goto_level = 0\n"
@@ -370,7 +371,7 @@ void RubyFFlatCodeGen::writeExec()
 	
 	if ( redFsm->anyFromStateActions() ) {
 		out <<
-			"	case " << FSA() << "[" << vCS() << "] \n";
+			"	case " << ARR_REF( FSA(), vCS() ) << " \n";
 			FROM_STATE_ACTION_SWITCH() <<
 			"	end\n";
 	}
@@ -389,13 +390,13 @@ void RubyFFlatCodeGen::writeExec()
 	if ( redFsm->anyRegCurStateRef() )
 		out << "	_ps = " << vCS() << "\n";
 
-	out << "	" << vCS() << " = " << TT() << "[_trans]\n";
+	out << "	" << vCS() << " = " << ARR_REF( TT(), "_trans" ) << "\n";
 
 	if ( redFsm->anyRegActions() ) {
 		/* break _again */
 		out << 
-			"	if " << TA() << "[_trans] != 0\n"
-			"	case " << TA() << "[_trans]" << "\n";
+			"	if " << ARR_REF( TA(), "_trans" ) << " != 0\n"
+			"	case " << ARR_REF( TA(), "_trans" ) << "\n";
 			ACTION_SWITCH() <<
 			"	end\n"
 			"	end\n";
@@ -408,7 +409,7 @@ void RubyFFlatCodeGen::writeExec()
 
 	if ( redFsm->anyToStateActions() ) {
 		out <<
-			"	case " << TSA() << "[" << vCS() << "] \n";
+			"	case " << ARR_REF( TSA(), vCS() ) << " \n";
 			TO_STATE_ACTION_SWITCH() <<
 			"	end\n"
 			"\n";
@@ -448,8 +449,8 @@ void RubyFFlatCodeGen::writeExec()
 	
 		if ( redFsm->anyEofTrans() ) {
 			out <<
-				"	if " << ET() << "[" << vCS() << "] > 0\n"
-				"		_trans = " << ET() << "[" << vCS() << "] - 1;\n"
+				"	if " << ARR_REF( ET(), vCS() ) << " > 0\n"
+				"		_trans = " << ARR_REF( ET(), vCS() ) << " - 1;\n"
 				"		_goto_level = _eof_trans\n"
 				"		next;\n"
 				"	end\n";
@@ -457,7 +458,7 @@ void RubyFFlatCodeGen::writeExec()
 
 		if ( redFsm->anyEofActions() ) {
 			out <<
-				"	  case " << EA() << "[" << vCS() << "]\n";
+				"	  case " << ARR_REF( EA(), vCS() ) << "\n";
 				EOF_ACTION_SWITCH() <<
 				"	  end\n";
 		}
@@ -277,15 +277,16 @@ void RubyFlatCodeGen::LOCATE_TRANS()
 {
 	out <<
 		"	_keys = " << vCS() << " << 1\n"
-		"	_inds = " << IO() << "[" << vCS() << "]\n"
-		"	_slen = " << SP() << "[" << vCS() << "]\n"
+		"	_inds = " << ARR_REF( IO(), vCS() ) << "\n"
+		"	_slen = " << ARR_REF( SP(), vCS() ) << "\n"
 		"	_trans = if (   _slen > 0 && \n"
-		"			" << K() << "[_keys] <= " << GET_WIDE_KEY() << " && \n"
-		"			" << GET_WIDE_KEY() << " <= " << K() << "[_keys + 1] \n"
+		"			" << ARR_REF( K(), "_keys" ) << " <= " << GET_WIDE_KEY() << " && \n"
+		"			" << GET_WIDE_KEY() << " <= " << ARR_REF( K(), "_keys + 1" ) << " \n"
 		"		    ) then\n"
-		"			" << I() << "[ _inds + " << GET_WIDE_KEY() << " - " << K() << "[_keys] ] \n"
+		"			" << ARR_REF( I(), "_inds + " + GET_WIDE_KEY() + " - " +
+					ARR_REF( K(), "_keys" ) ) << " \n"
 		"		 else \n"
-		"			" << I() << "[ _inds + _slen ]\n"
+		"			" << ARR_REF( I(), "_inds + _slen" ) << "\n"
 		"		 end\n"
 		"";
 	
@@ -311,13 +312,14 @@ void RubyFlatCodeGen::COND_TRANSLATE()
 	out << 
 		"	_widec = " << GET_KEY() << "\n"
 		"	_keys = " << vCS() << " << 1\n"
-		"	_conds = " << CO() << "[" << vCS() << "]\n"
-		"	_slen = " << CSP() << "[" << vCS() << "]\n"
+		"	_conds = " << ARR_REF( CO(), vCS() ) << "\n"
+		"	_slen = " << ARR_REF( CSP(), vCS() ) << "\n"
 		"	_cond = if ( _slen > 0 && \n" 
-		"		     " << CK() << "[_keys] <= " << GET_WIDE_KEY() << " &&\n" 
-		"		     " << GET_WIDE_KEY() << " <= " << CK() << "[_keys + 1]\n"
+		"		     " << ARR_REF( CK(), "_keys" ) << " <= " << GET_WIDE_KEY() << " &&\n" 
+		"		     " << GET_WIDE_KEY() << " <= " << ARR_REF( CK(), "_keys + 1" ) << "\n"
 		"		   ) then \n"
-		"			" << C() << "[ _conds + " << GET_WIDE_KEY() << " - " << CK() << "[_keys]" << " ]\n"
+		"			" << ARR_REF( C(), "_conds + " + GET_WIDE_KEY() + " - " +
+					ARR_REF( CK(), "_keys" ) ) << "\n"
 		"		else\n"
 		"		       0\n"
 		"		end\n";
@@ -671,6 +673,7 @@ void RubyFlatCodeGen::writeExec()
 		out << ", _acts, _nacts";
 	
 	out << " = nil\n";
+	CACHE_TABLES();
 
 	out << 
 		"	_goto_level = 0\n"
@@ -708,13 +711,13 @@ void RubyFlatCodeGen::writeExec()
 
 	if ( redFsm->anyFromStateActions() ) {
 		out << 
-			"	_acts = " << FSA() << "[" << vCS() << "]\n"
-			"	_nacts = " << A() << "[_acts]\n"
+			"	_acts = " << ARR_REF( FSA(), vCS() ) << "\n"
+			"	_nacts = " << ARR_REF( A(), "_acts" ) << "\n"
 			"	_acts += 1\n"
 			"	while _nacts > 0\n"
 			"		_nacts -= 1\n"
 			"		_acts += 1\n"
-			"		case " << A() << "[_acts - 1]\n";
+			"		case " << ARR_REF( A(), "_acts - 1" ) << "\n";
 		FROM_STATE_ACTION_SWITCH();
 		out <<
 			"		end # from state action switch\n"
@@ -738,18 +741,18 @@ void RubyFlatCodeGen::writeExec()
 	if ( redFsm->anyRegCurStateRef() )
 		out << "	_ps = " << vCS() << "\n";
 
-	out << "	" << vCS() << " = " << TT() << "[_trans]\n";
+	out << "	" << vCS() << " = " << ARR_REF( TT(), "_trans" ) << "\n";
 
 	if ( redFsm->anyRegActions() ) {
 		out << 
-			"	if " << TA() << "[_trans] != 0\n"
-			"		_acts = " << TA() << "[_trans]\n"
-			"		_nacts = " << A() << "[_acts]\n"
+			"	if " << ARR_REF( TA(), "_trans" ) << " != 0\n"
+			"		_acts = " << ARR_REF( TA(), "_trans" ) << "\n"
+			"		_nacts = " << ARR_REF( A(), "_acts" ) << "\n"
 			"		_acts += 1\n"
 			"		while _nacts > 0\n"
 			"			_nacts -= 1\n"
 			"			_acts += 1\n"
-			"			case " << A() << "[_acts - 1]\n";
+			"			case " << ARR_REF( A(), "_acts - 1" ) << "\n";
 		ACTION_SWITCH();
 		out <<
 			"			end # action switch\n"
@@ -767,13 +770,13 @@ void RubyFlatCodeGen::writeExec()
 
 	if ( redFsm->anyToStateActions() ) {
 		out <<
-			"	_acts = " << TSA() << "["  << vCS() << "]\n"
-			"	_nacts = " << A() << "[_acts]\n"
+			"	_acts = " << ARR_REF( TSA(), vCS() ) << "\n"
+			"	_nacts = " << ARR_REF( A(), "_acts" ) << "\n"
 			"	_acts += 1\n"
 			"	while _nacts > 0\n"
 			"		_nacts -= 1\n"
 			"		_acts += 1\n"
-			"		case " << A() << "[_acts - 1]\n";
+			"		case " << ARR_REF( A(), "_acts - 1" ) << "\n";
 			TO_STATE_ACTION_SWITCH() <<
 			"		end # to state action switch\n"
 			"	end\n"
@@ -816,8 +819,8 @@ void RubyFlatCodeGen::writeExec()
 
 		if ( redFsm->anyEofTrans() ) {
 			out <<
-				"	if " << ET() << "[" << vCS() << "] > 0\n"
-				"		_trans = " << ET() << "[" << vCS() << "] - 1;\n"
+				"	if " << ARR_REF( ET(), vCS() ) << " > 0\n"
+				"		_trans = " << ARR_REF( ET(), vCS() ) << " - 1;\n"
 				"		_goto_level = _eof_trans\n"
 				"		next;\n"
 				"	end\n";
@@ -826,13 +829,13 @@ void RubyFlatCodeGen::writeExec()
 		if ( redFsm->anyEofActions() ) {
 			out <<
 				"	begin\n"
-				"	__acts = " << EA() << "[" << vCS() << "]\n"
-				"	__nacts = " << A() << "[__acts]\n" << 
+				"	__acts = " << ARR_REF( EA(), vCS() ) << "\n"
+				"	__nacts = " << ARR_REF( A(), "__acts" ) << "\n" << 
 				"	__acts += 1\n"
 				"	while ( __nacts > 0 ) \n"
 				"		__nacts -= 1\n"
 				"		__acts += 1\n"
-				"		case ( "<< A() << "[__acts-1] ) \n";
+				"		case ( "<< ARR_REF( A(), "__acts-1" ) << " ) \n";
 				EOF_ACTION_SWITCH() <<
 				"		end\n"
 				"	end\n"
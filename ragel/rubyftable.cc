@@ -373,6 +373,7 @@ void RubyFTabCodeGen::writeExec()
 		out << ", _widec";
 
 	out << " = nil\n";
+	CACHE_TABLES();
 
 	out << 
 		"	_goto_level = 0\n"
@@ -409,7 +410,7 @@ void RubyFTabCodeGen::writeExec()
 	
 	if ( redFsm->anyFromStateActions() ) {
 		out <<
-			"	case " << FSA() << "[" << vCS() << "] \n";
+			"	case " << ARR_REF( FSA(), vCS() ) << " \n";
 			FROM_STATE_ACTION_SWITCH() <<
 			"	end # from state action switch \n"
 			"\n";
@@ -421,7 +422,7 @@ void RubyFTabCodeGen::writeExec()
 	LOCATE_TRANS();
 
 	if ( useIndicies )
-		out << "	_trans = " << I() << "[_trans];\n";
+		out << "	_trans = " << ARR_REF( I(), "_trans" ) << ";\n";
 
 	if ( redFsm->anyEofTrans() ) {
 		out << 
@@ -433,14 +434,14 @@ void RubyFTabCodeGen::writeExec()
 		out << "	_ps = " << vCS() << ";\n";
 
 	out <<
-		"	" << vCS() << " = " << TT() << "[_trans];\n"
+		"	" << vCS() << " = " << ARR_REF( TT(), "_trans" ) << ";\n"
 		"\n";
 
 	if ( redFsm->anyRegActions() ) {
 		out << 
-			"	if " << TA() << "[_trans] != 0\n"
+			"	if " << ARR_REF( TA(), "_trans" ) << " != 0\n"
 			"\n"
-			"		case " << TA() << "[_trans] \n";
+			"		case " << ARR_REF( TA(), "_trans" ) << " \n";
 			ACTION_SWITCH() <<
 			"		end # action switch \n"
 			"	end\n"
@@ -454,7 +455,7 @@ void RubyFTabCodeGen::writeExec()
 
 	if ( redFsm->anyToStateActions() ) {
 		out <<
-			"	case " << TSA() << "[" << vCS() << "] \n";
+			"	case " << ARR_REF( TSA(), vCS() ) << " \n";
 			TO_STATE_ACTION_SWITCH() <<
 			"	end\n"
 			"\n";
@@ -494,8 +495,8 @@ void RubyFTabCodeGen::writeExec()
 
 		if ( redFsm->anyEofTrans() ) {
 			out <<
-				"	if " << ET() << "[" << vCS() << "] > 0\n"
-				"		_trans = " << ET() << "[" << vCS() << "] - 1;\n"
+				"	if " << ARR_REF( ET(), vCS() ) << " > 0\n"
+				"		_trans = " << ARR_REF( ET(), vCS() ) << " - 1;\n"
 				"		_goto_level = _eof_trans\n"
 				"		next;\n"
 				"	end\n";
@@ -504,7 +505,7 @@ void RubyFTabCodeGen::writeExec()
 		if ( redFsm->anyEofActions() ) {
 			out <<
 				"	begin\n"
-				"		case ( " << EA() << "[" << vCS() << "] )\n";
+				"		case ( " << ARR_REF( EA(), vCS() ) << " )\n";
 				EOF_ACTION_SWITCH() <<
 				"		end\n"
 				"	end\n";
@@ -141,21 +141,21 @@ void RubyTabCodeGen::COND_TRANSLATE()
 {
 	out <<
 		"	_widec = " << GET_KEY() << "\n"
-		"	_keys = " << CO() << "[" << vCS() << "]*2\n"
-		"	_klen = " << CL() << "[" << vCS() << "]\n"
+		"	_keys = " << ARR_REF( CO(), vCS() ) << "*2\n"
+		"	_klen = " << ARR_REF( CL(), vCS() ) << "\n"
 		"	if _klen > 0\n"
 		"		_lower = _keys\n"
 		"		_upper = _keys + (_klen<<1) - 2\n"
 		"		loop do\n"
 		"			break if _upper < _lower\n"
 		"			_mid = _lower + (((_upper-_lower) >> 1) & ~1)\n"
-		"			if " << GET_WIDE_KEY() << " < " << CK() << "[_mid]\n"
+		"			if " << GET_WIDE_KEY() << " < " << ARR_REF( CK(), "_mid" ) << "\n"
 		"				_upper = _mid - 2\n"
-		"			elsif " << GET_WIDE_KEY() << " > " << CK() << "[_mid+1]\n"
+		"			elsif " << GET_WIDE_KEY() << " > " << ARR_REF( CK(), "_mid+1" ) << "\n"
 		"				_lower = _mid + 2\n"
 		"			else\n"
-		"				case " << C() << "[" << CO() << "[" << vCS() << "]"
-							" + ((_mid - _keys)>>1)]\n";
+		"				case " << ARR_REF( C(), ARR_REF( CO(), vCS() ) +
+							" + ((_mid - _keys)>>1)" ) << "\n";
 
 	for ( CondSpaceList::Iter csi = condSpaceList; csi.lte(); csi++ ) {
 		GenCondSpace *condSpace = csi;
@@ -182,9 +182,9 @@ void RubyTabCodeGen::COND_TRANSLATE()
 void RubyTabCodeGen::LOCATE_TRANS()
 {
 	out <<
-		"	_keys = " << KO() << "[" << vCS() << "]\n"
-		"	_trans = " << IO() << "[" << vCS() << "]\n"
-		"	_klen = " << SL() << "[" << vCS() << "]\n"
+		"	_keys = " << ARR_REF( KO(), vCS() ) << "\n"
+		"	_trans = " << ARR_REF( IO(), vCS() ) << "\n"
+		"	_klen = " << ARR_REF( SL(), vCS() ) << "\n"
 		"	_break_match = false\n"
 		"	\n"
 		"	begin\n"
@@ -196,9 +196,9 @@ void RubyTabCodeGen::LOCATE_TRANS()
 		"	        break if _upper < _lower\n"
 		"	        _mid = _lower + ( (_upper - _lower) >> 1 )\n"
 		"\n"
-		"	        if " << GET_WIDE_KEY() << " < " << K() << "[_mid]\n"
+		"	        if " << GET_WIDE_KEY() << " < " << ARR_REF( K(), "_mid" ) << "\n"
 		"	           _upper = _mid - 1\n"
-		"	        elsif " << GET_WIDE_KEY() << " > " << K() << "[_mid]\n"
+		"	        elsif " << GET_WIDE_KEY() << " > " << ARR_REF( K(), "_mid" ) << "\n"
 		"	           _lower = _mid + 1\n"
 		"	        else\n"
 		"	           _trans += (_mid - _keys)\n"
@@ -211,16 +211,16 @@ void RubyTabCodeGen::LOCATE_TRANS()
 		"	     _trans += _klen\n"
 		"	  end"
 		"\n"
-		"	  _klen = " << RL() << "[" << vCS() << "]\n"
+		"	  _klen = " << ARR_REF( RL(), vCS() ) << "\n"
 		"	  if _klen > 0\n"
 		"	     _lower = _keys\n"
 		"	     _upper = _keys + (_klen << 1) - 2\n"
 		"	     loop do\n"
 		"	        break if _upper < _lower\n"
 		"	        _mid = _lower + (((_upper-_lower) >> 1) & ~1)\n"
-		"	        if " << GET_WIDE_KEY() << " < " << K() << "[_mid]\n"
+		"	        if " << GET_WIDE_KEY() << " < " << ARR_REF( K(), "_mid" ) << "\n"
 		"	          _upper = _mid - 2\n"
-		"	        elsif " << GET_WIDE_KEY() << " > " << K() << "[_mid+1]\n"
+		"	        elsif " << GET_WIDE_KEY() << " > " << ARR_REF( K(), "_mid+1" ) << "\n"
 		"	          _lower = _mid + 2\n"
 		"	        else\n"
 		"	          _trans += ((_mid - _keys) >> 1)\n"
@@ -249,6 +249,7 @@ void RubyTabCodeGen::writeExec()
 		out << ", _acts, _nacts";
 
 	out << " = nil\n";
+	CACHE_TABLES();
 
 	out << 
 		"	_goto_level = 0\n"
@@ -286,13 +287,13 @@ void RubyTabCodeGen::writeExec()
 	
 	if ( redFsm->anyFromStateActions() ) {
 		out << 
-			"	_acts = " << FSA() << "[" << vCS() << "]\n"
-			"	_nacts = " << A() << "[_acts]\n"
+			"	_acts = " << ARR_REF( FSA(), vCS() ) << "\n"
+			"	_nacts = " << ARR_REF( A(), "_acts" ) << "\n"
 			"	_acts += 1\n"
 			"	while _nacts > 0\n"
 			"		_nacts -= 1\n"
 			"		_acts += 1\n"
-			"		case " << A() << "[_acts - 1]\n";
+			"		case " << ARR_REF( A(), "_acts - 1" ) << "\n";
 		FROM_STATE_ACTION_SWITCH();
 		out <<
 			"		end # from state action switch\n"
@@ -308,7 +309,7 @@ void RubyTabCodeGen::writeExec()
 	LOCATE_TRANS();
 
 	if ( useIndicies )
-		out << "	_trans = " << I() << "[_trans]\n";
+		out << "	_trans = " << ARR_REF( I(), "_trans" ) << "\n";
 
 	if ( redFsm->anyEofTrans() ) {
 		out << 
@@ -319,18 +320,18 @@ void RubyTabCodeGen::writeExec()
 	if ( redFsm->anyRegCurStateRef() )
 		out << "	_ps = " << vCS() << "\n";
 
-	out << "	" << vCS() << " = " << TT() << "[_trans]\n";
+	out << "	" << vCS() << " = " << ARR_REF( TT(), "_trans" ) << "\n";
 
 	if ( redFsm->anyRegActions() ) {
 		out << 
-			"	if " << TA() << "[_trans] != 0\n"
-			"		_acts = " << TA() << "[_trans]\n"
-			"		_nacts = " << A() << "[_acts]\n"
+			"	if " << ARR_REF( TA(), "_trans" ) << " != 0\n"
+			"		_acts = " << ARR_REF( TA(), "_trans" ) << "\n"
+			"		_nacts = " << ARR_REF( A(), "_acts" ) << "\n"
 			"		_acts += 1\n"
 			"		while _nacts > 0\n"
 			"			_nacts -= 1\n"
 			"			_acts += 1\n"
-			"			case " << A() << "[_acts - 1]\n";
+			"			case " << ARR_REF( A(), "_acts - 1" ) << "\n";
 		ACTION_SWITCH();
 		out <<
 			"			end # action switch\n"
@@ -348,13 +349,13 @@ void RubyTabCodeGen::writeExec()
 
 	if ( redFsm->anyToStateActions() ) {
 		out <<
-			"	_acts = " << TSA() << "["  << vCS() << "]\n"
-			"	_nacts = " << A() << "[_acts]\n"
+			"	_acts = " << ARR_REF( TSA(), vCS() ) << "\n"
+			"	_nacts = " << ARR_REF( A(), "_acts" ) << "\n"
 			"	_acts += 1\n"
 			"	while _nacts > 0\n"
 			"		_nacts -= 1\n"
 			"		_acts += 1\n"
-			"		case " << A() << "[_acts - 1]\n";
+			"		case " << ARR_REF( A(), "_acts - 1" ) << "\n";
 		TO_STATE_ACTION_SWITCH();
 		out <<
 			"		end # to state action switch\n"
@@ -398,8 +399,8 @@ void RubyTabCodeGen::writeExec()
 
 		if ( redFsm->anyEofTrans() ) {
 			out <<
-				"	if " << ET() << "[" << vCS() << "] > 0\n"
-				"		_trans = " << ET() << "[" << vCS() << "] - 1;\n"
+				"	if " << ARR_REF( ET(), vCS() ) << " > 0\n"
+				"		_trans = " << ARR_REF( ET(), vCS() ) << " - 1;\n"
 				"		_goto_level = _eof_trans\n"
 				"		next;\n"
 				"	end\n";
@@ -407,13 +408,13 @@ void RubyTabCodeGen::writeExec()
 
 		if ( redFsm->anyEofActions() ) {
 			out << 
-				"	__acts = " << EA() << "[" << vCS() << "]\n"
-				"	__nacts = " << " " << A() << "[__acts]\n"
+				"	__acts = " << ARR_REF( EA(), vCS() ) << "\n"
+				"	__nacts = " << " " << ARR_REF( A(), "__acts" ) << "\n"
 				"	__acts += 1\n"
 				"	while __nacts > 0\n"
 				"		__nacts -= 1\n"
 				"		__acts += 1\n"
-				"		case " << A() << "[__acts - 1]\n";
+				"		case " << ARR_REF( A(), "__acts - 1" ) << "\n";
 			EOF_ACTION_SWITCH() <<
 				"		end # eof action switch\n"
 				"	end\n"
@@ -0,0 +1,44 @@
+/*
+ *  Copyright 2026 agent <agent@local>
+ */
+
+/*  This file is part of Ragel.
+ *
+ *  Ragel is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  Ragel is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with Ragel; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#ifndef _UNICODE_H
+#define _UNICODE_H
+
+/* An inclusive range of unicode code points. */
+struct CodeRange
+{
+	unsigned long low;
+	unsigned long high;
+};
+
+/* A general category from the unicode character database. The ranges are
+ * sorted and do not overlap or touch. */
+struct UnicodeCategory
+{
+	const char *name;
+	const CodeRange *ranges;
+	int numRanges;
+};
+
+extern UnicodeCategory unicodeCategories[];
+extern const int numUnicodeCategories;
+
+#endif
@@ -394,6 +394,17 @@ void XMLCodeGen::writeInlineList( InlineList *inlineList )
 		case InlineItem::LmSetTokStart:
 			out << "<set_tokstart></set_tokstart>";
 			break;
+
+		case InlineItem::RepInit:
+			out << "<rep_init counter=\"" << item->counterId << "\"></rep_init>";
+			break;
+		case InlineItem::RepIncr:
+			out << "<rep_incr counter=\"" << item->counterId << "\"></rep_incr>";
+			break;
+		case InlineItem::RepTest:
+			out << "<rep_test counter=\"" << item->counterId << 
+					"\" bound=\"" << item->bound << "\"></rep_test>";
+			break;
 		}
 	}
 }
@@ -697,6 +708,12 @@ void XMLCodeGen::writeXML()
 		writeInlineList( pd->dataExpr );
 		out << "</data_expr>\n";
 	}
+
+	if ( pd->countersExpr != 0 ) {
+		out << "  <counters_expr>";
+		writeInlineList( pd->countersExpr );
+		out << "</counters_expr>\n";
+	}
 	
 	writeExports();
 	
@@ -0,0 +1,84 @@
+/*
+ * @LANG: c
+ * @RAGEL_FLAGS: --table-blob
+ * @ALLOW_GENFLAGS: -T0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+%%{
+	machine blob1;
+
+	action word { printf( "word\n" ); }
+	action num { printf( "num\n" ); }
+	action done { printf( "done\n" ); }
+
+	item = [a-z]+ %word | [0-9]+ %num;
+	main := item ( ' ' item )* '\n' @done;
+	numbers := [0-9]+ %num '\n' @done;
+
+	write data;
+}%%
+
+void test( char *str, int numbers )
+{
+	int cs;
+	char *p = str, *pe = str + strlen( str );
+	char *eof = pe;
+
+	%% write init;
+	if ( numbers )
+		cs = blob1_en_numbers;
+	%% write exec;
+
+	if ( cs >= blob1_first_final )
+		printf( "ACCEPT\n" );
+	else
+		printf( "FAIL\n" );
+}
+
+int main()
+{
+	FILE *file = fopen( "blob1_blob1.rlb", "rb" );
+	char *blob;
+	long len;
+
+	if ( file == 0 )
+		return 1;
+	fseek( file, 0, SEEK_END );
+	len = ftell( file );
+	fseek( file, 0, SEEK_SET );
+	blob = malloc( len );
+	if ( fread( blob, 1, len, file ) != (size_t)len )
+		return 1;
+	fclose( file );
+
+	/* A blob of another format version is refused. */
+	blob[4] += 1;
+	printf( "load: %d\n", blob1_load_blob( blob, len ) );
+	blob[4] -= 1;
+	printf( "load: %d\n", blob1_load_blob( blob, len ) );
+
+	test( "abc 12\n", 0 );
+	test( "12x\n", 0 );
+	test( "42\n", 1 );
+	test( "ab\n", 1 );
+	free( blob );
+	return 0;
+}
+
+#ifdef _____OUTPUT_____
+load: -1
+load: 0
+word
+num
+done
+ACCEPT
+FAIL
+num
+done
+ACCEPT
+FAIL
+#endif
@@ -0,0 +1,128 @@
+/*
+ * @LANG: c
+ * @RAGEL_FLAGS: --table-blob
+ * @ALLOW_GENFLAGS: -T0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+%%{
+	machine blob2;
+
+	action word { printf( "word\n" ); }
+	action done { printf( "done\n" ); }
+
+	main := ( [a-z]+ %word ' ' )* '\n' @done;
+
+	write data;
+}%%
+
+void test( char *str )
+{
+	int cs;
+	char *p = str, *pe = str + strlen( str );
+	char *eof = pe;
+
+	%% write init;
+	%% write exec;
+
+	if ( cs >= blob2_first_final )
+		printf( "ACCEPT\n" );
+	else
+		printf( "FAIL\n" );
+}
+
+/* Header words of the blob layout. */
+#define NUM_TRANS 12
+#define SECTION_OFF(s) ( 13 + 2 * (s) )
+#define SECTION_LEN(s) ( 14 + 2 * (s) )
+
+#define ACTIONS 3
+#define KEY_OFFSETS 4
+#define RANGE_LENS 7
+#define INDICIES 9
+#define TRANS_TARGS 10
+#define TRANS_ACTIONS 11
+#define EOF_ACTIONS 14
+#define EOF_TRANS 15
+
+/* Sets an item of the blob, tries to load it and puts the item back. */
+int tamper( char *blob, long len, unsigned int word, unsigned int value )
+{
+	unsigned int *w = (unsigned int*) blob + word;
+	unsigned int save = *w;
+	int result;
+
+	*w = value;
+	result = blob2_load_blob( blob, len );
+	*w = save;
+	return result;
+}
+
+int item( char *blob, int section, unsigned int i )
+{
+	return ( ((unsigned int*) blob)[SECTION_OFF(section)] / 4 ) + i;
+}
+
+int main()
+{
+	FILE *file = fopen( "blob2_blob2.rlb", "rb" );
+	unsigned int *h, lastAction;
+	char *blob;
+	long len;
+
+	if ( file == 0 )
+		return 1;
+	fseek( file, 0, SEEK_END );
+	len = ftell( file );
+	fseek( file, 0, SEEK_SET );
+	blob = malloc( len );
+	if ( fread( blob, 1, len, file ) != (size_t)len )
+		return 1;
+	fclose( file );
+	h = (unsigned int*) blob;
+
+	/* A truncated blob and blobs whose tables point outside themselves are
+	 * refused. */
+	printf( "load: %d\n", blob2_load_blob( blob, len - 4 ) );
+	printf( "load: %d\n", tamper( blob, len, NUM_TRANS, h[NUM_TRANS] + 1 ) );
+	printf( "load: %d\n", tamper( blob, len, item( blob, KEY_OFFSETS, 0 ), 0x7fffffff ) );
+	printf( "load: %d\n", tamper( blob, len, item( blob, RANGE_LENS, 0 ), 1000 ) );
+	printf( "load: %d\n", tamper( blob, len, item( blob, INDICIES, 0 ), 1000 ) );
+	printf( "load: %d\n", tamper( blob, len, item( blob, TRANS_TARGS, 0 ), 1000 ) );
+	printf( "load: %d\n", tamper( blob, len, item( blob, TRANS_ACTIONS, 0 ), 1000 ) );
+	printf( "load: %d\n", tamper( blob, len, item( blob, EOF_ACTIONS, 0 ), 1000 ) );
+	printf( "load: %d\n", tamper( blob, len, item( blob, EOF_TRANS, 0 ), 1000 ) );
+
+	/* An action list that is not ended. */
+	lastAction = item( blob, ACTIONS, h[SECTION_LEN(ACTIONS)] / 4 - 1 );
+	printf( "load: %d\n", tamper( blob, len, lastAction, 0 ) );
+
+	printf( "load: %d\n", blob2_load_blob( blob, len ) );
+
+	test( "ab cd \n" );
+	test( "ab1\n" );
+	free( blob );
+	return 0;
+}
+
+#ifdef _____OUTPUT_____
+load: -1
+load: -1
+load: -1
+load: -1
+load: -1
+load: -1
+load: -1
+load: -1
+load: -1
+load: -1
+load: 0
+word
+word
+done
+ACCEPT
+FAIL
+#endif
@@ -0,0 +1,94 @@
+/*
+ *  Copyright 2026 agent <agent@local>
+ */
+
+/*  This file is part of Ragel.
+ *
+ *  Ragel is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  Ragel is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with Ragel; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+/* Compiles through libragel several times in one process. Each compilation
+ * must start from the default options and leave nothing behind for the next
+ * one. */
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "compiler.h"
+
+using std::cerr;
+using std::endl;
+using std::string;
+using std::vector;
+
+static const char *good =
+	"%%{\n"
+	"	machine compiler1;\n"
+	"	main := ( 'ab' | 'cd' )+ '\\n';\n"
+	"	write data;\n"
+	"}%%\n";
+
+static const char *bad =
+	"%%{\n"
+	"	machine compiler1;\n"
+	"	main := undefined;\n"
+	"	write data;\n"
+	"}%%\n";
+
+static int failures = 0;
+
+static void check( bool ok, const char *what )
+{
+	if ( !ok ) {
+		cerr << "compiler1: " << what << endl;
+		failures += 1;
+	}
+}
+
+int main()
+{
+	RagelCompiler compiler;
+	vector<string> options;
+
+	bool ok = compiler.compile( "compiler1.rl", good, options );
+	string first = compiler.output();
+	check( ok && compiler.errorCount() == 0, "first compilation failed" );
+	check( first.find( "compiler1_start" ) != string::npos,
+			"first compilation wrote no data" );
+	check( compiler.diagnostics().empty(), "first compilation has diagnostics" );
+
+	/* An error is reported in the diagnostics and leaves no output. */
+	ok = compiler.compile( "compiler1.rl", bad, options );
+	check( !ok && compiler.errorCount() > 0, "bad compilation succeeded" );
+	check( compiler.output().empty(), "bad compilation has output" );
+	check( compiler.diagnostics().find( "compiler1.rl:3:" ) != string::npos &&
+			compiler.diagnostics().find( "undefined" ) != string::npos,
+			"bad compilation does not report the undefined machine" );
+
+	/* Options apply to their compilation only. */
+	options.push_back( "-G2" );
+	ok = compiler.compile( "compiler1.rl", good, options );
+	check( ok && compiler.output() != first, "-G2 compilation failed" );
+	check( compiler.diagnostics().empty(), "-G2 compilation has diagnostics" );
+
+	options.clear();
+	ok = compiler.compile( "compiler1.rl", good, options );
+	check( ok && compiler.output() == first,
+			"second compilation differs from the first" );
+	check( compiler.diagnostics().empty(), "second compilation has diagnostics" );
+
+	return failures == 0 ? 0 : 1;
+}
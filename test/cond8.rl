@@ -0,0 +1,46 @@
+/* 
+ * @LANG: indep
+ * @ALLOW_GENFLAGS: -T0 -T1 -G0 -G1 -G2
+ */
+bool i;
+bool j;
+%%
+
+%%{
+	machine foo;
+
+	action c1 {i}
+	action c2 {j}
+	action one { prints "  one\n";}
+	action two { prints "  two\n";}
+
+	action seti { if ( fc == 48 ) i = false; else i = true; }
+	action setj { if ( fc == 48 ) j = false; else j = true; }
+
+	# Both alternatives leave the start of the union on 'b' with different
+	# conditions, so the merge expands the conditions of a copied transition.
+	one = 'b' when c1 'c' @one;
+	two = 'b' when c2 'c' @two;
+
+	main := 
+		[01] @seti
+		[01] @setj
+		( one | two ) '\n';
+}%%
+
+/* _____INPUT_____ 
+"00bc\n"
+"10bc\n"
+"01bc\n"
+"11bc\n"
+_____INPUT_____ */
+/* _____OUTPUT_____
+FAIL
+  one
+ACCEPT
+  two
+ACCEPT
+  one
+  two
+ACCEPT
+_____OUTPUT_____ */
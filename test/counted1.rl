@@ -0,0 +1,57 @@
+/*
+ * @LANG: c
+ * @RAGEL_FLAGS: --counted-repetition=4
+ * @ALLOW_GENFLAGS: -T0 -T1 -F0 -F1 -G0 -G1 -G2
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+%%{
+	machine counted1;
+
+	action done { printf( "done\n" ); }
+
+	hex = [0-9a-f]{2,8};
+	id = [A-Z]{6};
+	main := 'x' hex ' ' id '\n' @done;
+
+	write data;
+}%%
+
+void test( char *str )
+{
+	int cs;
+	int counters[counted1_num_counters];
+	char *p = str, *pe = str + strlen( str );
+
+	%% write init;
+	%% write exec;
+
+	if ( cs >= counted1_first_final )
+		printf( "ACCEPT\n" );
+	else
+		printf( "FAIL\n" );
+}
+
+int main()
+{
+	test( "x1f ABCDEF\n" );
+	test( "x0123abcd ABCDEF\n" );
+	test( "x0123abcde ABCDEF\n" );
+	test( "xa ABCDEF\n" );
+	test( "x12 ABCDE\n" );
+	test( "x12 ABCDEFG\n" );
+	return 0;
+}
+
+#ifdef _____OUTPUT_____
+done
+ACCEPT
+done
+ACCEPT
+FAIL
+FAIL
+FAIL
+FAIL
+#endif
@@ -0,0 +1,84 @@
+/*
+ * @LANG: go
+ * @ALLOW_GENFLAGS: -T0 -F0
+ */
+
+package main
+
+import "fmt"
+
+%%{
+	machine go1;
+
+	action begin {
+		neg = false
+		val = 0
+	}
+
+	action see_neg {
+		neg = true
+	}
+
+	action add_digit {
+		val = val * 10 + int(fc - '0')
+	}
+
+	action print {
+		if neg {
+			val = -1 * val
+		}
+		fmt.Println( val )
+	}
+
+	atoi = ( ('-' @see_neg | '+')? (digit @add_digit)+ ) >begin;
+
+	main := atoi '\n' @print;
+}%%
+
+%% write data;
+
+func test( data string ) {
+	var cs, p, pe int
+	var neg bool
+	var val int
+	pe = len( data )
+
+	%% write init;
+	%% write exec;
+
+	if cs >= go1_first_final {
+		fmt.Println( "ACCEPT" )
+	} else {
+		fmt.Println( "FAIL" )
+	}
+}
+
+func main() {
+	test( "1\n" )
+	test( "12\n" )
+	test( "222222\n" )
+	test( "+2123\n" )
+	test( "213 3213\n" )
+	test( "-12321\n" )
+	test( "--123\n" )
+	test( "-99\n" )
+	test( " -3000\n" )
+}
+
+/* _____OUTPUT_____
+1
+ACCEPT
+12
+ACCEPT
+222222
+ACCEPT
+2123
+ACCEPT
+FAIL
+-12321
+ACCEPT
+FAIL
+-99
+ACCEPT
+FAIL
+_____OUTPUT_____ */
@@ -0,0 +1,62 @@
+/*
+ * @LANG: c
+ * @RAGEL_FLAGS: --goto-budget=16
+ * @ALLOW_GENFLAGS: -G3
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+%%{
+	machine hybrid1;
+
+	action kw { printf( "keyword\n" ); }
+	action id { printf( "identifier\n" ); }
+	action num { val = val * 10 + ( fc - '0' ); }
+	action show { printf( "number %d\n", val ); val = 0; }
+
+	keyword = ( 'if' | 'else' | 'while' | 'return' ) %kw;
+	ident = ( [a-z] [a-z0-9_]* - keyword ) %id;
+	number = ( [0-9] @num )+ %show;
+
+	main := ( ( keyword | ident | number ) ' '+ )* '\n';
+
+	write data;
+}%%
+
+void test( char *str )
+{
+	int cs, val = 0;
+	char *p = str, *pe = str + strlen( str );
+
+	%% write init;
+	%% write exec;
+
+	if ( cs >= hybrid1_first_final )
+		printf( "ACCEPT\n" );
+	else
+		printf( "FAIL\n" );
+}
+
+int main()
+{
+	test( "while x1 return 42 \n" );
+	test( "if else 7 iffy \n" );
+	test( "while X\n" );
+	return 0;
+}
+
+#ifdef _____OUTPUT_____
+keyword
+identifier
+keyword
+number 42
+ACCEPT
+keyword
+keyword
+number 7
+identifier
+ACCEPT
+keyword
+FAIL
+#endif
@@ -0,0 +1,69 @@
+/*
+ * @LANG: c
+ * @RAGEL_FLAGS: --instrument
+ * @ALLOW_GENFLAGS: -T0 -T1 -F0 -F1
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+%%{
+	machine instrument1;
+
+	main := ( [a-z]+ ' ' )* '\n';
+
+	write data;
+}%%
+
+void test( char *str )
+{
+	int cs;
+	char *p = str, *pe = str + strlen( str );
+
+	%% write init;
+	%% write exec;
+
+	if ( cs >= instrument1_first_final )
+		printf( "ACCEPT\n" );
+	else
+		printf( "FAIL\n" );
+}
+
+/* Sum the dump, which does not depend on the code style. */
+void summary()
+{
+	char line[256];
+	int id;
+	unsigned long entries, bytes, count;
+	unsigned long totalEntries = 0, totalBytes = 0, totalCount = 0;
+	FILE *dump = tmpfile();
+
+	instrument1_dump_counters( dump );
+	rewind( dump );
+	while ( fgets( line, sizeof(line), dump ) != 0 ) {
+		if ( sscanf( line, "instrument1 state %d entries %lu bytes %lu", 
+				&id, &entries, &bytes ) == 3 )
+		{
+			totalEntries += entries;
+			totalBytes += bytes;
+		}
+		else if ( sscanf( line, "instrument1 trans %d count %lu", &id, &count ) == 2 )
+			totalCount += count;
+	}
+	fclose( dump );
+
+	printf( "entries %lu bytes %lu transitions %lu\n",
+			totalEntries, totalBytes, totalCount );
+}
+
+int main()
+{
+	test( "ab cde \n" );
+	summary();
+	return 0;
+}
+
+#ifdef _____OUTPUT_____
+ACCEPT
+entries 5 bytes 8 transitions 8
+#endif
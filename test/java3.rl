@@ -0,0 +1,58 @@
+/*
+ * @LANG: java
+ * @RAGEL_FLAGS: --packed-tables
+ */
+
+class java3
+{
+	%%{
+		machine java3;
+		alphtype int;
+
+		action word { System.out.println( "word" ); }
+		action num { System.out.println( "num" ); }
+
+		main := (
+			( 'a'..'z' )+ %word |
+			( -2147483648 .. -100 | 0 .. 9 )+ %num |
+			1073741824 2147483647
+		) ( ' ' | 1000 )+;
+	}%%
+
+	%% write data;
+
+	static void test( int data[] )
+	{
+		int cs, p = 0, pe = data.length, eof = pe;
+
+		%% write init;
+		%% write exec;
+
+		if ( cs >= java3_first_final )
+			System.out.println( "ACCEPT" );
+		else
+			System.out.println( "FAIL" );
+	}
+
+	static final int t1[] = { 'a', 'b', 'c', ' ', ' ', 1000 };
+	static final int t2[] = { -2147483648, 5, -100, 1000 };
+	static final int t3[] = { 1073741824, 2147483647, ' ' };
+	static final int t4[] = { -99, ' ' };
+
+	public static void main( String args[] )
+	{
+		test( t1 );
+		test( t2 );
+		test( t3 );
+		test( t4 );
+	}
+}
+
+/* _____OUTPUT_____
+word
+ACCEPT
+num
+ACCEPT
+ACCEPT
+FAIL
+*/
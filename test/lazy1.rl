@@ -0,0 +1,65 @@
+/*
+ * @LANG: c
+ * @RAGEL_FLAGS: --lazy-dfa=4
+ * @ALLOW_GENFLAGS: -T0
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+%%{
+	machine lazy1;
+
+	short = any{1,8};
+	main := ( [a-c]* 'x' | [0-9]+ ) & short - ( 'a' any* );
+
+	write data;
+}%%
+
+struct lazy1_lazy cs;
+
+void test( char *buf )
+{
+	char *p = buf, *pe, *mid;
+
+	%% write init;
+
+	/* Feed the input in two pieces to check the state carries over. */
+	mid = buf + strlen( buf ) / 2;
+	pe = mid;
+	%% write exec;
+	pe = buf + strlen( buf );
+	%% write exec;
+
+	printf( "%s: %s\n", buf, cs.accept ? "accept" : "fail" );
+}
+
+int main()
+{
+	test( "bcx" );
+	test( "abx" );
+	test( "x" );
+	test( "125" );
+	test( "cccccccx" );
+	test( "ccccccccx" );
+	test( "1234567" );
+	test( "123456789" );
+	test( "12a" );
+	test( "" );
+	test( "bcx" );
+	return 0;
+}
+
+#ifdef _____OUTPUT_____
+bcx: accept
+abx: fail
+x: accept
+125: accept
+cccccccx: accept
+ccccccccx: fail
+1234567: accept
+123456789: fail
+12a: fail
+: fail
+bcx: accept
+#endif
@@ -0,0 +1,60 @@
+/*
+ * @LANG: c
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+%%{
+	machine litunion1;
+
+	action kw { printf( "keyword\n" ); }
+	action ci { printf( "case insensitive\n" ); }
+	action mixed { printf( "mixed\n" ); }
+
+	main := ( (
+		( 'select' | 'insert' | 'update' | 'delete' | 'sel' ) %kw |
+		( 'from'i | 'where'i | 'into'i ) %ci |
+		( 'AND' | 'or'i | 'not' ) %mixed
+	) ' ' )* '\n';
+
+	write data;
+}%%
+
+void test( char *str )
+{
+	int cs;
+	char *p = str, *pe = str + strlen( str );
+
+	%% write init;
+	%% write exec;
+
+	if ( cs >= litunion1_first_final )
+		printf( "ACCEPT\n" );
+	else
+		printf( "FAIL\n" );
+}
+
+int main()
+{
+	test( "select FROM where sel \n" );
+	test( "Or AND not INTO \n" );
+	test( "and \n" );
+	test( "SELECT \n" );
+	return 0;
+}
+
+#ifdef _____OUTPUT_____
+keyword
+case insensitive
+case insensitive
+keyword
+ACCEPT
+mixed
+mixed
+mixed
+case insensitive
+ACCEPT
+FAIL
+FAIL
+#endif
@@ -0,0 +1,49 @@
+#!/bin/bash
+#
+# Times the minimization of a large keyword scanner with 1 to N threads and
+# checks that every thread count writes the same code. Usage:
+#
+#   minthreads.sh [max threads] [keywords]
+#
+
+ragel=../ragel/ragel
+max_threads=${1:-4}
+keywords=${2:-20000}
+
+file=minthreads.rl
+
+# A union of keywords and identifiers, with the keywords coming from a
+# simple generator so the machine is the same on every run.
+{
+	echo "%%{"
+	echo "	machine minthreads;"
+	echo "	kw ="
+	k=0
+	while [ $k -lt $keywords ]; do
+		[ $k -gt 0 ] && echo "		|"
+		echo "		'k$(( k * 7919 % 1000 ))w$k'"
+		k=$(( k + 1 ))
+	done
+	echo "	;"
+	echo "	main := ( ( kw | [a-z] [a-z0-9]* | [0-9]+ ) ' '+ )*;"
+	echo "	write data;"
+	echo "}%%"
+} > $file
+
+status=0
+t=1
+while [ $t -le $max_threads ]; do
+	TIMEFORMAT="threads $t: %R seconds"
+	if ! time $ragel -m --min-threads=$t -o minthreads_$t.c $file; then
+		echo "ragel failed with $t threads"
+		exit 1
+	fi
+
+	if [ $t -gt 1 ] && ! cmp -s minthreads_1.c minthreads_$t.c; then
+		echo "output with $t threads differs from one thread"
+		status=1
+	fi
+	t=$(( t + 1 ))
+done
+
+exit $status
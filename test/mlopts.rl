@@ -0,0 +1,23 @@
+(*
+ * @LANG: ocaml
+ * @IGNORE: yes
+ *
+ * Not run by runtests. The generated code is compared against the golden
+ * files mlopts_*.ml by mlopts.sh.
+ *)
+
+%%{
+	machine mlopts;
+	main := ( 'a' | 'b' )* 'c' ( [0-9] | 'x' . [0-9a-f] )+ '\n';
+}%%
+
+%% write data;
+
+let mlopts data =
+  let cs = ref 0 in
+  let p = ref 0 in
+  let pe = ref (String.length data) in
+%% write init;
+%% write exec;
+  !cs >= mlopts_first_final
+;;
@@ -0,0 +1,31 @@
+#!/bin/bash
+#
+# Checks the OCaml code written with --unsafe-access and --bigarray-tables
+# against the golden files. There is no OCaml runner in runtests, so the
+# generated code is compared instead of run.
+#
+
+ragel=../ragel/ragel
+
+status=0
+while read golden flags; do
+	output=${golden%.ml}.out
+	if ! $ragel -O -L $flags -o $output mlopts.rl; then
+		echo "ragel failed with $flags"
+		exit 1
+	fi
+
+	if diff -b -B $golden $output > /dev/null; then
+		echo "mlopts.rl $flags: passed"
+	else
+		echo "mlopts.rl $flags: FAILED"
+		diff -b -B $golden $output
+		status=1
+	fi
+done << END
+mlopts_unsafe.ml -T0 --unsafe-access
+mlopts_bigarray.ml -F0 --bigarray-tables
+mlopts_both.ml -T0 --unsafe-access --bigarray-tables
+END
+
+exit $status
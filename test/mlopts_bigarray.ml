@@ -0,0 +1,127 @@
+(*
+ * @LANG: ocaml
+ * @IGNORE: yes
+ *
+ * Not run by runtests. The generated code is compared against the golden
+ * files mlopts_*.ml by mlopts.sh.
+ *)
+
+
+
+let _mlopts_trans_keys : (int, Bigarray.int8_unsigned_elt, Bigarray.c_layout) Bigarray.Array1.t =
+  Bigarray.Array1.of_array Bigarray.int8_unsigned Bigarray.c_layout [|
+	0; 0; 97; 99; 48; 120; 10; 120; 48; 102; 0; 0; 0
+|]
+
+let _mlopts_key_spans : (int, Bigarray.int8_unsigned_elt, Bigarray.c_layout) Bigarray.Array1.t =
+  Bigarray.Array1.of_array Bigarray.int8_unsigned Bigarray.c_layout [|
+	0; 3; 73; 111; 55; 0
+|]
+
+let _mlopts_index_offsets : (int, Bigarray.int8_unsigned_elt, Bigarray.c_layout) Bigarray.Array1.t =
+  Bigarray.Array1.of_array Bigarray.int8_unsigned Bigarray.c_layout [|
+	0; 0; 4; 78; 190; 246
+|]
+
+let _mlopts_indicies : (int, Bigarray.int8_unsigned_elt, Bigarray.c_layout) Bigarray.Array1.t =
+  Bigarray.Array1.of_array Bigarray.int8_unsigned Bigarray.c_layout [|
+	0; 0; 2; 1; 3; 3; 3; 
+	3; 3; 3; 3; 3; 3; 3; 1; 
+	1; 1; 1; 1; 1; 1; 1; 1; 
+	1; 1; 1; 1; 1; 1; 1; 1; 
+	1; 1; 1; 1; 1; 1; 1; 1; 
+	1; 1; 1; 1; 1; 1; 1; 1; 
+	1; 1; 1; 1; 1; 1; 1; 1; 
+	1; 1; 1; 1; 1; 1; 1; 1; 
+	1; 1; 1; 1; 1; 1; 1; 1; 
+	1; 1; 1; 1; 1; 4; 1; 5; 
+	1; 1; 1; 1; 1; 1; 1; 1; 
+	1; 1; 1; 1; 1; 1; 1; 1; 
+	1; 1; 1; 1; 1; 1; 1; 1; 
+	1; 1; 1; 1; 1; 1; 1; 1; 
+	1; 1; 1; 1; 1; 3; 3; 3; 
+	3; 3; 3; 3; 3; 3; 3; 1; 
+	1; 1; 1; 1; 1; 1; 1; 1; 
+	1; 1; 1; 1; 1; 1; 1; 1; 
+	1; 1; 1; 1; 1; 1; 1; 1; 
+	1; 1; 1; 1; 1; 1; 1; 1; 
+	1; 1; 1; 1; 1; 1; 1; 1; 
+	1; 1; 1; 1; 1; 1; 1; 1; 
+	1; 1; 1; 1; 1; 1; 1; 1; 
+	1; 1; 1; 1; 1; 4; 1; 3; 
+	3; 3; 3; 3; 3; 3; 3; 3; 
+	3; 1; 1; 1; 1; 1; 1; 1; 
+	1; 1; 1; 1; 1; 1; 1; 1; 
+	1; 1; 1; 1; 1; 1; 1; 1; 
+	1; 1; 1; 1; 1; 1; 1; 1; 
+	1; 1; 1; 1; 1; 1; 1; 1; 
+	3; 3; 3; 3; 3; 3; 1; 1; 
+	0
+|]
+
+let _mlopts_trans_targs : (int, Bigarray.int8_unsigned_elt, Bigarray.c_layout) Bigarray.Array1.t =
+  Bigarray.Array1.of_array Bigarray.int8_unsigned Bigarray.c_layout [|
+	1; 0; 2; 3; 4; 5
+|]
+
+let mlopts_start : int = 1
+let mlopts_first_final : int = 5
+let mlopts_error : int = 0
+
+let mlopts_en_main : int = 1
+
+type state = { mutable trans : int; mutable acts : int; mutable nacts : int; }
+exception Goto_match
+exception Goto_again
+exception Goto_eof_trans
+
+let mlopts data =
+  let cs = ref 0 in
+  let p = ref 0 in
+  let pe = ref (String.length data) in
+
+	begin
+	cs.contents <- mlopts_start;
+	end;
+
+	begin
+
+	let state = { trans = 0; acts = 0; nacts = 0; } in
+	let rec do_start () =
+	if p.contents = pe.contents then
+		do_test_eof ()
+	else
+	if cs.contents = 0 then
+		do_out ()
+	else
+	do_resume ()
+and do_resume () =
+	let keys = cs.contents lsl 1 in
+	let inds = _mlopts_index_offsets.{cs.contents} in
+
+	let slen = _mlopts_key_spans.{cs.contents} in
+	state.trans <- _mlopts_indicies.{inds + (
+		if slen > 0 && _mlopts_trans_keys.{keys} <= Char.code data.[p.contents] &&
+		Char.code data.[p.contents] <= _mlopts_trans_keys.{keys+1} then
+		Char.code data.[p.contents] - _mlopts_trans_keys.{keys} else slen)};
+
+	do_eof_trans ()
+and do_eof_trans () =
+	cs.contents <- _mlopts_trans_targs.{state.trans};
+
+	do_again ()
+	and do_again () =
+	match cs.contents with
+	| 0 -> do_out ()
+	| _ ->
+	p.contents <- p.contents + 1;
+	if p.contents <> pe.contents then
+		do_resume ()
+	else do_test_eof ()
+and do_test_eof () =
+	()
+	and do_out () = ()
+	in do_start ()
+	end;
+  !cs >= mlopts_first_final
+;;
@@ -0,0 +1,137 @@
+(*
+ * @LANG: ocaml
+ * @IGNORE: yes
+ *
+ * Not run by runtests. The generated code is compared against the golden
+ * files mlopts_*.ml by mlopts.sh.
+ *)
+
+
+
+let _mlopts_key_offsets : (int, Bigarray.int8_unsigned_elt, Bigarray.c_layout) Bigarray.Array1.t =
+  Bigarray.Array1.of_array Bigarray.int8_unsigned Bigarray.c_layout [|
+	0; 0; 3; 6; 10; 14
+|]
+
+let _mlopts_trans_keys : (int, Bigarray.int8_unsigned_elt, Bigarray.c_layout) Bigarray.Array1.t =
+  Bigarray.Array1.of_array Bigarray.int8_unsigned Bigarray.c_layout [|
+	99; 97; 98; 120; 48; 57; 10; 120; 
+	48; 57; 48; 57; 97; 102; 0
+|]
+
+let _mlopts_single_lengths : (int, Bigarray.int8_unsigned_elt, Bigarray.c_layout) Bigarray.Array1.t =
+  Bigarray.Array1.of_array Bigarray.int8_unsigned Bigarray.c_layout [|
+	0; 1; 1; 2; 0; 0
+|]
+
+let _mlopts_range_lengths : (int, Bigarray.int8_unsigned_elt, Bigarray.c_layout) Bigarray.Array1.t =
+  Bigarray.Array1.of_array Bigarray.int8_unsigned Bigarray.c_layout [|
+	0; 1; 1; 1; 2; 0
+|]
+
+let _mlopts_index_offsets : (int, Bigarray.int8_unsigned_elt, Bigarray.c_layout) Bigarray.Array1.t =
+  Bigarray.Array1.of_array Bigarray.int8_unsigned Bigarray.c_layout [|
+	0; 0; 3; 6; 10; 13
+|]
+
+let _mlopts_trans_targs : (int, Bigarray.int8_unsigned_elt, Bigarray.c_layout) Bigarray.Array1.t =
+  Bigarray.Array1.of_array Bigarray.int8_unsigned Bigarray.c_layout [|
+	2; 1; 0; 4; 3; 0; 5; 4; 
+	3; 0; 3; 3; 0; 0; 0
+|]
+
+let mlopts_start : int = 1
+let mlopts_first_final : int = 5
+let mlopts_error : int = 0
+
+let mlopts_en_main : int = 1
+
+type state = { mutable keys : int; mutable trans : int; mutable acts : int; mutable nacts : int; }
+exception Goto_match
+exception Goto_again
+exception Goto_eof_trans
+
+let mlopts data =
+  let cs = ref 0 in
+  let p = ref 0 in
+  let pe = ref (String.length data) in
+
+	begin
+	cs.contents <- mlopts_start;
+	end;
+
+	begin
+	let state = { keys = 0; trans = 0; acts = 0; nacts = 0; } in
+	let rec do_start () =
+	if p.contents = pe.contents then
+		do_test_eof ()
+	else
+	if cs.contents = 0 then
+		do_out ()
+	else
+	do_resume ()
+and do_resume () =
+	begin try
+	state.keys <- (Bigarray.Array1.unsafe_get _mlopts_key_offsets (cs.contents));
+	state.trans <- (Bigarray.Array1.unsafe_get _mlopts_index_offsets (cs.contents));
+
+	let klen = (Bigarray.Array1.unsafe_get _mlopts_single_lengths (cs.contents)) in
+	if klen > 0 then begin
+		let lower : int ref = ref state.keys in
+		let upper : int ref = ref (state.keys + klen - 1) in
+		while !upper >= !lower do
+			let mid =  (!lower + ((!upper - !lower) / 2)) in
+			if Char.code data.[p.contents] < (Bigarray.Array1.unsafe_get _mlopts_trans_keys (mid)) then
+				upper :=  (mid - 1)
+			else if Char.code data.[p.contents] > (Bigarray.Array1.unsafe_get _mlopts_trans_keys (mid)) then
+				lower :=  (mid + 1)
+			else begin
+				state.trans <- state.trans +  (mid - state.keys);
+				raise Goto_match;
+			end
+		done;
+		state.keys <- state.keys +  klen;
+		state.trans <- state.trans +  klen;
+	end;
+
+	let klen = (Bigarray.Array1.unsafe_get _mlopts_range_lengths (cs.contents)) in
+	if klen > 0 then begin
+		let lower : int ref = ref state.keys in
+		let upper : int ref = ref (state.keys + (klen * 2) - 2) in
+		while !upper >= !lower do
+			let mid =  (!lower + (((!upper - !lower) / 2) land (lnot 1))) in
+			if Char.code data.[p.contents] < (Bigarray.Array1.unsafe_get _mlopts_trans_keys (mid)) then
+				upper :=  (mid - 2)
+			else if Char.code data.[p.contents] > (Bigarray.Array1.unsafe_get _mlopts_trans_keys (mid+1)) then
+				lower :=  (mid + 2)
+			else begin
+				state.trans <- state.trans + ((mid - state.keys) / 2);
+				raise Goto_match;
+		  end
+		done;
+		state.trans <- state.trans +  klen;
+	end;
+
+	with Goto_match -> () end;
+	do_match ()
+and do_match () =
+	do_eof_trans ()
+and do_eof_trans () =
+	cs.contents <- (Bigarray.Array1.unsafe_get _mlopts_trans_targs (state.trans));
+
+	do_again ()
+	and do_again () =
+	match cs.contents with
+	| 0 -> do_out ()
+	| _ ->
+	p.contents <- p.contents + 1;
+	if p.contents <> pe.contents then
+		do_resume ()
+	else do_test_eof ()
+and do_test_eof () =
+	()
+	and do_out () = ()
+	in do_start ()
+	end;
+  !cs >= mlopts_first_final
+;;
@@ -0,0 +1,75 @@
+/*
+ * @LANG: c
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#define BUFSIZE 8
+#define BLOCKSIZE 3
+
+char *input = "hello 123 world 45678 x\n";
+char buf[BUFSIZE];
+
+int cs, act;
+char *ts, *te;
+
+%%{
+	machine refill;
+
+	main := |*
+		[a-z]+ => { printf( "word(%.*s)\n", (int)(te-ts), ts ); };
+		[0-9]+ => { printf( "num(%.*s)\n", (int)(te-ts), ts ); };
+		[ \n];
+	*|;
+
+	write data;
+}%%
+
+int main()
+{
+	char *data = buf;
+	char *p = buf, *pe = buf, *eof = 0;
+	int len = strlen( input ), pos = 0;
+
+	%% write init;
+
+	while ( eof == 0 ) {
+		int space, n;
+
+		/* Keep any partial token, p is left just past it. */
+		%% write refill;
+
+		space = BUFSIZE - (p - data);
+		if ( space == 0 ) {
+			printf( "TOKEN TOO BIG\n" );
+			break;
+		}
+
+		/* Feed the input in small blocks so tokens span refills. */
+		n = len - pos < BLOCKSIZE ? len - pos : BLOCKSIZE;
+		if ( n > space )
+			n = space;
+		memcpy( p, input + pos, n );
+		pos += n;
+		pe = p + n;
+		if ( pos == len )
+			eof = pe;
+
+		%% write exec;
+
+		if ( cs == refill_error ) {
+			printf( "ERROR\n" );
+			break;
+		}
+	}
+	return 0;
+}
+
+#ifdef _____OUTPUT_____
+word(hello)
+num(123)
+word(world)
+num(45678)
+word(x)
+#endif
@@ -0,0 +1,56 @@
+#
+# @LANG: ruby
+# @RAGEL_FLAGS: --packed-tables
+#
+# Tables written as binary strings, with keys that need signed and four byte
+# items.
+#
+
+%%{
+	machine ruby2;
+	alphtype int;
+
+	action word { puts "word" }
+	action num { puts "num" }
+
+	main := (
+		( 'a'..'z' )+ %word |
+		( -2147483648 .. -100 | 0 .. 9 )+ %num |
+		1073741824 2147483647
+	) ( ' ' | 1000 )+;
+}%%
+
+%% write data;
+
+def run_machine( data )
+	p = 0
+	pe = data.length
+	eof = pe
+	cs = 0
+
+	%% write init;
+	%% write exec;
+	if cs >= ruby2_first_final
+		puts "ACCEPT"
+	else
+		puts "FAIL"
+	end
+end
+
+inp = [
+	[ 97, 98, 99, 32, 32, 1000 ],
+	[ -2147483648, 5, -100, 1000 ],
+	[ 1073741824, 2147483647, 32 ],
+	[ -99, 32 ],
+]
+
+inp.each { |data| run_machine(data) }
+
+=begin _____OUTPUT_____
+word
+ACCEPT
+num
+ACCEPT
+ACCEPT
+FAIL
+=end _____OUTPUT_____
@@ -0,0 +1,76 @@
+/*
+ * @LANG: c
+ * @RAGEL_FLAGS: --share-tables
+ * @ALLOW_GENFLAGS: -T0 -T1 -F0 -F1 -G0 -G1 -G2
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+%%{
+	machine sharetables1;
+
+	action neg { neg = 1; }
+	action add { val = val * 10 + ( fc - '0' ); }
+
+	main := ( '-' @neg )? ( [0-9] @add )+ '\n';
+
+	write data;
+}%%
+
+%%{
+	machine sharetables1_copy;
+
+	action neg { neg = 1; }
+	action add { val = val * 10 + ( fc - '0' ); }
+
+	main := ( '-' @neg )? ( [0-9] @add )+ '\n';
+
+	write data;
+}%%
+
+void test( char *str )
+{
+	int cs, neg = 0, val = 0;
+	char *p = str, *pe = str + strlen( str );
+
+	%% machine sharetables1;
+	%% write init;
+	%% write exec;
+
+	if ( cs >= sharetables1_first_final )
+		printf( "ACCEPT %d\n", neg ? -val : val );
+	else
+		printf( "FAIL\n" );
+}
+
+void test_copy( char *str )
+{
+	int cs, neg = 0, val = 0;
+	char *p = str, *pe = str + strlen( str );
+
+	%% machine sharetables1_copy;
+	%% write init;
+	%% write exec;
+
+	if ( cs >= sharetables1_copy_first_final )
+		printf( "ACCEPT %d\n", neg ? -val : val );
+	else
+		printf( "FAIL\n" );
+}
+
+int main()
+{
+	test( "-42\n" );
+	test( "7x\n" );
+	test_copy( "123\n" );
+	test_copy( "-\n" );
+	return 0;
+}
+
+#ifdef _____OUTPUT_____
+ACCEPT -42
+FAIL
+ACCEPT 123
+FAIL
+#endif
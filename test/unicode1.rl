@@ -0,0 +1,81 @@
+/*
+ * @LANG: c
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+struct unicode
+{
+	int cs;
+};
+
+%%{
+	machine unicode;
+	variable cs fsm->cs;
+
+	main := utf8_L+ ( ' ' utf8_Nd+ )? '\n';
+}%%
+
+%% write data;
+
+void unicode_init( struct unicode *fsm )
+{
+	%% write init;
+}
+
+void unicode_execute( struct unicode *fsm, const char *_data, int _len )
+{
+	const char *p = _data;
+	const char *pe = _data+_len;
+
+	%% write exec;
+}
+
+int unicode_finish( struct unicode *fsm )
+{
+	if ( fsm->cs == unicode_error )
+		return -1;
+	if ( fsm->cs >= unicode_first_final )
+		return 1;
+	return 0;
+}
+
+struct unicode fsm;
+
+void test( char *buf )
+{
+	int len = strlen(buf);
+	unicode_init( &fsm );
+	unicode_execute( &fsm, buf, len );
+	if ( unicode_finish( &fsm ) > 0 )
+		printf("ACCEPT\n");
+	else
+		printf("FAIL\n");
+}
+
+int main()
+{
+	test( "abc\n" );
+	test( "h\xc3\xa9llo\n" );
+	test( "\xce\x95\xce\xbb\n" );
+	test( "\xe6\x97\xa5\xe6\x9c\xac \xd9\xa3\n" );
+	test( "\xf0\x9d\x90\x80\n" );
+	test( "a1\n" );
+	test( "\xc3\x97\n" );
+	test( "\xed\xa0\x80\n" );
+	test( "\xc3\n" );
+	return 0;
+}
+
+#ifdef _____OUTPUT_____
+ACCEPT
+ACCEPT
+ACCEPT
+ACCEPT
+ACCEPT
+FAIL
+FAIL
+FAIL
+FAIL
+#endif